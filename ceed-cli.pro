@@ -0,0 +1,43 @@
+#-------------------------------------------------
+#
+# Headless batch tool for asset pipelines. Doesn't link CEGUI and
+# runs with the offscreen Qt platform, so no display is required.
+#
+#-------------------------------------------------
+
+QT       += core gui xml concurrent
+
+TARGET = ceed-cli
+TEMPLATE = app
+
+CONFIG += console c++14
+CONFIG -= app_bundle
+
+VERSION = 1.1.2
+
+DEFINES += QT_DEPRECATED_WARNINGS
+DEFINES += APP_VERSION=\\\"$$VERSION\\\"
+
+SOURCES += \
+    src/cli/main.cpp \
+    src/cli/ProjectValidator.cpp \
+    src/cegui/ImagesetCompatibility.cpp \
+    src/cegui/MetaImagesetCompiler.cpp \
+    src/util/RectPacker.cpp
+
+HEADERS += \
+    src/cli/ProjectValidator.h \
+    src/cegui/ImagesetCompatibility.h \
+    src/cegui/MetaImagesetCompiler.h \
+    src/util/RectPacker.h
+
+QMAKE_TARGET_COMPANY = "CEGUI team, Vladimir 'Niello' Orlov"
+QMAKE_TARGET_COPYRIGHT = "(c) 2019-2021, CEGUI team, Vladimir 'Niello' Orlov"
+QMAKE_TARGET_PRODUCT = "CEED"
+QMAKE_TARGET_DESCRIPTION = "CEGUI unified editor (CEED) batch tool"
+
+DESTDIR = $$OUT_PWD/bin
+
+qnx: target.path = /tmp/ceed/bin
+else: unix:!android: target.path = /opt/ceed/bin
+!isEmpty(target.path): INSTALLS += target
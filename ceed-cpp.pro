@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui xml network
+QT       += core gui xml network concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -53,6 +53,7 @@ SOURCES += \
     src/ui/dialogs/NewProjectDialog.cpp \
     src/ui/dialogs/ProjectSettingsDialog.cpp \
     src/ui/FileSystemBrowser.cpp \
+    src/ui/DirectoryListModel.cpp \
     src/ui/dialogs/UpdateDialog.cpp \
     src/ui/layout/AnchorCornerHandle.cpp \
     src/ui/layout/AnchorEdgeHandle.cpp \
@@ -69,11 +70,19 @@ SOURCES += \
     src/ui/dialogs/PenDialog.cpp \
     src/ui/widgets/KeySequenceButton.cpp \
     src/ui/dialogs/KeySequenceDialog.cpp \
+    src/ui/dialogs/RenameSymbolDialog.cpp \
     src/ui/UndoViewer.cpp \
+    src/ui/SymbolUsagesDockWidget.cpp \
+    src/ui/ResourceDependenciesDockWidget.cpp \
+    src/ui/ProjectAnalysisDockWidget.cpp \
     src/ui/widgets/BitmapEditorWidget.cpp \
     src/cegui/CEGUIManager.cpp \
     src/cegui/CEGUIProject.cpp \
     src/cegui/CEGUIProjectItem.cpp \
+    src/cegui/ProjectSymbolIndex.cpp \
+    src/cegui/SymbolRenamer.cpp \
+    src/cegui/ProjectAnalyzer.cpp \
+    src/cegui/LayoutBatchRenderer.cpp \
     src/cegui/CEGUIManipulator.cpp \
     src/cegui/QtnPropertyUDim.cpp \
     src/cegui/QtnPropertyUVector2.cpp \
@@ -90,6 +99,14 @@ SOURCES += \
     src/util/SettingsCategory.cpp \
     src/util/SettingsSection.cpp \
     src/util/SettingsEntry.cpp \
+    src/util/UndoData.cpp \
+    src/util/RecoveryJournal.cpp \
+    src/util/FileWatcher.cpp \
+    src/util/FileWriter.cpp \
+    src/util/TiledImage.cpp \
+    src/util/SpriteSlicer.cpp \
+    src/util/RectPacker.cpp \
+    src/util/ImageDiff.cpp \
     src/util/DismissableMessage.cpp \
     src/editors/BitmapEditor.cpp \
     src/editors/MultiModeEditor.cpp \
@@ -106,6 +123,11 @@ SOURCES += \
     src/ui/imageset/ImageOffsetMark.cpp \
     src/ui/imageset/ImageEntry.cpp \
     src/ui/imageset/ImagesetEntry.cpp \
+    src/ui/imageset/ImageThumbnailCache.cpp \
+    src/ui/imageset/ImageEntryListModel.cpp \
+    src/ui/imageset/ImageIssueListModel.cpp \
+    src/ui/imageset/ImageUsageCounter.cpp \
+    src/ui/imageset/ImagesetIssuesDockWidget.cpp \
     src/util/Utils.cpp \
     src/ui/ResizableRectItem.cpp \
     src/ui/ResizingHandle.cpp \
@@ -154,6 +176,10 @@ HEADERS += \
     src/cegui/CEGUIManager.h \
     src/cegui/CEGUIProject.h \
     src/cegui/CEGUIProjectItem.h \
+    src/cegui/ProjectSymbolIndex.h \
+    src/cegui/SymbolRenamer.h \
+    src/cegui/ProjectAnalyzer.h \
+    src/cegui/LayoutBatchRenderer.h \
     src/cegui/CEGUIManipulator.h \
     src/cegui/QtnPropertyUDim.h \
     src/cegui/QtnPropertyUVector2.h \
@@ -164,6 +190,7 @@ HEADERS += \
     src/ui/dialogs/NewProjectDialog.h \
     src/ui/dialogs/ProjectSettingsDialog.h \
     src/ui/FileSystemBrowser.h \
+    src/ui/DirectoryListModel.h \
     src/ui/dialogs/UpdateDialog.h \
     src/ui/layout/AnchorCornerHandle.h \
     src/ui/layout/AnchorEdgeHandle.h \
@@ -183,13 +210,25 @@ HEADERS += \
     src/util/SettingsCategory.h \
     src/util/SettingsSection.h \
     src/util/SettingsEntry.h \
+    src/util/UndoData.h \
+    src/util/RecoveryJournal.h \
+    src/util/FileWatcher.h \
+    src/util/FileWriter.h \
+    src/util/TiledImage.h \
+    src/util/SpriteSlicer.h \
+    src/util/RectPacker.h \
+    src/util/ImageDiff.h \
     src/ui/SettingEntryEditors.h \
     src/ui/widgets/ColourButton.h \
     src/ui/widgets/PenButton.h \
     src/ui/dialogs/PenDialog.h \
     src/ui/widgets/KeySequenceButton.h \
     src/ui/dialogs/KeySequenceDialog.h \
+    src/ui/dialogs/RenameSymbolDialog.h \
     src/ui/UndoViewer.h \
+    src/ui/SymbolUsagesDockWidget.h \
+    src/ui/ResourceDependenciesDockWidget.h \
+    src/ui/ProjectAnalysisDockWidget.h \
     src/util/DismissableMessage.h \
     src/ui/widgets/BitmapEditorWidget.h \
     src/editors/BitmapEditor.h \
@@ -207,6 +246,11 @@ HEADERS += \
     src/ui/imageset/ImageOffsetMark.h \
     src/ui/imageset/ImageEntry.h \
     src/ui/imageset/ImagesetEntry.h \
+    src/ui/imageset/ImageThumbnailCache.h \
+    src/ui/imageset/ImageEntryListModel.h \
+    src/ui/imageset/ImageIssueListModel.h \
+    src/ui/imageset/ImageUsageCounter.h \
+    src/ui/imageset/ImagesetIssuesDockWidget.h \
     src/util/Utils.h \
     src/ui/ResizableRectItem.h \
     src/ui/ResizingHandle.h \
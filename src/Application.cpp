@@ -4,15 +4,24 @@
 #include "src/util/SettingsSection.h"
 #include "src/util/SettingsEntry.h"
 #include "src/util/Utils.h"
+#include "src/util/RecoveryJournal.h"
+#include "src/util/FileWatcher.h"
+#include "src/util/ImageDiff.h"
+#include "src/QtStdHash.h"
 #include "src/util/descriptive_exception.h"
 #include "src/editors/imageset/ImagesetEditor.h"
 #include "src/editors/layout/LayoutEditor.h"
 #include "src/editors/looknfeel/LookNFeelEditor.h"
 #include "src/ui/dialogs/UpdateDialog.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/CEGUIProject.h"
+#include "src/cegui/LayoutBatchRenderer.h"
 #include <qsplashscreen.h>
 #include <qsettings.h>
 #include <qdir.h>
 #include <qcommandlineparser.h>
+#include <qtextstream.h>
+#include <qtimer.h>
 #include <qaction.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
 #include <QtNetwork/qnetworkreply.h>
@@ -22,6 +31,7 @@
 #include <qjsondocument.h>
 #include <qjsonobject.h>
 #include <qversionnumber.h>
+#include <unordered_set>
 
 Application::Application(int& argc, char** argv)
     : QApplication(argc, argv)
@@ -42,8 +52,25 @@ Application::Application(int& argc, char** argv)
     // Finally read stored values into our new setting entries
     _settings->load();
 
+    _cmdLine = new QCommandLineParser();
+    _cmdLine->setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
+    _cmdLine->addOptions(
+    {
+        { "updateResult", tr("Update result code, 0 if succeeded."), tr("updateResult") },
+        { "updateMessage", tr("Update results messaged by an updater."), tr("updateMessage") },
+        { "renderLayouts", tr("Render all layouts of the project to PNG files in the given folder and exit."), tr("folder") },
+        { "resolutions", tr("Resolutions for renderLayouts, e.g. 1280x720,800x600. Project default if omitted."), tr("list") },
+        { "goldenDir", tr("Compare images rendered by renderLayouts with golden images in the given folder."), tr("folder") },
+        { "tolerance", tr("Largest channel difference of goldenDir comparison not counted as a change, 0 to 255."), tr("value"), "0" },
+        { "updateGolden", tr("Replace golden images in goldenDir with rendered ones instead of comparing.") },
+    });
+    _cmdLine->process(*this);
+
+    // Batch rendering works without showing any UI, e.g. on a build machine with software OpenGL
+    const bool batchMode = _cmdLine->isSet("renderLayouts");
+
     QSplashScreen* splash = nullptr;
-    if (_settings->getEntryValue("global/app/show_splash").toBool())
+    if (!batchMode && _settings->getEntryValue("global/app/show_splash").toBool())
     {
         splash = new QSplashScreen(QPixmap(":/images/splashscreen.png"));
         splash->setWindowModality(Qt::ApplicationModal);
@@ -56,16 +83,8 @@ Application::Application(int& argc, char** argv)
         processEvents();
     }
 
-    _cmdLine = new QCommandLineParser();
-    _cmdLine->setSingleDashWordOptionMode(QCommandLineParser::ParseAsLongOptions);
-    _cmdLine->addOptions(
-    {
-        { "updateResult", tr("Update result code, 0 if succeeded."), tr("updateResult") },
-        { "updateMessage", tr("Update results messaged by an updater."), tr("updateMessage") },
-    });
-    _cmdLine->process(*this);
-
     _network = new QNetworkAccessManager(this);
+    _fileWatcher = new FileWatcher(this);
 
     _mainWindow = new MainWindow();
 
@@ -78,6 +97,12 @@ Application::Application(int& argc, char** argv)
         delete splash;
     }
 
+    if (batchMode)
+    {
+        QTimer::singleShot(0, this, [this]() { exit(renderLayoutsHeadless()); });
+        return;
+    }
+
     // Bring our application to front before we show any message box
     // TODO: leave only necessary calls
     _mainWindow->show();
@@ -92,6 +117,9 @@ Application::Application(int& argc, char** argv)
     {
         _mainWindow->setStatusMessage("");
 
+        // Must be taken before the project restores its tabs, their editors would overwrite the journals
+        const QStringList crashJournals = RecoveryJournal::takeOrphanedJournals();
+
         // Now we can load requested project, if any
         if (_cmdLine->positionalArguments().size() > 0)
         {
@@ -117,6 +145,9 @@ Application::Application(int& argc, char** argv)
                 default: break; // 0: empty environment
             }
         }
+
+        if (!crashJournals.isEmpty())
+            _mainWindow->recoverUnsavedChanges(crashJournals);
     });
 }
 
@@ -334,6 +365,132 @@ void Application::onUpdateError(const QUrl& url, const QString& errorString)
         QDesktopServices::openUrl(QUrl("https://github.com/cegui/ceed-cpp/releases"));
 }
 
+// Returns the process exit code: 0 on success, 1 if some layouts failed, 2 if nothing could be rendered
+int Application::renderLayoutsHeadless()
+{
+    QTextStream err(stderr);
+
+    const QString projectPath = _cmdLine->positionalArguments().value(0);
+    if (!QFileInfo(projectPath).isFile())
+    {
+        err << "A project file is required to render layouts" << '\n';
+        return 2;
+    }
+
+    // Nobody would close a dialog on a build machine
+    CEGUIManager::Instance().setHeadless(true);
+
+    // Layouts can't be rendered without schemes, so a failed sync is fatal here
+    const bool loaded = CEGUIManager::Instance().loadProject(projectPath);
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    if (!loaded || !project)
+    {
+        err << "Failed to load the project " << projectPath << '\n';
+        CEGUIManager::Instance().unloadProject();
+        return 2;
+    }
+
+    const auto resolutions = LayoutBatchRenderer::parseResolutions(_cmdLine->value("resolutions"), project->getDefaultResolution());
+    if (resolutions.empty())
+    {
+        err << "No valid resolutions in '" << _cmdLine->value("resolutions") << "'" << '\n';
+        return 2;
+    }
+
+    const QString outputDir = QDir(_cmdLine->value("renderLayouts")).absolutePath();
+    if (!QDir().mkpath(outputDir))
+    {
+        err << "Can't create the output folder " << outputDir << '\n';
+        return 2;
+    }
+
+    LayoutBatchRenderer renderer(*project, outputDir);
+    const QStringList errors = renderer.render(LayoutBatchRenderer::findLayouts(*project), resolutions);
+    for (const QString& error : errors)
+        err << error << '\n';
+
+    QTextStream out(stdout);
+    out << renderer.getRenderedCount() << " images saved to " << outputDir << '\n';
+
+    CEGUIManager::Instance().unloadProject();
+
+    int result = errors.empty() ? 0 : 1;
+    if (!_cmdLine->isSet("goldenDir")) return result;
+
+    const QString goldenDir = QDir(_cmdLine->value("goldenDir")).absolutePath();
+    const QStringList& outputFiles = renderer.getOutputFiles();
+
+    if (_cmdLine->isSet("updateGolden"))
+    {
+        int updatedCount = 0;
+        for (const QString& fileName : outputFiles)
+        {
+            const QString goldenPath = QDir(goldenDir).filePath(fileName);
+            QDir().mkpath(QFileInfo(goldenPath).path());
+            QFile::remove(goldenPath);
+            if (QFile::copy(QDir(outputDir).filePath(fileName), goldenPath))
+                ++updatedCount;
+            else
+                err << "Can't update the golden image " << goldenPath << '\n';
+        }
+
+        out << updatedCount << " golden images updated in " << goldenDir << '\n';
+        return updatedCount == outputFiles.size() ? result : 1;
+    }
+
+    bool toleranceValid = false;
+    const int tolerance = _cmdLine->value("tolerance").toInt(&toleranceValid);
+    if (!toleranceValid || tolerance < 0 || tolerance > 255)
+    {
+        err << "The tolerance must be from 0 to 255" << '\n';
+        return 2;
+    }
+
+    // Diffs of a previous run would be mistaken for current ones. They are kept next to the output folder,
+    // not inside it, where they could be mixed with images of layouts from a 'diff' folder.
+    const QString diffDir = outputDir + "_diff";
+    QDir(diffDir).removeRecursively();
+    auto diffs = ImageDiff::compareDirectories(outputDir, goldenDir, outputFiles, diffDir, tolerance);
+
+    // Layouts that failed to render and golden images without a rendered counterpart fail the comparison too
+    auto addMissing = [&diffs](const QString& fileName, ImageDiff::Status status)
+    {
+        ImageDiff::Result diff;
+        diff.status = status;
+        diff.fileName = fileName;
+        diffs.push_back(std::move(diff));
+    };
+
+    for (const QString& fileName : renderer.getFailedFiles())
+        addMissing(fileName, ImageDiff::Status::NotRendered);
+
+    std::unordered_set<QString> expectedFiles(outputFiles.begin(), outputFiles.end());
+    expectedFiles.insert(renderer.getFailedFiles().begin(), renderer.getFailedFiles().end());
+    for (const QString& fileName : ImageDiff::findImages(goldenDir))
+        if (expectedFiles.find(fileName) == expectedFiles.end())
+            addMissing(fileName, ImageDiff::Status::NoRender);
+
+    int changedCount = 0;
+    for (const auto& diff : diffs)
+    {
+        if (diff.status == ImageDiff::Status::Same) continue;
+
+        ++changedCount;
+        err << diff.fileName << ": " << ImageDiff::getStatusName(diff.status);
+        if (diff.totalPixels) err << ", " << diff.changedPixels << " of " << diff.totalPixels << " pixels";
+        if (!diff.error.isEmpty()) err << ", " << diff.error;
+        err << '\n';
+    }
+
+    const QString reportPath = QDir(outputDir).filePath("regression_report.csv");
+    if (!ImageDiff::writeReport(reportPath, diffs))
+        err << "Can't write the report " << reportPath << '\n';
+
+    out << changedCount << " of " << diffs.size() << " images differ from " << goldenDir << ", see " << reportPath << '\n';
+
+    return changedCount ? 1 : result;
+}
+
 void Application::checkUpdateResults()
 {
     const bool updateLaunched = _settings->getQSettings()->value("update/launched").toBool();
@@ -443,6 +600,23 @@ void Application::createSettingsEntries()
                                  "int", true, 1));
     secApp->addEntry(std::move(entry));
 
+    // Big undo data (e.g. deleted widget hierarchies) beyond this limit is spilled to a temporary file
+    entry.reset(new SettingsEntry(*secApp, "undo_memory_limit", 256, "Undo memory limit (MB)",
+                                 "Puts a limit on memory occupied by every tabbed editor's undo history data. Older data beyond this limit is moved to disk.",
+                                 "int", false, 1));
+    secApp->addEntry(std::move(entry));
+
+    // Unsaved changes of open files are journaled to be recovered after a crash
+    entry.reset(new SettingsEntry(*secApp, "recovery_journal", true, "Crash recovery",
+                                  "Journal unsaved changes of open files so that they can be recovered after a crash",
+                                  "checkbox", false, 1));
+    secApp->addEntry(std::move(entry));
+
+    entry.reset(new SettingsEntry(*secApp, "recovery_snapshot_interval", 30, "Crash recovery snapshot interval (s)",
+                                 "How often the document being edited is saved to the recovery journal, when editing pauses. Longer for big documents. Changes made after the last snapshot can't be recovered.",
+                                 "int", true, 1));
+    secApp->addEntry(std::move(entry));
+
     entry.reset(new SettingsEntry(*secApp, "copy_path_os_separators", true, "Copy path with OS-specific separators",
                                   "When copy a file path to clipboard, will convert forward slashes (/) to OS-specific separators",
                                   "checkbox", false, 1));
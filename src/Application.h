@@ -11,6 +11,7 @@ class Settings;
 class SettingsSection;
 class QNetworkAccessManager;
 class QCommandLineParser;
+class FileWatcher;
 
 class Application : public QApplication
 {
@@ -24,6 +25,7 @@ public:
     MainWindow* getMainWindow() { return _mainWindow; }
     Settings* getSettings() const { return _settings; }
     QNetworkAccessManager* getNetworkManager() const { return _network; }
+    FileWatcher* getFileWatcher() const { return _fileWatcher; }
 
     SettingsSection* getOrCreateShortcutSettingsSection(const QString& groupId, const QString& label);
     QAction* registerAction(const QString& groupId, const QString& id, const QString& label,
@@ -41,11 +43,13 @@ private:
     void createSettingsEntries();
     void onUpdateError(const QUrl& url, const QString& errorString);
     void checkUpdateResults();
+    int renderLayoutsHeadless();
 
     QCommandLineParser* _cmdLine = nullptr;
     MainWindow* _mainWindow = nullptr;
     Settings* _settings = nullptr;
     QNetworkAccessManager* _network = nullptr;
+    FileWatcher* _fileWatcher = nullptr;
     std::map<QString, QAction*> _globalActions;
 };
 
@@ -3,6 +3,7 @@
 
 #include "qstring.h"
 #include "qhash.h"
+#include "qrect.h"
 
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
 namespace std
@@ -17,4 +18,18 @@ template<> struct hash<QString>
 }
 #endif
 
+// Qt has no qHash(QRect), all four coordinates are hashed at full width
+namespace std
+{
+template<> struct hash<QRect>
+{
+    std::size_t operator()(const QRect& r) const
+    {
+        const quint64 pos = (static_cast<quint64>(static_cast<quint32>(r.x())) << 32) | static_cast<quint32>(r.y());
+        const quint64 size = (static_cast<quint64>(static_cast<quint32>(r.width())) << 32) | static_cast<quint32>(r.height());
+        return qHash(pos, qHash(size));
+    }
+};
+}
+
 #endif // QTSTDHASH_H
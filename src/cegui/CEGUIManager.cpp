@@ -1,6 +1,7 @@
 #include "src/cegui/CEGUIManager.h"
 #include "src/cegui/CEGUIProject.h"
 #include "src/cegui/CEGUIUtils.h"
+#include "src/cegui/ProjectSymbolIndex.h"
 #include "src/cegui/QtnPropertyUDim.h"
 #include "src/cegui/QtnPropertyUVector2.h"
 #include "src/cegui/QtnPropertyUVector3.h"
@@ -150,28 +151,26 @@ CEGUIProject* CEGUIManager::createProject(const QString& filePath, bool createRe
 // Opens the project file given in 'path'. Assumes no project is opened at the point this is called.
 // Caller must test if a project is opened and close it accordingly (with a dialog
 // being shown if there are changes to it)
-// Errors aren't indicated by exceptions or return values, dialogs are shown in case of errors.
-void CEGUIManager::loadProject(const QString& filePath)
+// Errors are reported with dialogs, or to stderr in headless mode. Returns false if the project
+// is not loaded or is loaded but failed to synchronise with CEGUI, it stays open in the latter case.
+bool CEGUIManager::loadProject(const QString& filePath)
 {
     if (isProjectLoaded())
     {
-        QMessageBox::critical(qobject_cast<Application*>(qApp)->getMainWindow(),
-                              "Error when opening project",
-                              "There is another project opened. Close it before opening another one.");
-        return;
+        reportError("Error when opening project", "There is another project opened. Close it before opening another one.", true);
+        return false;
     }
 
     currentProject.reset(new CEGUIProject());
     if (!currentProject->loadFromFile(filePath))
     {
-        QMessageBox::critical(qobject_cast<Application*>(qApp)->getMainWindow(),
-                              "Error when opening project",
-                              QString("It seems project at path '%s' doesn't exist or you don't have rights to open it.").arg(filePath));
+        reportError("Error when opening project",
+                    QString("It seems project at path '%1' doesn't exist or you don't have rights to open it.").arg(filePath), true);
         currentProject.reset();
-        return;
+        return false;
     }
 
-    syncProjectToCEGUIInstance();
+    return syncProjectToCEGUIInstance();
 }
 
 // Closes currently opened project. Assumes the one is opened at the point this is called.
@@ -184,6 +183,7 @@ void CEGUIManager::unloadProject()
 
     _widgetPreviewCache.clear();
 
+    _symbolIndex.reset();
     currentProject->unload();
     currentProject.reset();
 }
@@ -213,7 +213,7 @@ void CEGUIManager::ensureCEGUIInitialized()
         return;
     }
 
-    if (!glContext->hasExtension("GL_EXT_framebuffer_object"))
+    if (!_headless && !glContext->hasExtension("GL_EXT_framebuffer_object"))
     {
         DismissableMessage::warning(qobject_cast<Application*>(qApp)->getMainWindow(),
                                     "No FBO support!",
@@ -245,7 +245,7 @@ void CEGUIManager::ensureCEGUIInitialized()
     }
     catch (const std::exception& e)
     {
-        QMessageBox::warning(nullptr, "Exception", e.what());
+        reportError("Exception", e.what());
         return;
     }
 
@@ -317,22 +317,49 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
         return true;
     }
 
-    auto mainWnd = qobject_cast<Application*>(qApp)->getMainWindow();
-
     if (!currentProject->checkAllDirectories())
     {
-        QMessageBox::warning(mainWnd,
-                             "At least one of project's resource directories is invalid",
-                             "Project's resource directory paths didn't pass the sanity check, please check projects settings.");
+        reportError("At least one of project's resource directories is invalid",
+                    "Project's resource directory paths didn't pass the sanity check, please check projects settings.");
         return false;
     }
 
-    QProgressDialog progress(mainWnd);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.setWindowTitle("Synchronising embedded CEGUI with the project");
-    progress.setCancelButton(nullptr);
-    progress.resize(400, 100);
-    progress.show();
+    // Paths might have changed, files already indexed are parsed again only if they were modified.
+    // Nothing is edited in headless mode, so nothing needs the index.
+    if (!_headless)
+    {
+        if (!_symbolIndex)
+        {
+            _symbolIndex.reset(new ProjectSymbolIndex(*currentProject));
+
+            // The index rescans resource directories and reports files changed by other programs
+            QObject::connect(_symbolIndex.get(), &ProjectSymbolIndex::filesModified, [this](const QStringList& filePaths)
+            {
+                for (const QString& filePath : filePaths)
+                    onResourceFileChanged(filePath);
+            });
+        }
+        _symbolIndex->rebuild();
+    }
+
+    std::unique_ptr<QProgressDialog> progress;
+    if (!_headless)
+    {
+        progress.reset(new QProgressDialog(qobject_cast<Application*>(qApp)->getMainWindow()));
+        progress->setWindowModality(Qt::WindowModal);
+        progress->setWindowTitle("Synchronising embedded CEGUI with the project");
+        progress->setCancelButton(nullptr);
+        progress->resize(400, 100);
+        progress->show();
+    }
+
+    auto setProgress = [&progress](const QString& text, int value)
+    {
+        if (!progress) return;
+        progress->setValue(value < 0 ? progress->value() + 1 : value);
+        progress->setLabelText(text);
+        QApplication::instance()->processEvents();
+    };
 
     ensureCEGUIInitialized();
 
@@ -341,11 +368,11 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
     if (!QDir(absoluteSchemesPath).exists())
     {
         progress.reset();
-        QMessageBox::warning(mainWnd, "Failed to synchronise embedded CEGUI to your project",
-           "Can't list scheme path '" + absoluteSchemesPath + "'\n\n"
-           "This means that editing capabilities of CEED will be limited to editing of files "
-           "that don't require a project opened (for example: imagesets).");
-       return false;
+        reportError("Failed to synchronise embedded CEGUI to your project",
+                    "Can't list scheme path '" + absoluteSchemesPath + "'\n\n"
+                    "This means that editing capabilities of CEED will be limited to editing of files "
+                    "that don't require a project opened (for example: imagesets).");
+        return false;
     }
 
     QDirIterator schemesIt(absoluteSchemesPath);
@@ -357,19 +384,18 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
             schemeFiles.append(schemesIt.fileName());
     }
 
-    progress.setMinimum(0);
-    progress.setMaximum(2 + 9 * schemeFiles.size());
+    if (progress)
+    {
+        progress->setMinimum(0);
+        progress->setMaximum(2 + 9 * schemeFiles.size());
+    }
 
-    progress.setLabelText("Purging all resources...");
-    progress.setValue(0);
-    QApplication::instance()->processEvents();
+    setProgress("Purging all resources...", 0);
 
     // Destroy all previous resources (if any)
     cleanCEGUIResources();
 
-    progress.setLabelText("Setting resource paths...");
-    progress.setValue(1);
-    QApplication::instance()->processEvents();
+    setProgress("Setting resource paths...", 1);
 
     auto resProvider = dynamic_cast<CEGUI::DefaultResourceProvider*>(CEGUI::System::getSingleton().getResourceProvider());
     if (resProvider)
@@ -383,9 +409,7 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
         resProvider->setResourceGroupDirectory("__ceed_internal__", CEGUIUtils::qStringToString(QDir::current().path()));
     }
 
-    progress.setLabelText("Recreating all schemes...");
-    progress.setValue(2);
-    QApplication::instance()->processEvents();
+    setProgress("Recreating all schemes...", 2);
 
     makeOpenGLContextCurrent();
 
@@ -395,11 +419,9 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
     bool result = true;
     try
     {
-        auto updateProgress = [&progress](const QString& schemeFile, const QString& message)
+        auto updateProgress = [&setProgress](const QString& schemeFile, const QString& message)
         {
-            progress.setValue(progress.value() + 1);
-            progress.setLabelText(QString("Recreating all schemes... (%1)\n\n%2").arg(schemeFile, message));
-            QApplication::instance()->processEvents();
+            setProgress(QString("Recreating all schemes... (%1)\n\n%2").arg(schemeFile, message), -1);
         };
 
         for (auto& schemeFile : schemeFiles)
@@ -567,7 +589,7 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
     catch (const std::exception& e)
     {
         cleanCEGUIResources();
-        QMessageBox::warning(mainWnd, "Failed to synchronise embedded CEGUI to your project",
+        reportError("Failed to synchronise embedded CEGUI to your project",
             QString("An attempt was made to load resources related to the project being opened, "
             "for some reason the loading didn't succeed so all resources were destroyed! "
             "The most likely reason is that the resource directories are wrong, this can "
@@ -580,17 +602,53 @@ bool CEGUIManager::syncProjectToCEGUIInstance()
     // Put SchemeManager into the default state again
     CEGUI::SchemeManager::getSingleton().setAutoLoadResources(true);
 
+    invalidateAvailableNames();
+
     doneOpenGLContextCurrent();
 
-    progress.reset();
-    QApplication::instance()->processEvents();
+    if (progress)
+    {
+        progress.reset();
+        QApplication::instance()->processEvents();
+    }
 
     return result;
 }
 
+// Shows a message box, or writes to stderr in headless mode where nobody could close it
+void CEGUIManager::reportError(const QString& title, const QString& text, bool critical) const
+{
+    if (_headless)
+    {
+        QTextStream(stderr) << title << ": " << text << '\n';
+        return;
+    }
+
+    auto mainWnd = qobject_cast<Application*>(qApp)->getMainWindow();
+    if (critical)
+        QMessageBox::critical(mainWnd, title, text);
+    else
+        QMessageBox::warning(mainWnd, title, text);
+}
+
+// Resources loaded into CEGUI are not reloaded automatically, editors may have unsaved changes depending on them
+void CEGUIManager::onResourceFileChanged(const QString& filePath)
+{
+    static const QStringList suffixes = { "imageset", "font", "scheme", "looknfeel" };
+    if (!currentProject || !suffixes.contains(QFileInfo(filePath).suffix(), Qt::CaseInsensitive)) return;
+
+    const int affectedCount = _symbolIndex ? _symbolIndex->getAffectedFiles(filePath).size() : 0;
+
+    auto mainWnd = qobject_cast<Application*>(qApp)->getMainWindow();
+    mainWnd->setStatusMessage(QString("'%1' was changed on disk (%2 dependent files), reload project resources to apply")
+                              .arg(currentProject->getRelativePathOf(filePath)).arg(affectedCount));
+}
+
 // Destroy all previous resources (if any)
 void CEGUIManager::cleanCEGUIResources()
 {
+    invalidateAvailableNames();
+
     if (!initialized) return;
 
     makeOpenGLContextCurrent();
@@ -617,9 +675,18 @@ void CEGUIManager::cleanCEGUIResources()
 
 // Retrieves names of skins that are available from the set of schemes that were loaded.
 // see syncProjectToCEGUIInstance
+void CEGUIManager::invalidateAvailableNames() const
+{
+    _availableSkins.clear();
+    _availableFonts.clear();
+    _availableImages.clear();
+}
+
 QStringList CEGUIManager::getAvailableSkins() const
 {
-    QStringList skins;
+    if (!_availableSkins.empty()) return _availableSkins;
+
+    QStringList& skins = _availableSkins;
 
     auto it = CEGUI::WindowFactoryManager::getSingleton().getFalagardMappingIterator();
     while (!it.isAtEnd())
@@ -642,7 +709,9 @@ QStringList CEGUIManager::getAvailableSkins() const
 // see syncProjectToCEGUIInstance
 QStringList CEGUIManager::getAvailableFonts() const
 {
-    QStringList fonts;
+    if (!_availableFonts.empty()) return _availableFonts;
+
+    QStringList& fonts = _availableFonts;
 
     auto& fontRegistry = CEGUI::FontManager::getSingleton().getRegisteredFonts();
     for (const auto& pair : fontRegistry)
@@ -655,6 +724,9 @@ QStringList CEGUIManager::getAvailableFonts() const
 
 bool CEGUIManager::saveFont(CEGUI::Font& font, bool addToSchemes) const
 {
+    // The font might have been just created
+    _availableFonts.clear();
+
     const QString fontDescFileName = CEGUIUtils::stringToQString(font.getName()) + ".font";
 
     // Save an XML font description to the project
@@ -713,7 +785,9 @@ bool CEGUIManager::saveFont(CEGUI::Font& font, bool addToSchemes) const
 // see syncProjectToCEGUIInstance
 QStringList CEGUIManager::getAvailableImages() const
 {
-    QStringList images;
+    if (!_availableImages.empty()) return _availableImages;
+
+    QStringList& images = _availableImages;
 
     auto it = CEGUI::ImageManager::getSingleton().getIterator();
     while (!it.isAtEnd())
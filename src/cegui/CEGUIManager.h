@@ -2,6 +2,7 @@
 #define CEGUIManager_H
 #include "qstring.h"
 #include "qimage.h"
+#include "qstringlist.h"
 #include <memory>
 #include <functional>
 #include <CEGUI/views/StandardItemModel.h>
@@ -17,6 +18,7 @@ class QOpenGLContext;
 class QOffscreenSurface;
 class RedirectingCEGUILogger;
 class CEGUIDebugInfo;
+class ProjectSymbolIndex;
 
 class CEGUIManager
 {
@@ -38,10 +40,15 @@ public:
     }
 
     CEGUIProject* createProject(const QString& filePath, bool createResourceDirs);
-    void loadProject(const QString& filePath);
+    bool loadProject(const QString& filePath);
     void unloadProject();
     bool isProjectLoaded() const { return currentProject != nullptr; }
     CEGUIProject* getCurrentProject() const { return currentProject.get(); }
+    ProjectSymbolIndex* getSymbolIndex() const { return _symbolIndex.get(); }
+
+    // No dialogs are shown, errors go to stderr. For batch processing without a user.
+    void setHeadless(bool headless) { _headless = headless; }
+    bool isHeadless() const { return _headless; }
 
     QStringList getAvailableSkins() const;
     QStringList getAvailableFonts() const;
@@ -77,7 +84,10 @@ public:
 
 protected:
 
+    void reportError(const QString& title, const QString& text, bool critical = false) const;
     void cleanCEGUIResources();
+    void invalidateAvailableNames() const;
+    void onResourceFileChanged(const QString& filePath);
     void initializePreviewWidgetSpecific(CEGUI::Window* widgetInstance, const QString& widgetType);
 
     QOpenGLContext* glContext = nullptr;
@@ -89,6 +99,11 @@ protected:
     std::map<QString, QImage> _widgetPreviewCache;
     CEGUI::StandardItemModel _listItemModel;
 
+    // Sorted lists of resources loaded into CEGUI, built on first request after the sync
+    mutable QStringList _availableSkins;
+    mutable QStringList _availableFonts;
+    mutable QStringList _availableImages;
+
     QtnEnumInfo* _enumHorizontalAlignment = nullptr;
     QtnEnumInfo* _enumVerticalAlignment = nullptr;
     QtnEnumInfo* _enumAspectMode = nullptr;
@@ -108,8 +123,10 @@ protected:
     QtnEnumInfo* _enumMenubarDirection = nullptr;
 
     std::unique_ptr<CEGUIProject> currentProject;
+    std::unique_ptr<ProjectSymbolIndex> _symbolIndex;
     bool initialized = false;
     bool _isOpenGL3 = false;
+    bool _headless = false;
 };
 
 #endif // CEGUIManager_H
@@ -1,9 +1,10 @@
 #include "src/cegui/CEGUIProject.h"
 #include "src/cegui/CEGUIProjectItem.h"
 #include "src/Application.h"
+#include "src/util/FileWriter.h"
 #include <qdir.h>
 #include <qdom.h>
-#include <qtextstream.h>
+#include <qfuturewatcher.h>
 #include <qmessagebox.h>
 
 const QString CEGUIProject::EditorEmbeddedCEGUIVersion("1.0");
@@ -25,6 +26,33 @@ CEGUIProject::CEGUIProject()
     // NB: we must not delete it, Qt does this for us
     setItemPrototype(new CEGUIProjectItem(this));
     changed = false; // HACK, see CEGUIProjectItem constructor
+
+    _indexedBaseDirectory = getAbsolutePathOf("");
+
+    connect(this, &QStandardItemModel::rowsInserted, [this](const QModelIndex& parent, int first, int last)
+    {
+        indexItems(parent.isValid() ? itemFromIndex(parent) : invisibleRootItem(), first, last);
+    });
+    connect(this, &QStandardItemModel::rowsAboutToBeRemoved, [this](const QModelIndex& parent, int first, int last)
+    {
+        unindexItems(parent.isValid() ? itemFromIndex(parent) : invisibleRootItem(), first, last);
+    });
+    connect(this, &QStandardItemModel::dataChanged, [this](const QModelIndex& topLeft, const QModelIndex& bottomRight, const QVector<int>& roles)
+    {
+        // Only type and path changes are interesting, not text or icon
+        if (!roles.empty() && !roles.contains(Qt::UserRole + 1) && !roles.contains(Qt::UserRole + 2)) return;
+
+        for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+        {
+            auto changedItem = itemFromIndex(index(row, 0, topLeft.parent()));
+            unindexItem(changedItem);
+            indexItem(changedItem);
+        }
+    });
+    connect(this, &QStandardItemModel::modelReset, [this]()
+    {
+        rebuildFilePathIndex();
+    });
 }
 
 CEGUIProject::~CEGUIProject()
@@ -86,7 +114,8 @@ bool CEGUIProject::loadFromFile(const QString& fileName)
     return true;
 }
 
-bool CEGUIProject::save(const QString& newFilePath)
+// In async mode returns after the project is serialized, a writing error is reported later
+bool CEGUIProject::save(const QString& newFilePath, bool async)
 {
     if (!newFilePath.isEmpty() && filePath != newFilePath)
     {
@@ -132,43 +161,37 @@ bool CEGUIProject::save(const QString& newFilePath)
     xmlRoot.appendChild(xmlItems);
     doc.appendChild(xmlRoot);
 
-    // If the file already exists, rename it to avoid data losing due to save error
-    const bool tmpUsed = QFileInfo(filePath).exists();
-    if (tmpUsed)
+    // Written in background, the existing file is replaced only when the new one is complete
+    const QString savedFilePath = filePath;
+    QFuture<bool> future = FileWriter::write(savedFilePath, doc.toByteArray(4));
+    if (!async)
     {
-        QFile prevFile(filePath);
-        if (!prevFile.rename(filePath + ".bak"))
-        {
-            QMessageBox::critical(qobject_cast<Application*>(qApp)->getMainWindow(),
-                                  "Error saving project!",
-                                  "CEED encountered an error trying to save the project file " + filePath);
-            return false;
-        }
+        const bool result = future.result();
+        onSaveFinished(savedFilePath, result);
+        return result;
     }
 
-    // Save to file
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text))
+    auto watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, savedFilePath]()
     {
-        QTextStream stream(&file);
-        doc.save(stream, 4);
-        file.close();
-        if (tmpUsed) QFile(filePath + ".bak").remove();
-        return true;
-    }
+        onSaveFinished(savedFilePath, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
 
-    // Something went wrong, show error and restore backup
+    return true;
+}
+
+void CEGUIProject::onSaveFinished(const QString& savedFilePath, bool result)
+{
+    if (result) return;
+
+    // Something went wrong, the file is left untouched
     QMessageBox::critical(qobject_cast<Application*>(qApp)->getMainWindow(),
                           "Error saving project!",
-                          "CEED encountered an error trying to save the project file " + filePath);
-
-    if (tmpUsed)
-    {
-        QFile(filePath).remove();
-        QFile(filePath + ".bak").rename(filePath);
-    }
+                          "CEED encountered an error trying to save the project file " + savedFilePath);
 
-    return false;
+    changed = true;
 }
 
 void CEGUIProject::unload()
@@ -255,14 +278,106 @@ QString CEGUIProject::getResourceFilePath(const QString& fileName, const QString
 // Checks whether given absolute path is referenced by any File item in the project
 bool CEGUIProject::referencesFilePath(const QString& filePath) const
 {
-    for (int i = 0; i < rowCount(); ++i)
+    if (_indexedBaseDirectory != getAbsolutePathOf(""))
+        rebuildFilePathIndex();
+
+    // Items are indexed by the canonical path when the file exists, by the clean path otherwise.
+    // The file may have been created or deleted since then, so both are checked.
+#ifdef Q_OS_WIN
+    const QString cleanPath = QDir::cleanPath(QFileInfo(filePath).absoluteFilePath()).toLower();
+#else
+    const QString cleanPath = QDir::cleanPath(QFileInfo(filePath).absoluteFilePath());
+#endif
+    if (_filePathRefCounts.find(cleanPath) != _filePathRefCounts.end())
+        return true;
+
+    const QString canonicalPath = getCanonicalPath(cleanPath);
+    return canonicalPath != cleanPath && _filePathRefCounts.find(canonicalPath) != _filePathRefCounts.end();
+}
+
+// Figuring out whether 2 paths lead to the same file is a tricky business.
+// We will do our best but this might not work in all cases!
+QString CEGUIProject::getCanonicalPath(const QString& absolutePath)
+{
+    const QString canonicalPath = QFileInfo(absolutePath).canonicalFilePath();
+#ifdef Q_OS_WIN
+    return (canonicalPath.isEmpty() ? absolutePath : canonicalPath).toLower();
+#else
+    return canonicalPath.isEmpty() ? absolutePath : canonicalPath;
+#endif
+}
+
+void CEGUIProject::indexItems(const QStandardItem* parent, int first, int last)
+{
+    if (!parent) return;
+
+    for (int row = first; row <= last; ++row)
     {
-        auto itemPtr = static_cast<CEGUIProjectItem*>(item(i));
-        if (itemPtr->referencesFilePath(filePath))
-            return true;
+        auto item = parent->child(row);
+        if (!item) continue;
+        indexItem(item);
+        indexItems(item, 0, item->rowCount() - 1);
+    }
+}
+
+void CEGUIProject::unindexItems(const QStandardItem* parent, int first, int last)
+{
+    if (!parent) return;
+
+    for (int row = first; row <= last; ++row)
+    {
+        auto item = parent->child(row);
+        if (!item) continue;
+        unindexItem(item);
+        unindexItems(item, 0, item->rowCount() - 1);
     }
+}
+
+void CEGUIProject::indexItem(const QStandardItem* item) const
+{
+    auto projectItem = dynamic_cast<const CEGUIProjectItem*>(item);
+    if (!projectItem || projectItem->getType() != CEGUIProjectItem::Type::File) return;
+
+    // Path is set after the type, an item may be in the model without it for a while
+    const QString path = projectItem->getPath();
+    if (path.isEmpty()) return;
 
-    return false;
+    const QString canonicalPath = getCanonicalPath(getAbsolutePathOf(path));
+    _itemFilePaths[item] = canonicalPath;
+    ++_filePathRefCounts[canonicalPath];
+}
+
+void CEGUIProject::unindexItem(const QStandardItem* item) const
+{
+    auto it = _itemFilePaths.find(item);
+    if (it == _itemFilePaths.end()) return;
+
+    auto countIt = _filePathRefCounts.find(it->second);
+    if (countIt != _filePathRefCounts.end() && --countIt->second <= 0)
+        _filePathRefCounts.erase(countIt);
+
+    _itemFilePaths.erase(it);
+}
+
+void CEGUIProject::rebuildFilePathIndex() const
+{
+    _itemFilePaths.clear();
+    _filePathRefCounts.clear();
+    _indexedBaseDirectory = getAbsolutePathOf("");
+
+    std::vector<const QStandardItem*> stack;
+    for (int i = 0; i < rowCount(); ++i)
+        stack.push_back(item(i));
+
+    while (!stack.empty())
+    {
+        auto currItem = stack.back();
+        stack.pop_back();
+
+        indexItem(currItem);
+        for (int i = 0; i < currItem->rowCount(); ++i)
+            stack.push_back(currItem->child(i));
+    }
 }
 
 void CEGUIProject::setDefaultResolution(const QString& string)
@@ -4,6 +4,8 @@
 #include <qstring.h>
 #include <qstandarditemmodel.h>
 #include <quuid.h>
+#include "src/QtStdHash.h"
+#include <unordered_map>
 
 // Incapsulates a single CEGUI (CEED) project info and methods to work with it
 
@@ -21,7 +23,7 @@ public:
     virtual Qt::DropActions supportedDragActions() const override;
 
     bool loadFromFile(const QString& fileName);
-    bool save(const QString& newFilePath = QString());
+    bool save(const QString& newFilePath = QString(), bool async = false);
     void unload();
 
     bool checkAllDirectories() const;
@@ -56,8 +58,25 @@ public: // For now, to avoid lots of boilerplate setters & getters
 
 private:
 
+    static QString getCanonicalPath(const QString& absolutePath);
+
+    void indexItems(const QStandardItem* parent, int first, int last);
+    void unindexItems(const QStandardItem* parent, int first, int last);
+    void indexItem(const QStandardItem* item) const;
+    void unindexItem(const QStandardItem* item) const;
+    void rebuildFilePathIndex() const;
+
     QSize defaultResolution;
 
+    // Canonical paths of all File items for O(1) referencesFilePath. Updated from model signals, so that
+    // adding, removing, moving and renaming items from anywhere keeps it valid. Rebuilt lazily when
+    // the base directory changes, because all paths are relative to it.
+    mutable std::unordered_map<const QStandardItem*, QString> _itemFilePaths;
+    mutable std::unordered_map<QString, int> _filePathRefCounts; // The same file may be added more than once
+    mutable QString _indexedBaseDirectory;
+
+    void onSaveFinished(const QString& savedFilePath, bool result);
+
     bool changed = true; // A new project is not saved yet
 };
 
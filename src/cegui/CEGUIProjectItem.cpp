@@ -200,29 +200,3 @@ QString CEGUIProjectItem::getAbsolutePath() const
     assert(getType() == Type::File);
     return _project->getAbsolutePathOf(getPath());
 }
-
-// Checks whether given absolute path is referenced by this Item
-// or any of its descendants
-bool CEGUIProjectItem::referencesFilePath(const QString& filePath) const
-{
-    auto type = getType();
-    if (type == Type::File)
-    {
-        // Figuring out whether 2 paths lead to the same file is a tricky
-        // business. We will do our best but this might not work in all cases!
-        QFileInfo thisPath(QDir::cleanPath(getAbsolutePath()));
-        QFileInfo otherPath(QDir::cleanPath(filePath));
-        return thisPath == otherPath;
-    }
-    else if (type == Type::Folder)
-    {
-        for (int i = 0; i < rowCount(); ++i)
-        {
-            auto itemPtr = static_cast<CEGUIProjectItem*>(child(i));
-            if (itemPtr->referencesFilePath(filePath))
-                return true;
-        }
-    }
-
-    return false;
-}
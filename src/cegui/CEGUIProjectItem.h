@@ -45,7 +45,6 @@ public:
     QString getPath() const;
     QString getRelativePath() const;
     QString getAbsolutePath() const;
-    bool referencesFilePath(const QString& filePath) const;
 
 protected:
 
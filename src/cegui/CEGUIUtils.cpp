@@ -54,6 +54,39 @@ CEGUI::String getUniqueChildWidgetName(const CEGUI::Window& parent, const CEGUI:
     return candidate;
 }
 
+// Same naming scheme as above, but suffix counters are remembered per base name
+// so that pasting N copies of "Button" doesn't rescan the parent N^2 times.
+CEGUI::String UniqueNameAllocator::getUniqueChildWidgetName(const CEGUI::Window& parent, const CEGUI::String& baseName)
+{
+    auto it = _parents.find(&parent);
+    if (it == _parents.end())
+    {
+        it = _parents.emplace(&parent, NameTable{}).first;
+        auto& names = it->second.names;
+        const size_t childCount = parent.getChildCount();
+        names.reserve(childCount);
+        for (size_t i = 0; i < childCount; ++i)
+            names.insert(stringToQString(parent.getChildAtIndex(i)->getName()));
+    }
+
+    NameTable& table = it->second;
+    const QString base = stringToQString(baseName);
+    QString candidate = base;
+    if (table.names.find(candidate) != table.names.end())
+    {
+        int& suffix = table.nextSuffix.emplace(base, 2).first->second;
+        do
+        {
+            candidate = base + QString::number(suffix);
+            ++suffix;
+        }
+        while (table.names.find(candidate) != table.names.end());
+    }
+
+    table.names.insert(candidate);
+    return qStringToString(candidate);
+}
+
 QString getRelativePath(const CEGUI::Window* widget, const CEGUI::Window* parent)
 {
     if (!widget || widget == parent) return QString{};
@@ -184,8 +217,12 @@ bool serializeWidget(const CEGUI::Window& widget, QDataStream& stream, bool recu
     return true;
 }
 
-CEGUI::Window* deserializeWidget(QDataStream& stream, CEGUI::Window* parent, size_t index)
+CEGUI::Window* deserializeWidget(QDataStream& stream, CEGUI::Window* parent, size_t index, UniqueNameAllocator* nameAllocator)
 {
+    // Share name tables across the whole hierarchy being deserialized
+    UniqueNameAllocator localNameAllocator;
+    if (!nameAllocator) nameAllocator = &localNameAllocator;
+
     QString name, type;
     stream >> name;
     stream >> type;
@@ -215,7 +252,7 @@ CEGUI::Window* deserializeWidget(QDataStream& stream, CEGUI::Window* parent, siz
     else
     {
         CEGUI::String widgetName = qStringToString(name);
-        if (parent) widgetName = getUniqueChildWidgetName(*parent, widgetName);
+        if (parent) widgetName = nameAllocator->getUniqueChildWidgetName(*parent, widgetName);
         widget = CEGUI::WindowManager::getSingleton().createWindow(qStringToString(type), widgetName);
         if (parent && !insertChild(parent, widget, index))
         {
@@ -237,7 +274,7 @@ CEGUI::Window* deserializeWidget(QDataStream& stream, CEGUI::Window* parent, siz
     uint16_t childCount = 0;
     stream >> childCount;
     for (uint16_t i = 0; i < childCount; ++i)
-        deserializeWidget(stream, widget);
+        deserializeWidget(stream, widget, std::numeric_limits<size_t>().max(), nameAllocator);
 
     return widget;
 }
@@ -2,7 +2,10 @@
 #define CEGUIUTILS_H
 
 #include "qstring.h"
+#include "src/QtStdHash.h"
 #include <CEGUI/InputEvent.h>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace CEGUI
 {
@@ -21,11 +24,33 @@ namespace CEGUIUtils
     QString getUniqueChildWidgetName(const CEGUI::Window& parent, const QString& baseName);
     CEGUI::String getUniqueChildWidgetName(const CEGUI::Window& parent, const CEGUI::String& baseName);
 
+    // Generates unique child names for bulk insertions (paste, duplicate etc) in amortized O(1).
+    // A name table is collected once per parent and then updated with every name given out, so
+    // the allocator must live no longer than one operation during which children aren't renamed.
+    class UniqueNameAllocator
+    {
+    public:
+
+        CEGUI::String getUniqueChildWidgetName(const CEGUI::Window& parent, const CEGUI::String& baseName);
+        void clear() { _parents.clear(); }
+
+    protected:
+
+        struct NameTable
+        {
+            std::unordered_set<QString> names;
+            std::unordered_map<QString, int> nextSuffix;
+        };
+
+        std::unordered_map<const CEGUI::Window*, NameTable> _parents;
+    };
+
     QString getRelativePath(const CEGUI::Window* widget, const CEGUI::Window* parent);
     void removeNestedPaths(QStringList& paths);
 
     bool serializeWidget(const CEGUI::Window& widget, QDataStream& stream, bool recursive);
-    CEGUI::Window* deserializeWidget(QDataStream& stream, CEGUI::Window* parent = nullptr, size_t index = std::numeric_limits<size_t>().max());
+    CEGUI::Window* deserializeWidget(QDataStream& stream, CEGUI::Window* parent = nullptr, size_t index = std::numeric_limits<size_t>().max(),
+                                     UniqueNameAllocator* nameAllocator = nullptr);
 
     void addChild(CEGUI::Window* parent, CEGUI::Window* widget);
     bool insertChild(CEGUI::Window* parent, CEGUI::Window* widget, size_t index);
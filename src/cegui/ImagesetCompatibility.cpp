@@ -0,0 +1,139 @@
+#include "src/cegui/ImagesetCompatibility.h"
+#include "qxmlstream.h"
+#include "qdom.h"
+#include <utility>
+
+const QString ImagesetCompatibility::CEGUIImageset1("CEGUI imageset 1");
+const QString ImagesetCompatibility::CEGUIImageset2("CEGUI imageset 2");
+
+// Attributes renamed between versions, in the version 1 -> version 2 direction
+static const std::pair<const char*, const char*> ImagesetAttributes[] =
+{
+    { "Imagefile", "imagefile" },
+    { "ResourceGroup", "resourceGroup" },
+    { "Name", "name" },
+    { "NativeHorzRes", "nativeHorzRes" },
+    { "NativeVertRes", "nativeVertRes" },
+    { "AutoScaled", "autoScaled" }
+};
+
+static const std::pair<const char*, const char*> ImageAttributes[] =
+{
+    { "Name", "name" },
+    { "XPos", "xPos" },
+    { "YPos", "yPos" },
+    { "Width", "width" },
+    { "Height", "height" },
+    { "XOffset", "xOffset" },
+    { "YOffset", "yOffset" }
+};
+
+static void renameAttribute(QDomElement& element, const QString& from, const QString& to)
+{
+    if (!element.hasAttribute(from)) return;
+    const QString value = element.attribute(from);
+    element.removeAttribute(from);
+    element.setAttribute(to, value);
+}
+
+QStringList ImagesetCompatibility::getTypes()
+{
+    return { CEGUIImageset1, CEGUIImageset2 };
+}
+
+QString ImagesetCompatibility::getTypeForCEGUIVersion(const QString& ceguiVersion)
+{
+    if (ceguiVersion == "0.6" || ceguiVersion == "0.7") return CEGUIImageset1;
+    if (ceguiVersion == "0.8" || ceguiVersion == "1.0") return CEGUIImageset2;
+    return QString();
+}
+
+// Only the root element is read
+QString ImagesetCompatibility::detectType(const QByteArray& data)
+{
+    QXmlStreamReader xml(data);
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+
+        if (xml.name() != QLatin1String("Imageset")) return QString();
+
+        const auto version = xml.attributes().value("version");
+        if (version.isNull()) return CEGUIImageset1;
+        if (version == QLatin1String("2")) return CEGUIImageset2;
+        return QString();
+    }
+
+    return QString();
+}
+
+QString ImagesetCompatibility::transform(const QByteArray& data, const QString& sourceType, const QString& targetType, QByteArray& out)
+{
+    if (!getTypes().contains(sourceType)) return QString("Unknown source data type '%1'").arg(sourceType);
+    if (!getTypes().contains(targetType)) return QString("Unknown target data type '%1'").arg(targetType);
+
+    if (sourceType == targetType)
+    {
+        out = data;
+        return QString();
+    }
+
+    QDomDocument doc;
+    QString parseError;
+    int errorLine = 0;
+    if (!doc.setContent(data, &parseError, &errorLine))
+        return QString("XML error at line %1: %2").arg(errorLine).arg(parseError);
+
+    auto root = doc.documentElement();
+    if (root.tagName() != "Imageset") return "The root element is not 'Imageset'";
+
+    const bool upgrade = (targetType == CEGUIImageset2);
+
+    if (upgrade)
+    {
+        root.setAttribute("version", "2");
+        for (const auto& pair : ImagesetAttributes)
+            renameAttribute(root, pair.first, pair.second);
+    }
+    else
+    {
+        root.removeAttribute("version"); // Version 1 has no version attribute
+
+        // Version 1 knows nothing about scaling modes
+        if (root.hasAttribute("autoScaled"))
+        {
+            const QString value = root.attribute("autoScaled");
+            const bool scaled = (value == "true" || value == "vertical" || value == "horizontal" || value == "min" || value == "max");
+            root.setAttribute("autoScaled", scaled ? "true" : "false");
+        }
+
+        for (const auto& pair : ImagesetAttributes)
+            renameAttribute(root, pair.second, pair.first);
+    }
+
+    for (auto image = root.firstChildElement("Image"); !image.isNull(); image = image.nextSiblingElement("Image"))
+    {
+        const QString type = image.attribute("type", "BasicImage");
+        if (type != "BasicImage")
+        {
+            if (!upgrade)
+                return QString("Image '%1' of type '%2' can't be converted, imageset version 1 supports only basic images")
+                        .arg(image.attribute("name"), type);
+            continue;
+        }
+
+        for (const auto& pair : ImageAttributes)
+        {
+            if (upgrade)
+                renameAttribute(image, pair.first, pair.second);
+            else
+                renameAttribute(image, pair.second, pair.first);
+        }
+    }
+
+    if (!doc.firstChild().isProcessingInstruction())
+        doc.insertBefore(doc.createProcessingInstruction("xml", "version=\"1.0\" encoding=\"UTF-8\""), doc.firstChild());
+
+    out = doc.toByteArray(4);
+    return QString();
+}
@@ -0,0 +1,27 @@
+#ifndef IMAGESETCOMPATIBILITY_H
+#define IMAGESETCOMPATIBILITY_H
+
+#include "qstringlist.h"
+#include "qbytearray.h"
+
+// Converts imageset data between CEGUI data versions: version 1 (CEGUI 0.6 - 0.7, capitalized attributes,
+// no version attribute) and version 2 (CEGUI 0.8+). Works on raw XML and doesn't need CEGUI,
+// so it is usable from worker threads and from the command line tool.
+
+class ImagesetCompatibility
+{
+public:
+
+    static const QString CEGUIImageset1;
+    static const QString CEGUIImageset2;
+
+    static const QString& getNativeType() { return CEGUIImageset2; }
+    static QStringList getTypes();
+    static QString getTypeForCEGUIVersion(const QString& ceguiVersion);
+    static QString detectType(const QByteArray& data);
+
+    // Returns an error message or an empty string on success
+    static QString transform(const QByteArray& data, const QString& sourceType, const QString& targetType, QByteArray& out);
+};
+
+#endif // IMAGESETCOMPATIBILITY_H
@@ -0,0 +1,286 @@
+#include "src/cegui/LayoutBatchRenderer.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/CEGUIProject.h"
+#include "src/cegui/CEGUIUtils.h"
+#include <CEGUI/RendererModules/OpenGL/RendererBase.h>
+#include <CEGUI/RendererModules/OpenGL/ViewportTarget.h>
+#include <CEGUI/System.h>
+#include <CEGUI/GUIContext.h>
+#include <CEGUI/WindowManager.h>
+#include <CEGUI/FontManager.h>
+#include "qopenglcontext.h"
+#include "qopenglfunctions.h"
+#include "qopenglframebufferobject.h"
+#include "qopenglbuffer.h"
+#include "qthreadpool.h"
+#include "qdiriterator.h"
+#include "qfileinfo.h"
+#include "qfile.h"
+#include "qdir.h"
+#include "qimage.h"
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <deque>
+#include <cstring>
+
+namespace
+{
+
+// A layout rendered, but not read back yet
+struct PendingReadback
+{
+    int buffer;
+    QString outputPath;
+};
+
+}
+
+// Runs in a worker thread, returns an error message
+static QString encodeImage(const QImage& image, const QString& outputPath, bool flip)
+{
+    // OpenGL rows go from the bottom up
+    if (!(flip ? image.mirrored() : image).save(outputPath, "PNG"))
+        return QString("Failed to save '%1'").arg(outputPath);
+    return QString();
+}
+
+QStringList LayoutBatchRenderer::findLayouts(const CEGUIProject& project)
+{
+    QStringList layoutPaths;
+    QDirIterator it(project.getResourceFilePath("", "layouts"), { "*.layout" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        layoutPaths.push_back(QDir::cleanPath(it.next()));
+    layoutPaths.sort();
+    return layoutPaths;
+}
+
+// "1280x720,800x600". An empty list means the default resolution, invalid entries are skipped.
+std::vector<QSize> LayoutBatchRenderer::parseResolutions(const QString& list, const QSize& defaultResolution)
+{
+    std::vector<QSize> resolutions;
+    for (const QString& entry : list.split(','))
+    {
+        // Empty entries have a single part and are skipped too
+        const QStringList parts = entry.trimmed().split('x');
+        if (parts.size() != 2) continue;
+
+        const QSize size(parts[0].toInt(), parts[1].toInt());
+        if (!size.isEmpty()) resolutions.push_back(size);
+    }
+
+    if (list.trimmed().isEmpty()) resolutions.push_back(defaultResolution);
+
+    return resolutions;
+}
+
+// Subdirectories of the layout directory are kept, so that layouts with the same name don't collide
+QString LayoutBatchRenderer::getOutputFileName(const QString& relativeLayoutPath, const QSize& resolution)
+{
+    const QFileInfo info(relativeLayoutPath);
+    const QString fileName = QString("%1-%2x%3.png").arg(info.completeBaseName()).arg(resolution.width()).arg(resolution.height());
+    return (info.path() == ".") ? fileName : QDir(info.path()).filePath(fileName);
+}
+
+LayoutBatchRenderer::LayoutBatchRenderer(const CEGUIProject& project, const QString& outputDir)
+    : _project(project)
+    , _outputDir(outputDir)
+{
+}
+
+QStringList LayoutBatchRenderer::render(const QStringList& layoutPaths, const std::vector<QSize>& resolutions,
+                                        const std::function<bool(int, int)>& onProgress)
+{
+    _renderedCount = 0;
+    _outputFiles.clear();
+    _failedFiles.clear();
+
+    QStringList errors;
+    if (layoutPaths.empty() || resolutions.empty()) return errors;
+
+    // Layouts are parsed once, loading them for each resolution is cheap
+    std::vector<CEGUI::String> layoutData;
+    layoutData.reserve(static_cast<size_t>(layoutPaths.size()));
+    for (const QString& layoutPath : layoutPaths)
+    {
+        QFile file(layoutPath);
+        if (!file.open(QIODevice::ReadOnly)) errors.push_back(QString("Can't read '%1'").arg(layoutPath));
+        layoutData.push_back(CEGUIUtils::qStringToString(QString::fromUtf8(file.readAll())));
+    }
+
+    auto& ceguiManager = CEGUIManager::Instance();
+    ceguiManager.ensureCEGUIInitialized();
+    if (!ceguiManager.makeOpenGLContextCurrent())
+    {
+        errors.push_back("Can't make the OpenGL context current");
+        return errors;
+    }
+
+    auto gl = QOpenGLContext::currentContext()->functions();
+    auto& system = CEGUI::System::getSingleton();
+    auto renderer = static_cast<CEGUI::OpenGLRendererBase*>(system.getRenderer());
+    const CEGUI::Sizef originalDisplaySize = renderer->getDisplaySize();
+
+    const auto& fontRegistry = CEGUI::FontManager::getSingleton().getRegisteredFonts();
+    CEGUI::Font* defaultFont = fontRegistry.empty() ? nullptr : fontRegistry.begin()->second;
+
+    const QDir outputDir(_outputDir);
+    const QDir layoutsDir(_project.getResourceFilePath("", "layouts"));
+    const int total = layoutPaths.size() * static_cast<int>(resolutions.size());
+    const int maxEncodingJobs = 2 * std::max(1, QThreadPool::globalInstance()->maxThreadCount());
+    std::deque<QFuture<QString>> encodingJobs;
+    bool canceled = false;
+
+    for (const QSize& resolution : resolutions)
+    {
+        if (canceled) break;
+
+        const int w = resolution.width();
+        const int h = resolution.height();
+        const int byteCount = w * h * 4;
+
+        // Fonts and autoscaled images depend on the display size
+        system.notifyDisplaySizeChanged(CEGUI::Sizef(static_cast<float>(w), static_cast<float>(h)));
+
+        auto renderTarget = new CEGUI::OpenGLViewportTarget(*renderer, CEGUI::Rectf(0.f, 0.f, static_cast<float>(w), static_cast<float>(h)));
+        auto& context = system.createGUIContext(*renderTarget);
+        if (defaultFont) context.setDefaultFont(defaultFont);
+
+        QOpenGLFramebufferObject fbo(w, h, QOpenGLFramebufferObject::CombinedDepthStencil);
+
+        // Without pixel buffers readback blocks until rendering finishes
+        QOpenGLBuffer buffers[2] = { QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer), QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer) };
+        bool useBuffers = true;
+        for (auto& buffer : buffers)
+        {
+            if (!buffer.create()) { useBuffers = false; break; }
+            buffer.setUsagePattern(QOpenGLBuffer::StreamRead);
+            buffer.bind();
+            buffer.allocate(byteCount);
+            buffer.release();
+        }
+
+        std::deque<PendingReadback> pending;
+        int readbackCount = 0; // Layouts that failed to load don't take a buffer
+
+        auto finishReadback = [&]()
+        {
+            const PendingReadback readback = pending.front();
+            pending.pop_front();
+
+            QImage image(w, h, QImage::Format_RGBA8888_Premultiplied);
+            auto& buffer = buffers[readback.buffer];
+            buffer.bind();
+            const void* pixels = buffer.map(QOpenGLBuffer::ReadOnly);
+            if (pixels)
+            {
+                memcpy(image.bits(), pixels, static_cast<size_t>(byteCount));
+                buffer.unmap();
+            }
+            buffer.release();
+
+            if (!pixels)
+            {
+                errors.push_back(QString("Failed to read pixels for '%1'").arg(readback.outputPath));
+                return;
+            }
+
+            // Keep memory bounded when encoding is slower than rendering
+            while (static_cast<int>(encodingJobs.size()) >= maxEncodingJobs)
+            {
+                const QString error = encodingJobs.front().result();
+                if (!error.isEmpty()) errors.push_back(error);
+                encodingJobs.pop_front();
+            }
+
+            encodingJobs.push_back(QtConcurrent::run(encodeImage, image, readback.outputPath, true));
+        };
+
+        for (int i = 0; i < layoutPaths.size(); ++i)
+        {
+            const QString outputFileName = getOutputFileName(layoutsDir.relativeFilePath(layoutPaths[i]), resolution);
+            const QString outputPath = outputDir.filePath(outputFileName);
+            outputDir.mkpath(QFileInfo(outputPath).path());
+
+            CEGUI::Window* root = nullptr;
+            try
+            {
+                // Unreadable files are already reported
+                const CEGUI::String& data = layoutData[static_cast<size_t>(i)];
+                if (!data.empty()) root = CEGUI::WindowManager::getSingleton().loadLayoutFromString(data);
+            }
+            catch (const std::exception& e)
+            {
+                errors.push_back(QString("%1: %2").arg(layoutPaths[i], e.what()));
+            }
+
+            if (root)
+            {
+                context.setRootWindow(root);
+                context.injectTimePulse(0.f);
+
+                fbo.bind();
+                gl->glViewport(0, 0, w, h);
+                gl->glClearColor(0.f, 0.f, 0.f, 0.f);
+                gl->glClear(GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+                renderer->beginRendering();
+                context.draw();
+                renderer->endRendering();
+
+                if (useBuffers)
+                {
+                    // Starts an asynchronous transfer, the previous one is completed meanwhile
+                    const int bufferIndex = readbackCount++ % 2;
+                    buffers[bufferIndex].bind();
+                    gl->glReadPixels(0, 0, w, h, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+                    buffers[bufferIndex].release();
+                    fbo.release();
+
+                    if (!pending.empty()) finishReadback();
+                    pending.push_back({ bufferIndex, outputPath });
+                }
+                else
+                {
+                    fbo.release();
+                    encodingJobs.push_back(QtConcurrent::run(encodeImage, fbo.toImage(), outputPath, false));
+                }
+
+                context.setRootWindow(nullptr);
+                CEGUI::WindowManager::getSingleton().destroyWindow(root);
+                _outputFiles.push_back(outputFileName);
+                ++_renderedCount;
+            }
+            else
+            {
+                _failedFiles.push_back(outputFileName);
+            }
+
+            if (onProgress && !onProgress(_renderedCount, total))
+            {
+                canceled = true;
+                break;
+            }
+        }
+
+        while (!pending.empty()) finishReadback();
+
+        for (auto& buffer : buffers)
+            buffer.destroy();
+
+        system.destroyGUIContext(context);
+        delete renderTarget;
+    }
+
+    CEGUI::WindowManager::getSingleton().cleanDeadPool();
+    system.notifyDisplaySizeChanged(originalDisplaySize);
+    ceguiManager.doneOpenGLContextCurrent();
+
+    for (auto& job : encodingJobs)
+    {
+        const QString error = job.result();
+        if (!error.isEmpty()) errors.push_back(error);
+    }
+
+    if (canceled) errors.push_back("Canceled");
+
+    return errors;
+}
@@ -0,0 +1,43 @@
+#ifndef LAYOUTBATCHRENDERER_H
+#define LAYOUTBATCHRENDERER_H
+
+#include "qstringlist.h"
+#include "qsize.h"
+#include <functional>
+#include <vector>
+
+// Renders layouts of the loaded project to PNG files at a list of resolutions, using the shared
+// CEGUI instance and a single GUI context per resolution. Readback is pipelined through two pixel
+// pack buffers: pixels of a layout are transferred while the next one is being rendered. Images are
+// flipped and encoded on the global thread pool. Must be called from the main thread.
+
+class CEGUIProject;
+
+class LayoutBatchRenderer
+{
+public:
+
+    static QStringList findLayouts(const CEGUIProject& project);
+    static std::vector<QSize> parseResolutions(const QString& list, const QSize& defaultResolution);
+    static QString getOutputFileName(const QString& relativeLayoutPath, const QSize& resolution);
+
+    LayoutBatchRenderer(const CEGUIProject& project, const QString& outputDir);
+
+    // Returns errors, empty if all layouts were rendered. The progress callback returns false to cancel.
+    QStringList render(const QStringList& layoutPaths, const std::vector<QSize>& resolutions,
+                       const std::function<bool(int done, int total)>& onProgress = nullptr);
+
+    int getRenderedCount() const { return _renderedCount; }
+    const QStringList& getOutputFiles() const { return _outputFiles; } // Relative to the output folder
+    const QStringList& getFailedFiles() const { return _failedFiles; } // Output files of layouts that failed to load
+
+protected:
+
+    const CEGUIProject& _project;
+    QString _outputDir;
+    QStringList _outputFiles;
+    QStringList _failedFiles;
+    int _renderedCount = 0;
+};
+
+#endif // LAYOUTBATCHRENDERER_H
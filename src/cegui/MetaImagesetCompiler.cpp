@@ -0,0 +1,266 @@
+#include "src/cegui/MetaImagesetCompiler.h"
+#include "src/cegui/ImagesetCompatibility.h"
+#include "src/util/RectPacker.h"
+#include "qfile.h"
+#include "qsavefile.h"
+#include "qfileinfo.h"
+#include "qdir.h"
+#include "qdom.h"
+#include "qpainter.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <algorithm>
+
+namespace
+{
+
+struct BuildResult
+{
+    std::vector<MetaImagesetCompiler::Image> images;
+    QString error;
+};
+
+}
+
+static BuildResult buildImagesetImages(const QString& filePath)
+{
+    BuildResult result;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        result.error = QString("Can't open imageset '%1'").arg(filePath);
+        return result;
+    }
+
+    const QByteArray rawData = file.readAll();
+    const QString type = ImagesetCompatibility::detectType(rawData);
+    if (type.isEmpty())
+    {
+        result.error = QString("'%1' is not a known imageset data type").arg(filePath);
+        return result;
+    }
+
+    QByteArray nativeData;
+    result.error = ImagesetCompatibility::transform(rawData, type, ImagesetCompatibility::getNativeType(), nativeData);
+    if (!result.error.isEmpty()) return result;
+
+    QDomDocument doc;
+    doc.setContent(nativeData);
+    const auto root = doc.documentElement();
+    const QString imagesetName = root.attribute("name");
+
+    const QString imageFilePath = QFileInfo(filePath).dir().absoluteFilePath(root.attribute("imagefile"));
+    const QImage entireImage(imageFilePath);
+    if (entireImage.isNull())
+    {
+        result.error = QString("Can't load the underlying image '%1' of imageset '%2'").arg(imageFilePath, filePath);
+        return result;
+    }
+
+    for (auto element = root.firstChildElement("Image"); !element.isNull(); element = element.nextSiblingElement("Image"))
+    {
+        MetaImagesetCompiler::Image image;
+        image.name = imagesetName + '/' + element.attribute("name");
+        image.image = entireImage.copy(element.attribute("xPos", "0").toInt(), element.attribute("yPos", "0").toInt(),
+                                       element.attribute("width", "1").toInt(), element.attribute("height", "1").toInt());
+        image.xOffset = element.attribute("xOffset", "0").toInt();
+        image.yOffset = element.attribute("yOffset", "0").toInt();
+        result.images.push_back(std::move(image));
+    }
+
+    return result;
+}
+
+// The file name part of the path may contain wildcards
+static BuildResult buildBitmapImages(const QString& pathPattern, int xOffset, int yOffset)
+{
+    BuildResult result;
+
+    const QFileInfo patternInfo(pathPattern);
+    const QDir dir = patternInfo.dir();
+    const QStringList fileNames = dir.entryList({ patternInfo.fileName() }, QDir::Files, QDir::Name);
+    if (fileNames.empty())
+    {
+        result.error = QString("No bitmaps match '%1'").arg(pathPattern);
+        return result;
+    }
+
+    for (const QString& fileName : fileNames)
+    {
+        MetaImagesetCompiler::Image image;
+        image.name = QFileInfo(fileName).completeBaseName();
+        image.image = QImage(dir.absoluteFilePath(fileName));
+        image.xOffset = xOffset;
+        image.yOffset = yOffset;
+
+        if (image.image.isNull())
+        {
+            result.error = QString("Can't load bitmap '%1'").arg(dir.absoluteFilePath(fileName));
+            return result;
+        }
+
+        result.images.push_back(std::move(image));
+    }
+
+    return result;
+}
+
+// Runs in a worker thread
+static BuildResult buildImages(const MetaImagesetCompiler::Input& input)
+{
+    if (input.type == "Imageset") return buildImagesetImages(input.path);
+    if (input.type == "Bitmap") return buildBitmapImages(input.path, input.xOffset, input.yOffset);
+
+    BuildResult result;
+    result.error = QString("Input type '%1' is not supported").arg(input.type);
+    return result;
+}
+
+QString MetaImagesetCompiler::load(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) return QString("Can't open '%1'").arg(filePath);
+
+    QDomDocument doc;
+    QString parseError;
+    int errorLine = 0;
+    if (!doc.setContent(&file, &parseError, &errorLine))
+        return QString("%1:%2: %3").arg(filePath).arg(errorLine).arg(parseError);
+
+    const auto root = doc.documentElement();
+    if (root.tagName() != "MetaImageset") return QString("'%1' is not a meta-imageset").arg(filePath);
+
+    _filePath = QFileInfo(filePath).absoluteFilePath();
+    _name = root.attribute("name");
+    _nativeHorzRes = root.attribute("nativeHorzRes", "800").toInt();
+    _nativeVertRes = root.attribute("nativeVertRes", "600").toInt();
+    _autoScaled = (root.attribute("autoScaled", "false") == "true");
+    _onlyPOT = (root.attribute("onlyPOT", "false") == "true");
+    _output = root.attribute("output");
+    _outputTargetType = root.attribute("outputTargetType", ImagesetCompatibility::getNativeType());
+
+    if (_output.isEmpty()) return QString("'%1' has no output specified").arg(filePath);
+    if (!ImagesetCompatibility::getTypes().contains(_outputTargetType))
+        return QString("Unknown output data type '%1'").arg(_outputTargetType);
+
+    const QDir dir = QFileInfo(_filePath).dir();
+    _inputs.clear();
+    for (auto element = root.firstChildElement(); !element.isNull(); element = element.nextSiblingElement())
+    {
+        Input input;
+        input.type = element.tagName();
+        input.path = QDir::cleanPath(dir.absoluteFilePath(element.attribute("path")));
+        input.xOffset = element.attribute("xOffset", "0").toInt();
+        input.yOffset = element.attribute("yOffset", "0").toInt();
+        _inputs.push_back(std::move(input));
+    }
+
+    return QString();
+}
+
+QString MetaImagesetCompiler::compile(const std::function<void(const QString&)>& log)
+{
+    auto report = [&log](const QString& message) { if (log) log(message); };
+
+    report(QString("Building images from %1 inputs").arg(_inputs.size()));
+    const auto results = QtConcurrent::blockingMapped<QVector<BuildResult>>(_inputs, buildImages);
+
+    std::vector<Image> images;
+    for (const BuildResult& result : results)
+    {
+        if (!result.error.isEmpty()) return result.error;
+        images.insert(images.end(), result.images.begin(), result.images.end());
+    }
+
+    if (images.empty()) return "No images to compile";
+
+    // Sorted by name for nicer diffs of the resulting imageset
+    std::sort(images.begin(), images.end(), [](const Image& a, const Image& b) { return a.name < b.name; });
+
+    const int border = _padding ? 1 : 0;
+    std::vector<QSize> sizes;
+    sizes.reserve(images.size());
+    for (const Image& image : images)
+        sizes.push_back(image.image.size() + QSize(2 * border, 2 * border));
+
+    std::vector<QPoint> positions;
+    const QSize atlasSize = RectPacker::findAtlasSize(sizes, 0, _onlyPOT, positions);
+    if (atlasSize.isEmpty()) return "Failed to pack images";
+
+    report(QString("Packed %1 images into %2 x %3").arg(images.size()).arg(atlasSize.width()).arg(atlasSize.height()));
+
+    QImage atlas(atlasSize, QImage::Format_ARGB32);
+    atlas.fill(Qt::transparent);
+    {
+        QPainter painter(&atlas);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (size_t i = 0; i < images.size(); ++i)
+        {
+            const QImage& image = images[i].image;
+            const QPoint pos = positions[i] + QPoint(border, border);
+            if (_padding)
+            {
+                // Repeat edge rows, columns and corner pixels in the border
+                const int w = image.width();
+                const int h = image.height();
+                const int l = pos.x() - 1;
+                const int t = pos.y() - 1;
+                const int r = pos.x() + w;
+                const int b = pos.y() + h;
+                painter.drawImage(QPoint(pos.x(), t), image, QRect(0, 0, w, 1));
+                painter.drawImage(QPoint(pos.x(), b), image, QRect(0, h - 1, w, 1));
+                painter.drawImage(QPoint(l, pos.y()), image, QRect(0, 0, 1, h));
+                painter.drawImage(QPoint(r, pos.y()), image, QRect(w - 1, 0, 1, h));
+                painter.drawImage(QPoint(l, t), image, QRect(0, 0, 1, 1));
+                painter.drawImage(QPoint(r, t), image, QRect(w - 1, 0, 1, 1));
+                painter.drawImage(QPoint(l, b), image, QRect(0, h - 1, 1, 1));
+                painter.drawImage(QPoint(r, b), image, QRect(w - 1, h - 1, 1, 1));
+            }
+            painter.drawImage(pos, image);
+        }
+    }
+
+    const QDir outputDir = QFileInfo(_filePath).dir();
+    const QString imageFileName = QFileInfo(_output).completeBaseName() + ".png";
+    _outputImagePath = outputDir.absoluteFilePath(QFileInfo(_output).path() + '/' + imageFileName);
+    _outputImagesetPath = outputDir.absoluteFilePath(_output);
+
+    // Outputs replace previous ones only when completely written
+    QSaveFile imageFile(_outputImagePath);
+    if (!imageFile.open(QIODevice::WriteOnly) || !atlas.save(&imageFile, "PNG") || !imageFile.commit())
+        return QString("Failed to save '%1'").arg(_outputImagePath);
+
+    QDomDocument doc;
+    doc.appendChild(doc.createProcessingInstruction("xml", "version=\"1.0\" encoding=\"UTF-8\""));
+    auto root = doc.createElement("Imageset");
+    root.setAttribute("version", "2");
+    root.setAttribute("name", _name);
+    root.setAttribute("imagefile", imageFileName);
+    root.setAttribute("nativeHorzRes", _nativeHorzRes);
+    root.setAttribute("nativeVertRes", _nativeVertRes);
+    root.setAttribute("autoScaled", _autoScaled ? "true" : "false");
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        auto element = doc.createElement("Image");
+        element.setAttribute("name", images[i].name);
+        element.setAttribute("xPos", positions[i].x() + border);
+        element.setAttribute("yPos", positions[i].y() + border);
+        element.setAttribute("width", images[i].image.width());
+        element.setAttribute("height", images[i].image.height());
+        element.setAttribute("xOffset", images[i].xOffset);
+        element.setAttribute("yOffset", images[i].yOffset);
+        root.appendChild(element);
+    }
+    doc.appendChild(root);
+
+    QByteArray outputData;
+    const QString error = ImagesetCompatibility::transform(doc.toByteArray(4), ImagesetCompatibility::getNativeType(), _outputTargetType, outputData);
+    if (!error.isEmpty()) return error;
+
+    QSaveFile outputFile(_outputImagesetPath);
+    if (!outputFile.open(QIODevice::WriteOnly) || outputFile.write(outputData) != outputData.size() || !outputFile.commit())
+        return QString("Failed to save '%1'").arg(_outputImagesetPath);
+
+    report(QString("Saved '%1' and '%2'").arg(_outputImagesetPath, _outputImagePath));
+    return QString();
+}
@@ -0,0 +1,58 @@
+#ifndef METAIMAGESETCOMPILER_H
+#define METAIMAGESETCOMPILER_H
+
+#include "qimage.h"
+#include "qstringlist.h"
+#include <functional>
+#include <vector>
+
+// Compiles a meta-imageset, a description of images gathered from other imagesets and bitmap files,
+// into a single imageset with its underlying atlas image. Inputs are loaded in parallel, then packed
+// with RectPacker. Each image is padded by a 1 pixel border of its edge pixels, so that filtering
+// doesn't bleed neighbours into it.
+
+class MetaImagesetCompiler
+{
+public:
+
+    struct Image
+    {
+        QString name;
+        QImage image;
+        int xOffset = 0;
+        int yOffset = 0;
+    };
+
+    struct Input
+    {
+        QString type;  // 'Imageset' or 'Bitmap'
+        QString path;  // Relative to the meta-imageset, bitmap paths may contain wildcards
+        int xOffset = 0;
+        int yOffset = 0;
+    };
+
+    // Returns an error message or an empty string on success
+    QString load(const QString& filePath);
+    QString compile(const std::function<void(const QString&)>& log = nullptr);
+
+    const QString& getOutputImagesetPath() const { return _outputImagesetPath; }
+    const QString& getOutputImagePath() const { return _outputImagePath; }
+
+protected:
+
+    QString _filePath;
+    QString _name;
+    int _nativeHorzRes = 800;
+    int _nativeVertRes = 600;
+    bool _autoScaled = false;
+    bool _onlyPOT = false;
+    bool _padding = true;
+    QString _output;
+    QString _outputTargetType;
+    std::vector<Input> _inputs;
+
+    QString _outputImagesetPath;
+    QString _outputImagePath;
+};
+
+#endif // METAIMAGESETCOMPILER_H
@@ -0,0 +1,163 @@
+#include "src/cegui/ProjectAnalyzer.h"
+#include "qfileinfo.h"
+#include "qfile.h"
+#include "qtextstream.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <algorithm>
+
+static constexpr size_t ChunkSize = 1024;
+
+// Widget types registered by CEGUI itself, layouts use them without any scheme mapping
+static const QStringList BuiltinWidgetTypes =
+{
+    "DefaultWindow", "DragContainer", "ScrolledContainer", "ClippedContainer",
+    "HorizontalLayoutContainer", "VerticalLayoutContainer", "GridLayoutContainer"
+};
+
+// Resource files loaded only when something references them
+static const QStringList DependentFileSuffixes = { "imageset", "font", "looknfeel" };
+
+namespace
+{
+
+struct AnalysisJob
+{
+    const ProjectSymbolIndex* index;
+    ProjectSymbolIndex::SymbolType type;
+    std::vector<const ProjectSymbolIndex::SymbolMap::value_type*> symbols;
+    std::vector<const ProjectSymbolIndex::FileSymbols*> files;
+};
+
+}
+
+// Runs in a worker thread. The index is not modified while the caller is blocked.
+static std::vector<ProjectAnalyzer::Issue> analyzeChunk(const AnalysisJob& job)
+{
+    using SymbolType = ProjectSymbolIndex::SymbolType;
+    using IssueKind = ProjectAnalyzer::IssueKind;
+
+    std::vector<ProjectAnalyzer::Issue> issues;
+
+    const QString typeName = ProjectSymbolIndex::getTypeName(job.type);
+    for (const auto* pair : job.symbols)
+    {
+        const auto& symbol = pair->second;
+        if (symbol.usages.empty() && !symbol.definitions.empty())
+        {
+            // Imagesets are referenced by file name, their usage is reported per image and per file
+            if (job.type == SymbolType::Imageset) continue;
+
+            const auto& location = symbol.definitions.front();
+            issues.push_back({ IssueKind::Unused, typeName, pair->first, location.filePath, location.line,
+                               static_cast<int>(symbol.definitions.size()) });
+        }
+        else if (symbol.definitions.empty() && !symbol.usages.empty())
+        {
+            if (job.type == SymbolType::WidgetType && BuiltinWidgetTypes.contains(pair->first)) continue;
+
+            const auto& location = symbol.usages.front();
+            issues.push_back({ IssueKind::Missing, typeName, pair->first, location.filePath, location.line,
+                               static_cast<int>(symbol.usages.size()) });
+        }
+    }
+
+    for (const auto* file : job.files)
+    {
+        for (const auto& reference : file->references)
+            if (!reference.filePath.isEmpty() && !QFileInfo::exists(reference.filePath))
+                issues.push_back({ IssueKind::MissingFile, "File", reference.fileName, file->filePath, reference.line, 1 });
+
+        if (DependentFileSuffixes.contains(QFileInfo(file->filePath).suffix(), Qt::CaseInsensitive) &&
+                job.index->getDependents(file->filePath).empty())
+        {
+            issues.push_back({ IssueKind::UnusedFile, "File", QFileInfo(file->filePath).fileName(), file->filePath, 0, 0 });
+        }
+    }
+
+    return issues;
+}
+
+QString ProjectAnalyzer::getKindName(IssueKind kind)
+{
+    switch (kind)
+    {
+        case IssueKind::Unused: return "Unused";
+        case IssueKind::Missing: return "Missing";
+        case IssueKind::MissingFile: return "Missing file";
+        case IssueKind::UnusedFile: return "Unreferenced file";
+        default: return QString();
+    }
+}
+
+// Blocks until done, the index must be ready
+std::vector<ProjectAnalyzer::Issue> ProjectAnalyzer::analyze(const ProjectSymbolIndex& index)
+{
+    QVector<AnalysisJob> jobs;
+
+    for (int i = 0; i < static_cast<int>(ProjectSymbolIndex::SymbolType::Count); ++i)
+    {
+        const auto type = static_cast<ProjectSymbolIndex::SymbolType>(i);
+        AnalysisJob job { &index, type, {}, {} };
+        for (const auto& pair : index.getAllSymbols(type))
+        {
+            job.symbols.push_back(&pair);
+            if (job.symbols.size() == ChunkSize)
+            {
+                jobs.push_back(std::move(job));
+                job = AnalysisJob { &index, type, {}, {} };
+            }
+        }
+        if (!job.symbols.empty()) jobs.push_back(std::move(job));
+    }
+
+    AnalysisJob fileJob { &index, ProjectSymbolIndex::SymbolType::Count, {}, {} };
+    for (const auto& pair : index.getFiles())
+    {
+        fileJob.files.push_back(&pair.second);
+        if (fileJob.files.size() == ChunkSize)
+        {
+            jobs.push_back(std::move(fileJob));
+            fileJob = AnalysisJob { &index, ProjectSymbolIndex::SymbolType::Count, {}, {} };
+        }
+    }
+    if (!fileJob.files.empty()) jobs.push_back(std::move(fileJob));
+
+    const auto chunks = QtConcurrent::blockingMapped<QVector<std::vector<Issue>>>(jobs, analyzeChunk);
+
+    std::vector<Issue> issues;
+    for (const auto& chunk : chunks)
+        issues.insert(issues.end(), chunk.begin(), chunk.end());
+
+    std::sort(issues.begin(), issues.end(), [](const Issue& a, const Issue& b)
+    {
+        if (a.kind != b.kind) return a.kind < b.kind;
+        if (a.typeName != b.typeName) return a.typeName < b.typeName;
+        if (a.name != b.name) return a.name < b.name;
+        return a.filePath < b.filePath;
+    });
+
+    return issues;
+}
+
+bool ProjectAnalyzer::exportToCsv(const QString& filePath, const std::vector<Issue>& issues, const std::function<QString(const QString&)>& displayPath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
+
+    auto quote = [](QString value)
+    {
+        return '"' + value.replace('"', "\"\"") + '"';
+    };
+
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    stream << "Issue,Type,Name,File,Line,Count\n";
+    for (const Issue& issue : issues)
+    {
+        stream << quote(getKindName(issue.kind)) << ',' << quote(issue.typeName) << ',' << quote(issue.name) << ','
+               << quote(displayPath(issue.filePath)) << ',' << issue.line << ',' << issue.count << '\n';
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
@@ -0,0 +1,42 @@
+#ifndef PROJECTANALYZER_H
+#define PROJECTANALYZER_H
+
+#include "src/cegui/ProjectSymbolIndex.h"
+#include <functional>
+
+// Finds unreferenced and dangling resources of the project using the project symbol index:
+// images, fonts, looks and widget types defined but never used, names used but defined nowhere,
+// references to missing files and resource files nothing depends on. Symbols and files are
+// checked in chunks on the global thread pool.
+
+class ProjectAnalyzer
+{
+public:
+
+    enum class IssueKind
+    {
+        Unused,      // Symbol is defined but not used in project files
+        Missing,     // Symbol is used but not defined
+        MissingFile, // Referenced file doesn't exist
+        UnusedFile,  // Resource file nothing depends on
+
+        Count
+    };
+
+    struct Issue
+    {
+        IssueKind kind;
+        QString typeName;
+        QString name;
+        QString filePath;
+        int line = 0;
+        int count = 0;  // Number of definitions for unused and of usages for missing symbols
+    };
+
+    static QString getKindName(IssueKind kind);
+
+    static std::vector<Issue> analyze(const ProjectSymbolIndex& index);
+    static bool exportToCsv(const QString& filePath, const std::vector<Issue>& issues, const std::function<QString(const QString&)>& displayPath);
+};
+
+#endif // PROJECTANALYZER_H
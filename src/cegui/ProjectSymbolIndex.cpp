@@ -0,0 +1,634 @@
+#include "src/cegui/ProjectSymbolIndex.h"
+#include "src/cegui/CEGUIProject.h"
+#include "src/util/FileWatcher.h"
+#include "src/Application.h"
+#include "qdiriterator.h"
+#include "qfileinfo.h"
+#include "qdir.h"
+#include "qfile.h"
+#include "qtimer.h"
+#include "qxmlstream.h"
+#include "qfuturewatcher.h"
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <unordered_set>
+#include <set>
+#include <algorithm>
+
+static constexpr int RescanDelayMs = 50;
+
+namespace
+{
+
+struct Listing
+{
+    std::vector<ProjectSymbolIndex::FileSymbols> files; // Without entries, only stamps
+    QStringList dirs;
+};
+
+}
+
+static void addEntry(ProjectSymbolIndex::FileSymbols& file, ProjectSymbolIndex::SymbolType type, bool definition,
+                     const QString& name, const QXmlStreamReader& reader)
+{
+    if (!name.isEmpty())
+        file.entries.push_back({ type, definition, name, static_cast<int>(reader.lineNumber()) });
+}
+
+static void addReference(ProjectSymbolIndex::FileSymbols& file, const QString& fileName, const QString& resourceGroup,
+                         const QString& defaultResourceGroup, const QXmlStreamReader& reader,
+                         ProjectSymbolIndex::SymbolType usedType = ProjectSymbolIndex::SymbolType::Count)
+{
+    if (!fileName.isEmpty())
+        file.references.push_back({ fileName, resourceGroup.isEmpty() ? defaultResourceGroup : resourceGroup,
+                                    static_cast<int>(reader.lineNumber()), QString(), usedType });
+}
+
+// Property values are stored either in the 'value' attribute or, for long ones, in the element text
+static void parseProperty(QXmlStreamReader& reader, ProjectSymbolIndex::FileSymbols& file)
+{
+    const auto attrs = reader.attributes();
+    const int line = static_cast<int>(reader.lineNumber());
+
+    ProjectSymbolIndex::SymbolType type;
+    if (!ProjectSymbolIndex::getPropertySymbolType(attrs.value("name").toString(), QString(), type)) return;
+
+    const QString value = attrs.hasAttribute("value") ?
+                attrs.value("value").toString() :
+                reader.readElementText(QXmlStreamReader::SkipChildElements);
+
+    if (!value.trimmed().isEmpty())
+        file.entries.push_back({ type, false, value.trimmed(), line });
+}
+
+// Runs in a worker thread
+static ProjectSymbolIndex::FileSymbols scanFile(const ProjectSymbolIndex::FileSymbols& stamp)
+{
+    using SymbolType = ProjectSymbolIndex::SymbolType;
+
+    ProjectSymbolIndex::FileSymbols result = stamp;
+
+    QFile file(stamp.filePath);
+    if (!file.open(QIODevice::ReadOnly)) return result;
+
+    QXmlStreamReader reader(&file);
+    QString root;
+    QString imagesetName;
+    std::vector<const ProjectSymbolIndex::AttributeForm*> forms;
+    bool hasProperties = false;
+    while (!reader.atEnd())
+    {
+        if (reader.readNext() != QXmlStreamReader::StartElement) continue;
+
+        const auto element = reader.name();
+        const auto attrs = reader.attributes();
+        if (root.isEmpty())
+        {
+            root = element.toString();
+            for (const auto& form : ProjectSymbolIndex::getAttributeForms())
+                if (form.roots.contains(root))
+                    forms.push_back(&form);
+            hasProperties = ProjectSymbolIndex::getPropertyRoots().contains(root);
+
+            // Not a file we index (e.g. animations), don't read the rest of it
+            if (forms.empty()) break;
+        }
+
+        for (const auto form : forms)
+            if (element == form->element)
+                addEntry(result, form->type, form->definition, attrs.value(form->attribute).toString(), reader);
+
+        if (root == "Imageset")
+        {
+            // Images are defined by names without the imageset prefix
+            if (element == "Imageset")
+            {
+                imagesetName = attrs.value("name").toString();
+                addReference(result, attrs.value("imagefile").toString(), attrs.value("resourceGroup").toString(), "imagesets", reader);
+            }
+            else if (element == "Image" && !imagesetName.isEmpty())
+            {
+                addEntry(result, SymbolType::Image, true, imagesetName + '/' + attrs.value("name").toString(), reader);
+            }
+        }
+        else if (root == "Font" || root == "Fonts")
+        {
+            if (element == "Font")
+                addReference(result, attrs.value("filename").toString(), attrs.value("resourceGroup").toString(), "fonts", reader);
+        }
+        else if (root == "GUIScheme")
+        {
+            // Without an explicit name, the scheme uses whatever the referenced file defines
+            if (element == "Imageset" || element == "ImagesetFromImage")
+            {
+                addReference(result, attrs.value("filename").toString(), attrs.value("resourceGroup").toString(), "imagesets", reader,
+                             attrs.hasAttribute("name") ? SymbolType::Count : SymbolType::Imageset);
+            }
+            else if (element == "Font")
+            {
+                addReference(result, attrs.value("filename").toString(), attrs.value("resourceGroup").toString(), "fonts", reader,
+                             attrs.hasAttribute("name") ? SymbolType::Count : SymbolType::Font);
+            }
+            else if (element == "LookNFeel")
+            {
+                addReference(result, attrs.value("filename").toString(), attrs.value("resourceGroup").toString(), "looknfeels", reader);
+            }
+        }
+
+        if (hasProperties)
+        {
+            if (element == "Property")
+            {
+                parseProperty(reader, result);
+            }
+            else if (element == "PropertyDefinition" || element == "PropertyLinkDefinition")
+            {
+                SymbolType type;
+                if (ProjectSymbolIndex::getPropertySymbolType(attrs.value("name").toString(), attrs.value("type").toString(), type))
+                    addEntry(result, type, false, attrs.value("initialValue").toString().trimmed(), reader);
+            }
+        }
+    }
+
+    return result;
+}
+
+QString ProjectSymbolIndex::getTypeName(SymbolType type)
+{
+    switch (type)
+    {
+        case SymbolType::Imageset: return "Imageset";
+        case SymbolType::Image: return "Image";
+        case SymbolType::Font: return "Font";
+        case SymbolType::WidgetLook: return "Widget look";
+        case SymbolType::WidgetType: return "Widget type";
+        default: return QString();
+    }
+}
+
+const std::vector<ProjectSymbolIndex::AttributeForm>& ProjectSymbolIndex::getAttributeForms()
+{
+    static const QStringList imagesets = { "Imageset" };
+    static const QStringList fonts = { "Font", "Fonts" };
+    static const QStringList schemes = { "GUIScheme" };
+    static const QStringList looks = { "Falagard", "GUILayout" };
+
+    // Image definitions in imagesets are prefixed with the imageset name and handled separately
+    static const std::vector<AttributeForm> forms =
+    {
+        { imagesets, "Imageset", "name", SymbolType::Imageset, true },
+        { fonts, "Font", "name", SymbolType::Font, true },
+        { schemes, "FalagardMapping", "windowType", SymbolType::WidgetType, true },
+        { schemes, "FalagardMapping", "lookNFeel", SymbolType::WidgetLook, false },
+        { schemes, "Imageset", "name", SymbolType::Imageset, false },
+        { schemes, "ImagesetFromImage", "name", SymbolType::Imageset, false },
+        { schemes, "Font", "name", SymbolType::Font, false },
+        { looks, "WidgetLook", "name", SymbolType::WidgetLook, true },
+        { looks, "WidgetLook", "inherits", SymbolType::WidgetLook, false },
+        { looks, "Image", "name", SymbolType::Image, false },
+        { looks, "Text", "font", SymbolType::Font, false },
+        { looks, "Child", "type", SymbolType::WidgetType, false },
+        { looks, "Child", "look", SymbolType::WidgetLook, false },
+        { looks, "Window", "type", SymbolType::WidgetType, false },
+    };
+
+    return forms;
+}
+
+// Roots of files where 'Property' values and 'PropertyDefinition' initial values may name symbols
+const QStringList& ProjectSymbolIndex::getPropertyRoots()
+{
+    static const QStringList roots = { "Falagard", "GUILayout" };
+    return roots;
+}
+
+// Property definitions may declare the type of the value, otherwise it is guessed by the property name
+bool ProjectSymbolIndex::getPropertySymbolType(const QString& propertyName, const QString& valueType, SymbolType& outType)
+{
+    if (valueType == "Image" || (valueType.isEmpty() && propertyName.endsWith("Image")))
+        outType = SymbolType::Image;
+    else if (valueType == "Font" || (valueType.isEmpty() && propertyName == "Font"))
+        outType = SymbolType::Font;
+    else if (valueType.isEmpty() && propertyName == "LookNFeel")
+        outType = SymbolType::WidgetLook;
+    else
+        return false;
+
+    return true;
+}
+
+ProjectSymbolIndex::ProjectSymbolIndex(const CEGUIProject& project, QObject* parent)
+    : QObject(parent)
+    , _project(project)
+{
+    _rescanTimer = new QTimer(this);
+    _rescanTimer->setSingleShot(true);
+    _rescanTimer->setInterval(RescanDelayMs);
+    connect(_rescanTimer, &QTimer::timeout, this, &ProjectSymbolIndex::rescan);
+
+    // Notifications are already debounced and filtered by contents
+    _fileWatcher = qobject_cast<Application*>(qApp)->getFileWatcher();
+    // Files are watched by somebody else, we don't spend a watch and a hash on each of them
+    connect(_fileWatcher, &FileWatcher::fileChanged, this, [this](const QString& filePath, bool external)
+    {
+        if (_files.find(filePath) == _files.end()) return;
+        if (!external) _savedFiles.insert(filePath);
+        _rescanTimer->start();
+    });
+    connect(_fileWatcher, &FileWatcher::fileRemoved, this, [this](const QString& filePath)
+    {
+        if (_files.find(filePath) != _files.end()) _rescanTimer->start();
+    });
+    connect(_fileWatcher, &FileWatcher::directoryChanged, this, [this](const QString& dirPath)
+    {
+        if (_watchedDirs.find(dirPath) != _watchedDirs.end()) _rescanTimer->start();
+    });
+}
+
+ProjectSymbolIndex::~ProjectSymbolIndex()
+{
+    if (!_fileWatcher) return;
+
+    for (const QString& dir : _watchedDirs)
+        _fileWatcher->unwatchDirectory(dir);
+}
+
+// Must be called when project resource paths change, files already indexed are parsed again only if changed
+void ProjectSymbolIndex::rebuild()
+{
+    // References are resolved through resource directories, which might have changed
+    _referencedBy.clear();
+    for (auto& pair : _files)
+        resolveReferences(pair.second);
+    updateReferenceUsages();
+
+    _rescanTimer->stop();
+    rescan();
+}
+
+void ProjectSymbolIndex::rescan()
+{
+    QStringList dirs;
+    for (const QString& resourceGroup : { "imagesets", "fonts", "looknfeels", "schemes", "layouts" })
+    {
+        const QString dir = QDir::cleanPath(_project.getResourceFilePath("", resourceGroup));
+        if (!dirs.contains(dir)) dirs.push_back(dir);
+    }
+
+    const int generation = ++_generation;
+
+    auto watcher = new QFutureWatcher<Listing>(this);
+    connect(watcher, &QFutureWatcher<Listing>::finished, this, [this, watcher, generation]()
+    {
+        const Listing listing = watcher->result();
+        onFilesListed(generation, listing.files, listing.dirs);
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run([dirs]()
+    {
+        static const QStringList suffixes = { "imageset", "font", "scheme", "looknfeel", "layout" };
+
+        Listing listing;
+        std::unordered_set<QString> visitedFiles;
+        for (const QString& dir : dirs)
+        {
+            if (!QFileInfo(dir).isDir()) continue;
+
+            listing.dirs.push_back(dir);
+            QDirIterator it(dir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+            while (it.hasNext())
+            {
+                it.next();
+                const QFileInfo info = it.fileInfo();
+                if (info.isDir())
+                {
+                    listing.dirs.push_back(info.absoluteFilePath());
+                }
+                else if (suffixes.contains(info.suffix(), Qt::CaseInsensitive))
+                {
+                    // Resource groups may share a directory or be nested
+                    if (!visitedFiles.insert(info.absoluteFilePath()).second) continue;
+
+                    ProjectSymbolIndex::FileSymbols file;
+                    file.filePath = info.absoluteFilePath();
+                    file.modified = info.lastModified();
+                    file.size = info.size();
+                    listing.files.push_back(std::move(file));
+                }
+            }
+        }
+
+        listing.dirs.removeDuplicates();
+        return listing;
+    }));
+}
+
+void ProjectSymbolIndex::onFilesListed(int generation, const std::vector<FileSymbols>& files, const QStringList& dirs)
+{
+    if (generation != _generation) return;
+
+    std::unordered_set<QString> listedPaths;
+    for (const FileSymbols& file : files)
+        listedPaths.insert(file.filePath);
+
+    if (_fileWatcher)
+    {
+        std::unordered_set<QString> dirsToAdd(dirs.begin(), dirs.end());
+        QStringList dirsToRemove;
+        for (const QString& path : _watchedDirs)
+            if (dirsToAdd.erase(path) == 0)
+                dirsToRemove.push_back(path);
+
+        for (const QString& path : dirsToRemove)
+        {
+            _watchedDirs.erase(path);
+            _fileWatcher->unwatchDirectory(path);
+        }
+        for (const QString& path : dirsToAdd)
+        {
+            _watchedDirs.insert(path);
+            _fileWatcher->watchDirectory(path);
+        }
+    }
+
+    std::vector<QString> removedPaths;
+    for (const auto& pair : _files)
+        if (listedPaths.find(pair.first) == listedPaths.end())
+            removedPaths.push_back(pair.first);
+    for (const QString& path : removedPaths)
+        removeFile(path);
+
+    QVector<FileSymbols> jobs;
+    QStringList modifiedPaths;
+    for (const FileSymbols& file : files)
+    {
+        auto it = _files.find(file.filePath);
+        if (it == _files.end())
+        {
+            jobs.push_back(file);
+        }
+        else if (it->second.modified != file.modified || it->second.size != file.size)
+        {
+            jobs.push_back(file);
+            if (_savedFiles.erase(file.filePath) == 0) modifiedPaths.push_back(file.filePath);
+        }
+    }
+
+    if (jobs.empty())
+    {
+        if (!removedPaths.empty()) updateReferenceUsages();
+
+        const bool wasReady = _ready;
+        _ready = true;
+        if (!removedPaths.empty() || !wasReady) emit indexChanged();
+        return;
+    }
+
+    auto watcher = new QFutureWatcher<FileSymbols>(this);
+    connect(watcher, &QFutureWatcher<FileSymbols>::finished, this, [this, watcher, generation, modifiedPaths]()
+    {
+        if (generation == _generation)
+        {
+            for (FileSymbols& file : watcher->future().results())
+            {
+                removeFile(file.filePath);
+                addFile(std::move(file));
+            }
+            updateReferenceUsages();
+
+            _ready = true;
+            emit indexChanged();
+            if (!modifiedPaths.empty()) emit filesModified(modifiedPaths);
+        }
+
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::mapped(jobs, scanFile));
+}
+
+void ProjectSymbolIndex::addFile(FileSymbols&& file)
+{
+    for (const Entry& entry : file.entries)
+    {
+        Symbol& symbol = getSymbols(entry.type)[entry.name];
+        if (entry.definition)
+        {
+            symbol.definitions.push_back({ file.filePath, entry.line });
+            _namesValid[static_cast<size_t>(entry.type)] = false;
+        }
+        else
+        {
+            symbol.usages.push_back({ file.filePath, entry.line });
+        }
+    }
+
+    resolveReferences(file);
+
+    const QString filePath = file.filePath;
+    _files[filePath] = std::move(file);
+}
+
+void ProjectSymbolIndex::resolveReferences(FileSymbols& file)
+{
+    for (FileReference& reference : file.references)
+    {
+        reference.filePath = QDir::cleanPath(_project.getResourceFilePath(reference.fileName, reference.resourceGroup));
+        if (!reference.filePath.isEmpty()) _referencedBy[reference.filePath].push_back(file.filePath);
+    }
+}
+
+// A file referenced by name (e.g. an imageset listed in a scheme) counts as a usage of symbols it defines.
+// These usages are recomputed after each change, the referenced file may be scanned later than the referencing one.
+void ProjectSymbolIndex::updateReferenceUsages()
+{
+    for (const auto& usage : _referenceUsages)
+    {
+        const Entry& entry = usage.first;
+        auto& symbols = getSymbols(entry.type);
+        auto it = symbols.find(entry.name);
+        if (it == symbols.end()) continue;
+
+        auto& usages = it->second.usages;
+        auto locationIt = std::find_if(usages.begin(), usages.end(), [&usage](const Location& location)
+        {
+            return location.line == usage.first.line && location.filePath == usage.second;
+        });
+        if (locationIt != usages.end()) usages.erase(locationIt);
+
+        if (it->second.definitions.empty() && it->second.usages.empty()) symbols.erase(it);
+    }
+
+    _referenceUsages.clear();
+
+    for (const auto& pair : _files)
+    {
+        for (const FileReference& reference : pair.second.references)
+        {
+            if (reference.usedType == SymbolType::Count) continue;
+
+            auto targetIt = _files.find(reference.filePath);
+            if (targetIt == _files.end()) continue;
+
+            for (const Entry& targetEntry : targetIt->second.entries)
+            {
+                if (!targetEntry.definition || targetEntry.type != reference.usedType) continue;
+
+                getSymbols(targetEntry.type)[targetEntry.name].usages.push_back({ pair.first, reference.line });
+                _referenceUsages.push_back({ { targetEntry.type, false, targetEntry.name, reference.line }, pair.first });
+            }
+        }
+    }
+}
+
+void ProjectSymbolIndex::removeFile(const QString& filePath)
+{
+    auto fileIt = _files.find(filePath);
+    if (fileIt == _files.end()) return;
+
+    auto isInFile = [&filePath](const Location& location) { return location.filePath == filePath; };
+
+    for (const Entry& entry : fileIt->second.entries)
+    {
+        auto& symbols = getSymbols(entry.type);
+        auto it = symbols.find(entry.name);
+        if (it == symbols.end()) continue;
+
+        auto& locations = entry.definition ? it->second.definitions : it->second.usages;
+        locations.erase(std::remove_if(locations.begin(), locations.end(), isInFile), locations.end());
+
+        if (entry.definition) _namesValid[static_cast<size_t>(entry.type)] = false;
+        if (it->second.definitions.empty() && it->second.usages.empty()) symbols.erase(it);
+    }
+
+    for (const FileReference& reference : fileIt->second.references)
+    {
+        auto it = _referencedBy.find(reference.filePath);
+        if (it == _referencedBy.end()) continue;
+
+        auto& sources = it->second;
+        sources.erase(std::remove(sources.begin(), sources.end(), filePath), sources.end());
+        if (sources.empty()) _referencedBy.erase(it);
+    }
+
+    _files.erase(fileIt);
+}
+
+// Returns sorted names of symbols defined in the project. The list is cached until definitions change.
+const QStringList& ProjectSymbolIndex::getNames(SymbolType type) const
+{
+    const size_t typeIndex = static_cast<size_t>(type);
+    if (!_namesValid[typeIndex])
+    {
+        QStringList& names = _names[typeIndex];
+        names.clear();
+        for (const auto& pair : getSymbols(type))
+            if (!pair.second.definitions.empty())
+                names.push_back(pair.first);
+        _namesValid[typeIndex] = true;
+    }
+
+    return _names[typeIndex];
+}
+
+const ProjectSymbolIndex::Symbol* ProjectSymbolIndex::getSymbol(SymbolType type, const QString& name) const
+{
+    const auto& symbols = getSymbols(type);
+    auto it = symbols.find(name);
+    return (it == symbols.end()) ? nullptr : &it->second;
+}
+
+// Returns sorted paths of all indexed files and files referenced by them
+QStringList ProjectSymbolIndex::getFilePaths() const
+{
+    std::set<QString> paths;
+    for (const auto& pair : _files)
+        paths.insert(pair.first);
+    for (const auto& pair : _referencedBy)
+        paths.insert(pair.first);
+
+    QStringList result;
+    for (const QString& path : paths)
+        result.push_back(path);
+    return result;
+}
+
+// Files defining symbols used by the file and files it references by name
+QStringList ProjectSymbolIndex::getDependencies(const QString& filePath) const
+{
+    auto fileIt = _files.find(filePath);
+    if (fileIt == _files.end()) return {};
+
+    std::set<QString> paths;
+    for (const Entry& entry : fileIt->second.entries)
+    {
+        if (entry.definition) continue;
+        if (auto symbol = getSymbol(entry.type, entry.name))
+            for (const Location& location : symbol->definitions)
+                paths.insert(location.filePath);
+    }
+
+    for (const FileReference& reference : fileIt->second.references)
+        if (!reference.filePath.isEmpty())
+            paths.insert(reference.filePath);
+
+    paths.erase(filePath);
+
+    QStringList result;
+    for (const QString& path : paths)
+        result.push_back(path);
+    return result;
+}
+
+// Files using symbols defined in the file and files referencing it by name
+QStringList ProjectSymbolIndex::getDependents(const QString& filePath) const
+{
+    std::set<QString> paths;
+
+    auto fileIt = _files.find(filePath);
+    if (fileIt != _files.end())
+    {
+        for (const Entry& entry : fileIt->second.entries)
+        {
+            if (!entry.definition) continue;
+            if (auto symbol = getSymbol(entry.type, entry.name))
+                for (const Location& location : symbol->usages)
+                    paths.insert(location.filePath);
+        }
+    }
+
+    auto refIt = _referencedBy.find(filePath);
+    if (refIt != _referencedBy.end())
+        paths.insert(refIt->second.begin(), refIt->second.end());
+
+    paths.erase(filePath);
+
+    QStringList result;
+    for (const QString& path : paths)
+        result.push_back(path);
+    return result;
+}
+
+// Everything that may need reloading or validation when the file changes, i.e. transitive dependents
+QStringList ProjectSymbolIndex::getAffectedFiles(const QString& filePath) const
+{
+    std::set<QString> visited { filePath };
+    std::vector<QString> queue { filePath };
+    while (!queue.empty())
+    {
+        const QString current = std::move(queue.back());
+        queue.pop_back();
+
+        for (const QString& dependent : getDependents(current))
+            if (visited.insert(dependent).second)
+                queue.push_back(dependent);
+    }
+
+    visited.erase(filePath);
+
+    QStringList result;
+    for (const QString& path : visited)
+        result.push_back(path);
+    return result;
+}
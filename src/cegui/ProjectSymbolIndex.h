@@ -0,0 +1,150 @@
+#ifndef PROJECTSYMBOLINDEX_H
+#define PROJECTSYMBOLINDEX_H
+
+#include "qobject.h"
+#include "qdatetime.h"
+#include "qstringlist.h"
+#include "qpointer.h"
+#include "src/QtStdHash.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <map>
+#include <vector>
+
+// Maps named CEGUI resources (images, fonts, looks, widget types) of the project to files and lines
+// where they are defined and used. All files under the project resource directories are parsed
+// with a streaming XML reader in parallel. Only directories are watched, they report added, removed and
+// replaced files. Files rewritten in place are reported by editors having them open. After a change only
+// files with a different modification time or size are parsed again.
+// Files also form a dependency graph: a file depends on files defining symbols it uses and on files
+// it references by name (scheme -> imagesets, fonts and looknfeels, imageset -> texture, font -> font source).
+// Attributes and properties naming symbols are described by one table shared with SymbolRenamer.
+
+class CEGUIProject;
+class FileWatcher;
+class QTimer;
+
+class ProjectSymbolIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    enum class SymbolType
+    {
+        Imageset,
+        Image,      // 'Imageset/Image'
+        Font,
+        WidgetLook, // Falagard WidgetLook from a looknfeel file
+        WidgetType, // Falagard mapping from a scheme, 'Skin/Widget'
+
+        Count
+    };
+
+    // An attribute naming a symbol in files with one of the given root elements
+    struct AttributeForm
+    {
+        QStringList roots;
+        QString element;
+        QString attribute;
+        SymbolType type;
+        bool definition;
+    };
+
+    struct Location
+    {
+        QString filePath;
+        int line = 0;
+    };
+
+    struct Symbol
+    {
+        std::vector<Location> definitions;
+        std::vector<Location> usages;
+    };
+
+    struct Entry
+    {
+        SymbolType type;
+        bool definition;
+        QString name;
+        int line;
+    };
+
+    struct FileReference
+    {
+        QString fileName;
+        QString resourceGroup;
+        int line;
+        QString filePath; // Absolute, resolved in the main thread
+        SymbolType usedType; // Symbols of this type defined in the referenced file are used, Count for none
+    };
+
+    struct FileSymbols
+    {
+        QString filePath;
+        QDateTime modified;
+        qint64 size = 0;
+        std::vector<Entry> entries;
+        std::vector<FileReference> references;
+    };
+
+    typedef std::map<QString, Symbol> SymbolMap;
+    typedef std::unordered_map<QString, FileSymbols> FileMap;
+
+    static QString getTypeName(SymbolType type);
+    static const std::vector<AttributeForm>& getAttributeForms();
+    static const QStringList& getPropertyRoots();
+    static bool getPropertySymbolType(const QString& propertyName, const QString& valueType, SymbolType& outType);
+
+    ProjectSymbolIndex(const CEGUIProject& project, QObject* parent = nullptr);
+    virtual ~ProjectSymbolIndex() override;
+
+    void rebuild();
+
+    bool isReady() const { return _ready; }
+    const QStringList& getNames(SymbolType type) const;
+    const Symbol* getSymbol(SymbolType type, const QString& name) const;
+    const SymbolMap& getAllSymbols(SymbolType type) const { return getSymbols(type); }
+    const FileMap& getFiles() const { return _files; }
+
+    QStringList getFilePaths() const;
+    QStringList getDependencies(const QString& filePath) const;
+    QStringList getDependents(const QString& filePath) const;
+    QStringList getAffectedFiles(const QString& filePath) const;
+
+signals:
+
+    void indexChanged();
+    void filesModified(const QStringList& filePaths); // Indexed files changed on disk not by our editors
+
+protected:
+
+    void rescan();
+    void onFilesListed(int generation, const std::vector<FileSymbols>& files, const QStringList& dirs);
+    void addFile(FileSymbols&& file);
+    void removeFile(const QString& filePath);
+    void resolveReferences(FileSymbols& file);
+    void updateReferenceUsages();
+
+    SymbolMap& getSymbols(SymbolType type) { return _symbols[static_cast<size_t>(type)]; }
+    const SymbolMap& getSymbols(SymbolType type) const { return _symbols[static_cast<size_t>(type)]; }
+
+    const CEGUIProject& _project;
+    QPointer<FileWatcher> _fileWatcher; // The application one, may be destroyed first on exit
+    QTimer* _rescanTimer = nullptr; // Notifications of several files come together, rescan once
+    std::unordered_set<QString> _watchedDirs;
+    std::unordered_set<QString> _savedFiles; // Changed by our editors, not reported as modified
+
+    FileMap _files;
+    std::unordered_map<QString, std::vector<QString>> _referencedBy; // Reverse file references, target -> sources
+    std::vector<std::pair<Entry, QString>> _referenceUsages; // Usages added for file references, with their files
+    SymbolMap _symbols[static_cast<size_t>(SymbolType::Count)];
+    mutable QStringList _names[static_cast<size_t>(SymbolType::Count)];
+    mutable bool _namesValid[static_cast<size_t>(SymbolType::Count)] = {};
+
+    int _generation = 0; // Results of scans started before the last rescan() are dropped
+    bool _ready = false;
+};
+
+#endif // PROJECTSYMBOLINDEX_H
@@ -0,0 +1,348 @@
+#include "src/cegui/SymbolRenamer.h"
+#include "qfile.h"
+#include "qsavefile.h"
+#include "qregularexpression.h"
+#include "qxmlstream.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <set>
+#include <memory>
+
+// A start tag of the element, quoted attribute values may contain '>'
+static const QString TagPattern = "<%1(?=[\\s/>])(?:[^>\"']|\"[^\"]*\"|'[^']*')*>";
+
+namespace
+{
+
+struct RenameJob
+{
+    QString filePath;
+    ProjectSymbolIndex::SymbolType type;
+    QString oldName;
+    QString newName;
+    bool definesSymbol;
+};
+
+}
+
+// Names are compared and written in their escaped form, as they appear in the file
+static QString escapeXml(const QString& value)
+{
+    return value.toHtmlEscaped();
+}
+
+static QString getAttribute(const QString& tag, const QString& attribute)
+{
+    const QRegularExpression regex("\\b" + attribute + "\\s*=\\s*([\"'])(.*?)\\1");
+    return regex.match(tag).captured(2);
+}
+
+static bool hasAttribute(const QString& tag, const QString& attribute)
+{
+    return QRegularExpression("\\b" + attribute + "\\s*=").match(tag).hasMatch();
+}
+
+static int replaceAttribute(QString& tag, const QString& attribute, const QString& oldValue, const QString& newValue)
+{
+    const QRegularExpression regex("(\\b" + attribute + "\\s*=\\s*)([\"'])" + QRegularExpression::escape(oldValue) + "\\2");
+    const int count = tag.count(regex);
+    if (count) tag.replace(regex, "\\1\\2" + QString(newValue).replace('\\', "\\\\") + "\\2");
+    return count;
+}
+
+static QString getRootElement(const QString& text)
+{
+    QXmlStreamReader reader(text);
+    while (!reader.atEnd())
+        if (reader.readNext() == QXmlStreamReader::StartElement)
+            return reader.name().toString();
+    return QString();
+}
+
+// Calls 'rewrite' for each start tag of the element, the tag may be modified in place
+static int rewriteTags(QString& text, const QString& element, const std::function<int(QString&)>& rewrite)
+{
+    const QRegularExpression regex(TagPattern.arg(element));
+
+    QString result;
+    int count = 0;
+    int last = 0;
+    auto it = regex.globalMatch(text);
+    while (it.hasNext())
+    {
+        const auto match = it.next();
+        QString tag = match.captured(0);
+        count += rewrite(tag);
+        result += text.midRef(last, match.capturedStart() - last);
+        result += tag;
+        last = match.capturedEnd();
+    }
+
+    if (!count) return 0;
+
+    result += text.midRef(last);
+    text = std::move(result);
+    return count;
+}
+
+// Property values are stored either in the 'value' attribute or, for long ones, in the element text
+static int rewriteProperties(QString& text, const std::function<bool(const QString&)>& isMatchingProperty,
+                             const QString& oldValue, const QString& newValue)
+{
+    const QRegularExpression regex(TagPattern.arg("Property"));
+    const QString closingTag = "</Property>";
+
+    QString result;
+    int count = 0;
+    int last = 0;
+    auto it = regex.globalMatch(text);
+    while (it.hasNext())
+    {
+        const auto match = it.next();
+        QString tag = match.captured(0);
+        if (!isMatchingProperty(getAttribute(tag, "name"))) continue;
+
+        if (hasAttribute(tag, "value"))
+        {
+            const int tagCount = replaceAttribute(tag, "value", oldValue, newValue);
+            if (!tagCount) continue;
+
+            count += tagCount;
+            result += text.midRef(last, match.capturedStart() - last);
+            result += tag;
+            last = match.capturedEnd();
+        }
+        else if (!tag.endsWith("/>"))
+        {
+            const int valueEnd = text.indexOf(closingTag, match.capturedEnd());
+            if (valueEnd < 0) continue;
+
+            const int valueStart = match.capturedEnd();
+            const QString value = text.mid(valueStart, valueEnd - valueStart);
+            if (value.trimmed() != oldValue) continue;
+
+            // Keep whitespace around the value
+            ++count;
+            result += text.midRef(last, valueStart - last);
+            result += QString(value).replace(value.trimmed(), newValue);
+            last = valueEnd;
+        }
+    }
+
+    if (!count) return 0;
+
+    result += text.midRef(last);
+    text = std::move(result);
+    return count;
+}
+
+// Runs in a worker thread. Uses the same forms of references as ProjectSymbolIndex parsing.
+static SymbolRenamer::FileChange rewriteFile(const RenameJob& job)
+{
+    using SymbolType = ProjectSymbolIndex::SymbolType;
+
+    SymbolRenamer::FileChange change;
+    change.filePath = job.filePath;
+
+    QFile file(job.filePath);
+    if (!file.open(QIODevice::ReadOnly)) return change;
+    change.oldContents = QString::fromUtf8(file.readAll());
+
+    QString text = change.oldContents;
+    const QString root = getRootElement(text);
+    const QString oldName = escapeXml(job.oldName);
+    const QString newName = escapeXml(job.newName);
+
+    int count = 0;
+
+    // Imagesets define images by the name without the imageset prefix
+    if (job.type == SymbolType::Image && job.definesSymbol && root == "Imageset")
+    {
+        const QString oldShortName = escapeXml(job.oldName.mid(job.oldName.indexOf('/') + 1));
+        const QString newShortName = escapeXml(job.newName.mid(job.newName.indexOf('/') + 1));
+        count += rewriteTags(text, "Image", [&oldShortName, &newShortName](QString& tag)
+        {
+            return replaceAttribute(tag, "name", oldShortName, newShortName);
+        });
+    }
+
+    for (const auto& form : ProjectSymbolIndex::getAttributeForms())
+    {
+        if (form.type != job.type || !form.roots.contains(root)) continue;
+
+        const QString attribute = form.attribute;
+        count += rewriteTags(text, form.element, [&attribute, &oldName, &newName](QString& tag)
+        {
+            return replaceAttribute(tag, attribute, oldName, newName);
+        });
+    }
+
+    if (ProjectSymbolIndex::getPropertyRoots().contains(root))
+    {
+        const SymbolType type = job.type;
+        count += rewriteProperties(text, [type](const QString& name)
+        {
+            SymbolType propertyType;
+            return ProjectSymbolIndex::getPropertySymbolType(name, QString(), propertyType) && propertyType == type;
+        }, oldName, newName);
+
+        for (const QString& element : { "PropertyDefinition", "PropertyLinkDefinition" })
+        {
+            count += rewriteTags(text, element, [type, &oldName, &newName](QString& tag)
+            {
+                SymbolType propertyType;
+                if (!ProjectSymbolIndex::getPropertySymbolType(getAttribute(tag, "name"), getAttribute(tag, "type"), propertyType) ||
+                        propertyType != type)
+                    return 0;
+                return replaceAttribute(tag, "initialValue", oldName, newName);
+            });
+        }
+    }
+
+    change.replacements = count;
+    if (count) change.newContents = std::move(text);
+    return change;
+}
+
+// Renaming an imageset would require rewriting all its images, use image renaming for that
+bool SymbolRenamer::canRename(ProjectSymbolIndex::SymbolType type)
+{
+    return type == ProjectSymbolIndex::SymbolType::Image ||
+            type == ProjectSymbolIndex::SymbolType::Font ||
+            type == ProjectSymbolIndex::SymbolType::WidgetLook ||
+            type == ProjectSymbolIndex::SymbolType::WidgetType;
+}
+
+SymbolRenamer::SymbolRenamer(const ProjectSymbolIndex& index, ProjectSymbolIndex::SymbolType type, const QString& oldName, const QString& newName)
+    : _index(index)
+    , _type(type)
+    , _oldName(oldName)
+    , _newName(newName.trimmed())
+{
+}
+
+// Returns an error message or an empty string if the rename is possible
+QString SymbolRenamer::validate() const
+{
+    if (!canRename(_type))
+        return QString("Renaming of %1 is not supported").arg(ProjectSymbolIndex::getTypeName(_type).toLower());
+    if (!_index.isReady())
+        return "The project is not indexed yet";
+    if (!_index.getSymbol(_type, _oldName))
+        return QString("'%1' is not found in the project").arg(_oldName);
+    if (_newName.isEmpty())
+        return "The new name is empty";
+    if (_newName == _oldName)
+        return "The new name is the same as the old one";
+
+    if (_type == ProjectSymbolIndex::SymbolType::Image)
+    {
+        const QString prefix = _oldName.left(_oldName.indexOf('/') + 1);
+        if (!_newName.startsWith(prefix) || _newName.size() == prefix.size() || _newName.indexOf('/', prefix.size()) >= 0)
+            return QString("The new image name must be in the same imageset, like '%1Name'").arg(prefix);
+    }
+
+    auto existing = _index.getSymbol(_type, _newName);
+    if (existing && !existing->definitions.empty())
+        return QString("'%1' already exists in the project").arg(_newName);
+
+    return QString();
+}
+
+// Computes new contents of all files referencing the symbol
+void SymbolRenamer::prepare()
+{
+    _changes.clear();
+
+    auto symbol = _index.getSymbol(_type, _oldName);
+    if (!symbol) return;
+
+    std::set<QString> definitionFiles;
+    for (const auto& location : symbol->definitions)
+        definitionFiles.insert(location.filePath);
+
+    std::set<QString> allFiles = definitionFiles;
+    for (const auto& location : symbol->usages)
+        allFiles.insert(location.filePath);
+
+    QVector<RenameJob> jobs;
+    for (const QString& filePath : allFiles)
+        jobs.push_back({ filePath, _type, _oldName, _newName, definitionFiles.find(filePath) != definitionFiles.end() });
+
+    const QVector<FileChange> changes = QtConcurrent::blockingMapped<QVector<FileChange>>(jobs, rewriteFile);
+    for (const FileChange& change : changes)
+        if (change.replacements > 0)
+            _changes.push_back(change);
+}
+
+int SymbolRenamer::getReplacementCount() const
+{
+    int count = 0;
+    for (const FileChange& change : _changes)
+        count += change.replacements;
+    return count;
+}
+
+// Changed lines of every file, replacements never add or remove lines
+QString SymbolRenamer::getDiff(const std::function<QString(const QString&)>& displayPath) const
+{
+    QString diff;
+    for (const FileChange& change : _changes)
+    {
+        diff += QString("=== %1 (%2 changes)\n").arg(displayPath(change.filePath)).arg(change.replacements);
+
+        const auto oldLines = change.oldContents.splitRef('\n');
+        const auto newLines = change.newContents.splitRef('\n');
+        for (int i = 0; i < std::min(oldLines.size(), newLines.size()); ++i)
+        {
+            if (oldLines[i] == newLines[i]) continue;
+
+            diff += QString("@@ line %1\n").arg(i + 1);
+            diff += "- " + oldLines[i].trimmed() + '\n';
+            diff += "+ " + newLines[i].trimmed() + '\n';
+        }
+
+        diff += '\n';
+    }
+
+    return diff;
+}
+
+// Returns an error message or an empty string on success. All files are written through QSaveFile,
+// so an original is never missing, and none is replaced until all new contents are written.
+// If replacing some file fails, already replaced ones are restored.
+QString SymbolRenamer::apply()
+{
+    for (const FileChange& change : _changes)
+    {
+        QFile file(change.filePath);
+        if (!file.open(QIODevice::ReadOnly) || QString::fromUtf8(file.readAll()) != change.oldContents)
+            return QString("'%1' was modified after the preview, nothing was renamed").arg(change.filePath);
+    }
+
+    // Uncommitted files are discarded when destroyed
+    std::vector<std::unique_ptr<QSaveFile>> files;
+    for (const FileChange& change : _changes)
+    {
+        auto file = std::make_unique<QSaveFile>(change.filePath);
+        const QByteArray data = change.newContents.toUtf8();
+        if (!file->open(QIODevice::WriteOnly) || file->write(data) != data.size())
+            return QString("Failed to write '%1', nothing was renamed").arg(change.filePath);
+        files.push_back(std::move(file));
+    }
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        if (files[i]->commit()) continue;
+
+        for (size_t j = 0; j < i; ++j)
+        {
+            QSaveFile file(_changes[j].filePath);
+            const QByteArray data = _changes[j].oldContents.toUtf8();
+            if (file.open(QIODevice::WriteOnly) && file.write(data) == data.size()) file.commit();
+        }
+
+        return QString("Failed to replace '%1', nothing was renamed").arg(_changes[i].filePath);
+    }
+
+    return QString();
+}
@@ -0,0 +1,47 @@
+#ifndef SYMBOLRENAMER_H
+#define SYMBOLRENAMER_H
+
+#include "src/cegui/ProjectSymbolIndex.h"
+#include <functional>
+
+// Renames a project resource (image, font, widget look or widget type) in every file that defines
+// or uses it, as found by the project symbol index. Only attributes and property values of the
+// kind being renamed are touched, as described by the reference forms of the index, so that e.g.
+// renaming a look doesn't rename the widget type of the same name. New contents of all files are
+// prepared in parallel and can be previewed. Applying replaces either all files or none of them.
+
+class SymbolRenamer
+{
+public:
+
+    struct FileChange
+    {
+        QString filePath;
+        QString oldContents;
+        QString newContents;
+        int replacements = 0;
+    };
+
+    static bool canRename(ProjectSymbolIndex::SymbolType type);
+
+    SymbolRenamer(const ProjectSymbolIndex& index, ProjectSymbolIndex::SymbolType type, const QString& oldName, const QString& newName);
+
+    QString validate() const;
+    void prepare();
+    QString apply();
+
+    const std::vector<FileChange>& getChanges() const { return _changes; }
+    int getReplacementCount() const;
+    QString getDiff(const std::function<QString(const QString&)>& displayPath) const;
+
+protected:
+
+    const ProjectSymbolIndex& _index;
+    ProjectSymbolIndex::SymbolType _type;
+    QString _oldName;
+    QString _newName;
+
+    std::vector<FileChange> _changes;
+};
+
+#endif // SYMBOLRENAMER_H
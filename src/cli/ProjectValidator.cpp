@@ -0,0 +1,233 @@
+#include "src/cli/ProjectValidator.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qdir.h"
+#include "qdom.h"
+#include "qdiriterator.h"
+#include "qxmlstream.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <algorithm>
+
+static const QStringList CEGUIVersions = { "0.6", "0.7", "0.8", "1.0" };
+
+namespace
+{
+
+struct DataKind
+{
+    const char* suffix;
+    const char* resourceGroup;
+    const char* rootElement;
+    const char* versions[4]; // Value of the 'version' attribute for each of CEGUIVersions, null when there must be none
+};
+
+struct ValidationJob
+{
+    const ProjectValidator* validator;
+    QString filePath;
+};
+
+}
+
+static const DataKind DataKinds[] =
+{
+    { "imageset", "imagesets", "Imageset", { nullptr, nullptr, "2", "2" } },
+    { "font", "fonts", "Font", { nullptr, nullptr, "3", "4" } },
+    { "looknfeel", "looknfeels", "Falagard", { nullptr, nullptr, "7", "7" } },
+    { "scheme", "schemes", "GUIScheme", { nullptr, nullptr, "5", "5" } },
+    { "layout", "layouts", "GUILayout", { nullptr, nullptr, "4", "4" } }
+};
+
+static const DataKind* findDataKind(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    for (const DataKind& kind : DataKinds)
+        if (suffix == kind.suffix) return &kind;
+    return nullptr;
+}
+
+// Attribute names were capitalized before CEGUI 0.8
+static QString getAttribute(const QXmlStreamAttributes& attrs, const QString& name)
+{
+    if (attrs.hasAttribute(name)) return attrs.value(name).toString();
+    return attrs.value(name.left(1).toUpper() + name.mid(1)).toString();
+}
+
+// Runs in a worker thread
+static std::vector<ProjectValidator::Message> validateFile(const ValidationJob& job)
+{
+    std::vector<ProjectValidator::Message> messages;
+    auto report = [&messages, &job](int line, bool error, const QString& text)
+    {
+        messages.push_back({ job.filePath, line, error, text });
+    };
+
+    const DataKind* kind = findDataKind(job.filePath);
+    if (!kind) return messages;
+
+    QFile file(job.filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        report(0, true, "Can't open the file");
+        return messages;
+    }
+
+    const int versionIndex = CEGUIVersions.indexOf(job.validator->getCEGUIVersion());
+
+    // Referenced file name and its resource group by the element name
+    auto checkReference = [&](const QXmlStreamReader& xml, const QString& attribute, const QString& defaultGroup)
+    {
+        const QString fileName = getAttribute(xml.attributes(), attribute);
+        if (fileName.isEmpty()) return;
+
+        QString group = getAttribute(xml.attributes(), "resourceGroup");
+        if (group.isEmpty()) group = defaultGroup;
+
+        const QString dir = job.validator->getResourceDirectory(group);
+        if (dir.isEmpty())
+            report(static_cast<int>(xml.lineNumber()), false, QString("Unknown resource group '%1'").arg(group));
+        else if (!QFileInfo::exists(QDir(dir).filePath(fileName)))
+            report(static_cast<int>(xml.lineNumber()), true, QString("Referenced file '%1' doesn't exist").arg(fileName));
+    };
+
+    QXmlStreamReader xml(&file);
+    bool isRoot = true;
+    while (!xml.atEnd())
+    {
+        if (xml.readNext() != QXmlStreamReader::StartElement) continue;
+
+        const auto name = xml.name();
+        const int line = static_cast<int>(xml.lineNumber());
+
+        if (isRoot)
+        {
+            isRoot = false;
+            if (name != QLatin1String(kind->rootElement))
+            {
+                report(line, true, QString("The root element is '%1' instead of '%2'").arg(name.toString(), kind->rootElement));
+                return messages;
+            }
+
+            if (versionIndex >= 0)
+            {
+                const auto version = xml.attributes().value("version");
+                const char* expected = kind->versions[versionIndex];
+                if (expected ? (version != QLatin1String(expected)) : !version.isNull())
+                {
+                    report(line, true, QString("Data version '%1' doesn't match CEGUI %2, expected '%3'")
+                           .arg(version.isNull() ? "none" : version.toString(), job.validator->getCEGUIVersion(), expected ? expected : "none"));
+                }
+            }
+
+            if (name == QLatin1String("Imageset"))
+                checkReference(xml, "imagefile", "imagesets");
+            else if (name == QLatin1String("Font"))
+                checkReference(xml, "filename", "fonts");
+
+            continue;
+        }
+
+        if (qstrcmp(kind->rootElement, "GUIScheme") == 0)
+        {
+            if (name == QLatin1String("Imageset") || name == QLatin1String("ImagesetFromImage"))
+                checkReference(xml, "filename", "imagesets");
+            else if (name == QLatin1String("Font"))
+                checkReference(xml, "filename", "fonts");
+            else if (name == QLatin1String("LookNFeel"))
+                checkReference(xml, "filename", "looknfeels");
+        }
+        else if (qstrcmp(kind->rootElement, "GUILayout") == 0 && name == QLatin1String("LayoutImport"))
+        {
+            checkReference(xml, "filename", "layouts");
+        }
+    }
+
+    if (xml.hasError())
+        report(static_cast<int>(xml.lineNumber()), true, xml.errorString());
+    else if (isRoot)
+        report(0, true, "The file is empty");
+
+    return messages;
+}
+
+QString ProjectValidator::loadProject(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return QString("Can't open '%1'").arg(filePath);
+
+    QDomDocument doc;
+    QString parseError;
+    int errorLine = 0;
+    if (!doc.setContent(&file, &parseError, &errorLine))
+        return QString("%1:%2: %3").arg(filePath).arg(errorLine).arg(parseError);
+
+    // The same attributes and defaults as CEGUIProject::loadFromFile
+    const auto xmlRoot = doc.documentElement();
+    _ceguiVersion = xmlRoot.attribute("CEGUIVersion", "1.0");
+    _baseDirectory = QFileInfo(filePath).absoluteDir().absoluteFilePath(xmlRoot.attribute("baseDirectory", "./"));
+    _imagesetsPath = xmlRoot.attribute("imagesetsPath", "./imagesets");
+    _fontsPath = xmlRoot.attribute("fontsPath", "./fonts");
+    _looknfeelsPath = xmlRoot.attribute("looknfeelsPath", "./looknfeel");
+    _schemesPath = xmlRoot.attribute("schemesPath", "./schemes");
+    _layoutsPath = xmlRoot.attribute("layoutsPath", "./layouts");
+
+    if (!CEGUIVersions.contains(_ceguiVersion))
+        return QString("Unknown CEGUI version '%1' in '%2'").arg(_ceguiVersion, filePath);
+
+    return QString();
+}
+
+QString ProjectValidator::getResourceDirectory(const QString& resourceGroup) const
+{
+    QString folder;
+    if (resourceGroup == "imagesets")
+        folder = _imagesetsPath;
+    else if (resourceGroup == "fonts")
+        folder = _fontsPath;
+    else if (resourceGroup == "looknfeels")
+        folder = _looknfeelsPath;
+    else if (resourceGroup == "schemes")
+        folder = _schemesPath;
+    else if (resourceGroup == "layouts")
+        folder = _layoutsPath;
+    else
+        return QString();
+
+    return QDir::cleanPath(QDir(_baseDirectory).absoluteFilePath(folder));
+}
+
+// All data files in resource directories, each file once even if directories overlap
+QStringList ProjectValidator::getFiles() const
+{
+    QStringList nameFilters;
+    for (const DataKind& kind : DataKinds)
+        nameFilters.push_back(QString("*.") + kind.suffix);
+
+    QStringList filePaths;
+    for (const DataKind& kind : DataKinds)
+    {
+        const QString dir = getResourceDirectory(kind.resourceGroup);
+        QDirIterator it(dir, nameFilters, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            filePaths.push_back(QDir::cleanPath(it.next()));
+    }
+
+    filePaths.removeDuplicates();
+    filePaths.sort();
+    return filePaths;
+}
+
+std::vector<ProjectValidator::Message> ProjectValidator::validate(const QStringList& filePaths) const
+{
+    QVector<ValidationJob> jobs;
+    for (const QString& filePath : filePaths)
+        jobs.push_back({ this, filePath });
+
+    const auto results = QtConcurrent::blockingMapped<QVector<std::vector<Message>>>(jobs, validateFile);
+
+    // Results come in the order of files
+    std::vector<Message> messages;
+    for (const auto& fileMessages : results)
+        messages.insert(messages.end(), fileMessages.begin(), fileMessages.end());
+    return messages;
+}
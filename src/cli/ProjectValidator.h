@@ -0,0 +1,43 @@
+#ifndef PROJECTVALIDATOR_H
+#define PROJECTVALIDATOR_H
+
+#include "qstringlist.h"
+#include <vector>
+
+// Validates CEGUI data files of a .project without CEGUI: every file must be well formed XML
+// with the root element and data version expected by the project CEGUI version, and all files
+// it references by name must exist. Files are checked in parallel on the global thread pool.
+
+class ProjectValidator
+{
+public:
+
+    struct Message
+    {
+        QString filePath;
+        int line = 0;
+        bool error = true;
+        QString text;
+    };
+
+    // Returns an error message or an empty string on success
+    QString loadProject(const QString& filePath);
+
+    const QString& getCEGUIVersion() const { return _ceguiVersion; }
+    QString getResourceDirectory(const QString& resourceGroup) const;
+    QStringList getFiles() const;
+
+    std::vector<Message> validate(const QStringList& filePaths) const;
+
+protected:
+
+    QString _ceguiVersion;
+    QString _baseDirectory;
+    QString _imagesetsPath;
+    QString _fontsPath;
+    QString _looknfeelsPath;
+    QString _schemesPath;
+    QString _layoutsPath;
+};
+
+#endif // PROJECTVALIDATOR_H
@@ -0,0 +1,253 @@
+#include "src/cli/ProjectValidator.h"
+#include "src/cegui/ImagesetCompatibility.h"
+#include "src/cegui/MetaImagesetCompiler.h"
+#include "qguiapplication.h"
+#include "qcommandlineparser.h"
+#include "qthreadpool.h"
+#include "qfile.h"
+#include "qsavefile.h"
+#include "qfileinfo.h"
+#include "qdir.h"
+#include "qtextstream.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+
+// Headless batch tool for asset pipelines. Works without a display and without CEGUI.
+//
+//   ceed-cli validate <file.project>
+//   ceed-cli convert (--to <data type> | --cegui-version <version>) [--output-dir <dir>] <files...>
+//   ceed-cli compile-metaimageset <files...>
+
+enum ExitCode
+{
+    Success = 0,
+    Failure = 1,    // Invalid data or a failed operation
+    UsageError = 2
+};
+
+namespace
+{
+
+struct ConversionJob
+{
+    QString filePath;
+    QString outputPath;
+    QString targetType;
+};
+
+}
+
+static QTextStream& out()
+{
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static QTextStream& err()
+{
+    static QTextStream stream(stderr);
+    return stream;
+}
+
+static int runValidate(const QStringList& args, bool quiet)
+{
+    if (args.size() != 1)
+    {
+        err() << "validate: exactly one .project file is expected" << '\n';
+        return UsageError;
+    }
+
+    ProjectValidator validator;
+    const QString error = validator.loadProject(args[0]);
+    if (!error.isEmpty())
+    {
+        err() << error << '\n';
+        return Failure;
+    }
+
+    const QStringList filePaths = validator.getFiles();
+    const auto messages = validator.validate(filePaths);
+
+    int errorCount = 0;
+    for (const auto& message : messages)
+    {
+        if (message.error) ++errorCount;
+        if (!message.error && quiet) continue;
+
+        err() << QDir::toNativeSeparators(message.filePath);
+        if (message.line > 0) err() << ':' << message.line;
+        err() << (message.error ? ": error: " : ": warning: ") << message.text << '\n';
+    }
+
+    if (!quiet)
+        out() << QString("%1 files checked for CEGUI %2, %3 errors, %4 warnings")
+                 .arg(filePaths.size()).arg(validator.getCEGUIVersion()).arg(errorCount).arg(messages.size() - errorCount) << '\n';
+
+    return errorCount ? Failure : Success;
+}
+
+// Runs in a worker thread, returns an error message
+static QString convertFile(const ConversionJob& job)
+{
+    QFile file(job.filePath);
+    if (!file.open(QIODevice::ReadOnly)) return QString("%1: can't open the file").arg(job.filePath);
+    const QByteArray data = file.readAll();
+    file.close();
+
+    const QString sourceType = ImagesetCompatibility::detectType(data);
+    if (sourceType.isEmpty()) return QString("%1: not a known imageset data type").arg(job.filePath);
+
+    QByteArray outData;
+    const QString error = ImagesetCompatibility::transform(data, sourceType, job.targetType, outData);
+    if (!error.isEmpty()) return QString("%1: %2").arg(job.filePath, error);
+
+    // Files are converted in place by default, a failed write must not destroy the source
+    QSaveFile outFile(job.outputPath);
+    if (!outFile.open(QIODevice::WriteOnly) || outFile.write(outData) != outData.size() || !outFile.commit())
+        return QString("%1: can't write the file").arg(job.outputPath);
+
+    return QString();
+}
+
+static int runConvert(const QStringList& args, const QString& targetType, const QString& ceguiVersion, const QString& outputDir, bool quiet)
+{
+    if (args.empty())
+    {
+        err() << "convert: no files to convert" << '\n';
+        return UsageError;
+    }
+
+    QString type = targetType;
+    if (type.isEmpty() && !ceguiVersion.isEmpty())
+        type = ImagesetCompatibility::getTypeForCEGUIVersion(ceguiVersion);
+    if (!ImagesetCompatibility::getTypes().contains(type))
+    {
+        err() << "convert: specify --to as one of '" << ImagesetCompatibility::getTypes().join("', '")
+              << "' or a known --cegui-version" << '\n';
+        return UsageError;
+    }
+
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir))
+    {
+        err() << "convert: can't create the output directory " << outputDir << '\n';
+        return Failure;
+    }
+
+    QVector<ConversionJob> jobs;
+    for (const QString& filePath : args)
+    {
+        if (QFileInfo(filePath).suffix().toLower() != "imageset")
+        {
+            err() << filePath << ": only imagesets can be converted by this version" << '\n';
+            return UsageError;
+        }
+
+        const QString outputPath = outputDir.isEmpty() ? filePath : QDir(outputDir).filePath(QFileInfo(filePath).fileName());
+        jobs.push_back({ filePath, outputPath, type });
+    }
+
+    const QStringList errors = QtConcurrent::blockingMapped<QStringList>(jobs, convertFile);
+
+    int errorCount = 0;
+    for (const QString& error : errors)
+    {
+        if (error.isEmpty()) continue;
+        err() << error << '\n';
+        ++errorCount;
+    }
+
+    if (!quiet)
+        out() << QString("%1 of %2 files converted to '%3'").arg(jobs.size() - errorCount).arg(jobs.size()).arg(type) << '\n';
+
+    return errorCount ? Failure : Success;
+}
+
+// Meta-imagesets are compiled one by one, inputs of each are loaded in parallel
+static int runCompileMetaImageset(const QStringList& args, bool quiet)
+{
+    if (args.empty())
+    {
+        err() << "compile-metaimageset: no meta-imagesets to compile" << '\n';
+        return UsageError;
+    }
+
+    int errorCount = 0;
+    for (const QString& filePath : args)
+    {
+        MetaImagesetCompiler compiler;
+        QString error = compiler.load(filePath);
+        if (error.isEmpty())
+            error = compiler.compile([quiet](const QString& message)
+            {
+                if (quiet) return;
+                out() << message << '\n';
+                out().flush();
+            });
+
+        if (!error.isEmpty())
+        {
+            err() << filePath << ": " << error << '\n';
+            ++errorCount;
+        }
+    }
+
+    return errorCount ? Failure : Success;
+}
+
+int main(int argc, char *argv[])
+{
+    // Nothing is shown, don't require a display on build machines
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ceed-cli");
+    QCoreApplication::setApplicationVersion(APP_VERSION);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("CEGUI unified editor (CEED) batch tool");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("command", "validate, convert or compile-metaimageset");
+    parser.addPositionalArgument("files", "Input files of the command", "<files...>");
+
+    QCommandLineOption jobsOption({ "j", "jobs" }, "Number of worker threads, all cores by default.", "count");
+    QCommandLineOption quietOption({ "q", "quiet" }, "Print only errors.");
+    QCommandLineOption toOption("to", "convert: target data type, e.g. 'CEGUI imageset 1'.", "type");
+    QCommandLineOption ceguiVersionOption("cegui-version", "convert: target CEGUI version, e.g. 0.7.", "version");
+    QCommandLineOption outputDirOption({ "o", "output-dir" }, "convert: write results here instead of replacing inputs.", "dir");
+    parser.addOptions({ jobsOption, quietOption, toOption, ceguiVersionOption, outputDirOption });
+
+    parser.process(app);
+
+    if (parser.isSet(jobsOption))
+    {
+        bool ok = false;
+        const int jobs = parser.value(jobsOption).toInt(&ok);
+        if (!ok || jobs < 1)
+        {
+            err() << "Invalid number of jobs: " << parser.value(jobsOption) << '\n';
+            return UsageError;
+        }
+        QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+    }
+
+    QStringList args = parser.positionalArguments();
+    if (args.empty())
+    {
+        err() << parser.helpText();
+        return UsageError;
+    }
+
+    const QString command = args.takeFirst();
+    const bool quiet = parser.isSet(quietOption);
+
+    if (command == "validate")
+        return runValidate(args, quiet);
+    if (command == "convert")
+        return runConvert(args, parser.value(toOption), parser.value(ceguiVersionOption), parser.value(outputDirOption), quiet);
+    if (command == "compile-metaimageset")
+        return runCompileMetaImageset(args, quiet);
+
+    err() << "Unknown command '" << command << "'" << '\n';
+    return UsageError;
+}
@@ -89,21 +89,28 @@ bool CodeEditMode::propagateToVisual()
 }
 
 void CodeEditMode::setCodeWithoutUndoHistory(const QString& code)
+{
+    setCodeWithoutUndoHistory(code, UndoData());
+}
+
+// Undo commands pass their stored data to avoid compressing the same text again
+void CodeEditMode::setCodeWithoutUndoHistory(const QString& code, const UndoData& codeData)
 {
     ignoreUndoCommands = true;
     setPlainText(code);
     ignoreUndoCommands = false;
+
+    lastUndoData = codeData.isEmpty() ? UndoData(_editor.getUndoDataStore(), document()->toPlainText().toUtf8()) : codeData;
 }
 
 void CodeEditMode::slot_contentsChange(int /*position*/, int charsRemoved, int charsAdded)
 {
-    if (!ignoreUndoCommands)
-    {
-        int totalChange = charsRemoved + charsAdded;
-        _editor.getUndoStack()->push(new CodeEditModeCommand(*this, lastUndoText, toPlainText(), totalChange));
-    }
+    if (ignoreUndoCommands) return;
 
-    lastUndoText = document()->toPlainText();
+    const int totalChange = charsRemoved + charsAdded;
+    UndoData newData(_editor.getUndoDataStore(), toPlainText().toUtf8());
+    _editor.getUndoStack()->push(new CodeEditModeCommand(*this, lastUndoData, newData, totalChange));
+    lastUndoData = std::move(newData);
 }
 
 //---------------------------------------------------------------------
@@ -144,7 +151,7 @@ bool ViewRestoringCodeEditMode::propagateToVisual()
 
 //---------------------------------------------------------------------
 
-CodeEditModeCommand::CodeEditModeCommand(CodeEditMode& owner, const QString& oldText, const QString& newText, int totalChange)
+CodeEditModeCommand::CodeEditModeCommand(CodeEditMode& owner, const UndoData& oldText, const UndoData& newText, int totalChange)
     : _owner(owner)
     , _oldText(oldText)
     , _newText(newText)
@@ -156,13 +163,13 @@ CodeEditModeCommand::CodeEditModeCommand(CodeEditMode& owner, const QString& old
 void CodeEditModeCommand::undo()
 {
     QUndoCommand::undo();
-    _owner.setCodeWithoutUndoHistory(_oldText);
+    _owner.setCodeWithoutUndoHistory(QString::fromUtf8(_oldText.get()), _oldText);
 }
 
 void CodeEditModeCommand::redo()
 {
     if (!_dryRun)
-        _owner.setCodeWithoutUndoHistory(_newText);
+        _owner.setCodeWithoutUndoHistory(QString::fromUtf8(_newText.get()), _newText);
 
     _dryRun = false;
 
@@ -194,6 +201,12 @@ bool CodeEditModeCommand::mergeWith(const QUndoCommand* other)
     return false;
 }
 
+// The old text is shared with the new text of the previous command, don't count it twice
+size_t CodeEditModeCommand::getMemoryFootprint() const
+{
+    return sizeof(CodeEditModeCommand) + _newText.getMemoryFootprint();
+}
+
 void CodeEditModeCommand::refreshText()
 {
     if (_totalChange == 1)
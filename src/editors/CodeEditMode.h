@@ -2,6 +2,7 @@
 #define CODEEDITMODE_H
 
 #include "src/editors/MultiModeEditor.h"
+#include "src/util/UndoData.h"
 #include "qtextedit.h"
 
 // This is the most used alternative editing mode that allows you to edit raw code.
@@ -28,6 +29,7 @@ public:
     virtual void refreshFromVisual();
     virtual bool propagateToVisual();
     void setCodeWithoutUndoHistory(const QString& code);
+    void setCodeWithoutUndoHistory(const QString& code, const UndoData& codeData);
 
 protected slots:
 
@@ -36,7 +38,7 @@ protected slots:
 protected:
 
     bool ignoreUndoCommands = false;
-    QString lastUndoText;
+    UndoData lastUndoData; // Shared by the last command as its new text and the next one as its old text
 };
 
 class ViewRestoringCodeEditMode : public CodeEditMode
@@ -56,26 +58,27 @@ protected:
 };
 
 // Undo command for code edit mode.
-// TODO: Extremely memory hungry implementation for now, I have to figure out how to use my own
-// QUndoStack with QTextDocument in the future to fix this.
-class CodeEditModeCommand : public QUndoCommand
+// TODO: Whole texts are stored, compressed and spilled to disk by the undo data store. I have to figure out
+// how to use my own QUndoStack with QTextDocument in the future to fix this.
+class CodeEditModeCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
-    CodeEditModeCommand(CodeEditMode& owner, const QString& oldText, const QString& newText, int totalChange);
+    CodeEditModeCommand(CodeEditMode& owner, const UndoData& oldText, const UndoData& newText, int totalChange);
 
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override;
     virtual bool mergeWith(const QUndoCommand* other) override;
+    virtual size_t getMemoryFootprint() const override;
 
     void refreshText();
 
 protected:
 
     CodeEditMode& _owner;
-    QString _oldText;
-    QString _newText;
+    UndoData _oldText; // UTF-8
+    UndoData _newText;
     int _totalChange;
     bool _dryRun = true;
 };
@@ -1,15 +1,28 @@
 #include "src/editors/EditorBase.h"
 #include "src/Application.h"
 #include "src/util/Settings.h"
+#include "src/util/SettingsEntry.h"
+#include "src/util/UndoData.h"
+#include "src/util/RecoveryJournal.h"
+#include "src/util/FileWatcher.h"
+#include "src/util/FileWriter.h"
 #include "src/cegui/CEGUIManager.h"
 #include "src/cegui/CEGUIProject.h"
 #include "qdir.h"
 #include "qmenu.h"
 #include "qmessagebox.h"
-#include "qfilesystemwatcher.h"
 #include "qundostack.h"
+#include "qtimer.h"
+#include "qfuturewatcher.h"
 #include <qfiledialog.h>
 
+// Serializing a document blocks the UI, so snapshots are taken only after the user pauses editing
+static constexpr qint64 RecoveryIdleDelayMs = 2000;
+
+// Each this much serialized data multiplies the snapshot interval, up to the limit
+static constexpr int RecoverySnapshotSizeStep = 1024 * 1024;
+static constexpr int MaxRecoveryIntervalMultiplier = 10;
+
 // Constructs the editor.
 // compatibilityManager - manager that should be used to transform data between
 //                        various data types using compatibility layers
@@ -17,6 +30,19 @@
 EditorBase::EditorBase(/*compatibilityManager, */ const QString& filePath, bool createUndoStack)
 {
     _filePath = QDir::cleanPath(filePath);
+
+    // The watcher reports only changes of contents, our own saves are announced to it and reported as not external
+    auto fileWatcher = qobject_cast<Application*>(qApp)->getFileWatcher();
+    auto onExternalChange = [this](const QString& changedFilePath)
+    {
+        if (!_monitoredFilePath.isEmpty() && changedFilePath == _monitoredFilePath)
+            onFileChangedByExternalProgram();
+    };
+    connect(fileWatcher, &FileWatcher::fileChanged, this, [onExternalChange](const QString& changedFilePath, bool external)
+    {
+        if (external) onExternalChange(changedFilePath);
+    });
+    connect(fileWatcher, &FileWatcher::fileRemoved, this, onExternalChange);
 /*
         self.compatibilityManager = compatibilityManager
         self.desiredSavingDataType = "" if self.compatibilityManager is None else self.compatibilityManager.EditorNativeType
@@ -31,6 +57,17 @@ EditorBase::EditorBase(/*compatibilityManager, */ const QString& filePath, bool
         undoStack->setUndoLimit(settings->getEntryValue("global/app/undo_limit").toInt());
         undoStack->setClean();
 
+        auto getUndoMemoryBudget = [](const QVariant& limitMB)
+        {
+            return static_cast<size_t>(std::max(1, limitMB.toInt())) * 1024 * 1024;
+        };
+        auto undoMemoryLimitEntry = settings->getEntry("global/app/undo_memory_limit");
+        _undoDataStore.reset(new UndoDataStore(getUndoMemoryBudget(undoMemoryLimitEntry->value())));
+        connect(undoMemoryLimitEntry, &SettingsEntry::valueChanged, this, [this, getUndoMemoryBudget](const QVariant& newValue)
+        {
+            _undoDataStore->setMemoryBudget(getUndoMemoryBudget(newValue));
+        });
+
         connect(undoStack, &QUndoStack::canUndoChanged, [this](bool available)
         {
             emit undoAvailable(available, undoStack->undoText());
@@ -47,38 +84,40 @@ EditorBase::EditorBase(/*compatibilityManager, */ const QString& filePath, bool
         {
             emit redoAvailable(undoStack->canRedo(), text);
         });
-        connect(undoStack, &QUndoStack::indexChanged, [this](int /*idx*/)
-        {
-            onContentsChanged();
-        });
+        connect(undoStack, &QUndoStack::indexChanged, this, &EditorBase::onUndoStackIndexChanged);
+
+        // Snapshots are taken periodically while editing, not after each change
+        _recoverySnapshotTimer = new QTimer(this);
+        _recoverySnapshotTimer->setSingleShot(true);
+        connect(_recoverySnapshotTimer, &QTimer::timeout, this, &EditorBase::writeRecoverySnapshot);
     }
 }
 
 EditorBase::~EditorBase()
 {
-    if (undoStack) undoStack->disconnect();
+    waitForSave();
+    enableFileMonitoring(false);
+    _recoveryJournal.reset();
+
+    if (undoStack)
+    {
+        // Commands may hold data registered in the undo data store, destroy them first
+        undoStack->disconnect();
+        delete undoStack;
+    }
 }
 
-// Adds or removes a file monitor to the specified file so CEED will alert the user
+// Subscribes to or unsubscribes from changes of the file being edited so CEED will alert the user
 // that an external change happened to the file
 void EditorBase::enableFileMonitoring(bool enable)
 {
-    if (enable)
-    {
-        // Lazy initialization
-        if (!fileMonitor)
-        {
-            //???use global file monitor?
-            fileMonitor = new QFileSystemWatcher(this);
-            connect(fileMonitor, &QFileSystemWatcher::fileChanged, this, &EditorBase::onFileChangedByExternalProgram);
-        }
+    const QString newMonitoredFilePath = enable ? QDir::cleanPath(_filePath) : QString();
+    if (newMonitoredFilePath == _monitoredFilePath) return;
 
-        fileMonitor->addPath(_filePath);
-    }
-    else if (fileMonitor)
-    {
-        fileMonitor->removePath(_filePath);
-    }
+    auto fileWatcher = qobject_cast<Application*>(qApp)->getFileWatcher();
+    if (!_monitoredFilePath.isEmpty()) fileWatcher->unwatchFile(_monitoredFilePath);
+    _monitoredFilePath = newMonitoredFilePath;
+    if (!_monitoredFilePath.isEmpty()) fileWatcher->watchFile(_monitoredFilePath);
 }
 
 void EditorBase::markAsUnchanged()
@@ -86,13 +125,15 @@ void EditorBase::markAsUnchanged()
     syncStatus = SyncStatus::Sync;
     if (undoStack) undoStack->setClean();
 
+    // Everything is on disk now, start journaling from scratch. When saving, wait until the data is written.
+    if (!_saveInProgress) restartRecoveryJournal();
+
     // Force GUI update (modified mark etc)
     onContentsChanged();
 }
 
-// The callback method for external file changes.  This method is immediately called when
-// this editor is open. Otherwise, it's called when the user activates the editor.
-//???move all this 'changed' detection to MainWindow, use single monitor etc?
+// The callback method for external file changes. Called by the application file watcher after
+// the contents of the file actually changed, bursts of writes are reported once.
 void EditorBase::onFileChangedByExternalProgram()
 {
     syncStatus = SyncStatus::Conflict;
@@ -100,6 +141,99 @@ void EditorBase::onFileChangedByExternalProgram()
     emit fileChangedExternally();
 }
 
+void EditorBase::restartRecoveryJournal()
+{
+    if (_recoveryJournal)
+    {
+        _recoverySnapshotTimer->stop();
+        _recoveryJournal->reset(_filePath);
+    }
+    else if (_initialized && undoStack && !_filePath.isEmpty() &&
+             qobject_cast<Application*>(qApp)->getSettings()->getEntryValue("global/app/recovery_journal").toBool())
+    {
+        _recoveryJournal.reset(new RecoveryJournal(_filePath));
+    }
+}
+
+void EditorBase::onUndoStackIndexChanged(int index)
+{
+    if (_recoveryJournal)
+    {
+        if (!undoStack->isClean())
+            _recoveryJournal->recordCommand(index, (index > 0) ? undoStack->text(index - 1) : QString());
+        _sinceLastEdit.start();
+        if (!_recoverySnapshotTimer->isActive()) startRecoverySnapshotTimer();
+    }
+
+    onContentsChanged();
+}
+
+// The interval grows with the document, taking a copy of its state is still paid in the GUI thread
+void EditorBase::startRecoverySnapshotTimer()
+{
+    const int seconds = std::max(1, qobject_cast<Application*>(qApp)->getSettings()->getEntryValue("global/app/recovery_snapshot_interval").toInt());
+    const int multiplier = std::min(MaxRecoveryIntervalMultiplier, 1 + _recoveryJournal->getLastSnapshotSize() / RecoverySnapshotSizeStep);
+    _recoverySnapshotTimer->start(seconds * multiplier * 1000);
+}
+
+// Only a copy of the editor state is taken here, serialization, compression and writing are done
+// by the journal in background
+void EditorBase::writeRecoverySnapshot()
+{
+    if (!_recoveryJournal || !_recoveryJournal->isActive()) return;
+
+    // Returned to the saved state, nothing to recover
+    if (!hasChanges())
+    {
+        if (!_saveInProgress) _recoveryJournal->reset(_filePath);
+        return;
+    }
+
+    // Don't stall the user in the middle of editing or dragging, wait for a pause
+    const bool isDragging = (QApplication::mouseButtons() != Qt::NoButton);
+    if (isDragging || (_sinceLastEdit.isValid() && _sinceLastEdit.elapsed() < RecoveryIdleDelayMs))
+    {
+        _recoverySnapshotTimer->start(static_cast<int>(RecoveryIdleDelayMs));
+        return;
+    }
+
+    _recoveryJournal->recordSnapshot(undoStack ? undoStack->index() : 0, getRawDataSnapshot());
+}
+
+// Returns a function producing the same data as getRawData, callable from any thread. Editors override
+// it to take a cheap copy of their state here and leave the rest of serialization to the caller thread.
+std::function<QByteArray()> EditorBase::getRawDataSnapshot()
+{
+    QByteArray rawData;
+    getRawData(rawData);
+    return [rawData]() { return rawData; };
+}
+
+// Reads the file being edited or takes the data recovered after a crash instead
+bool EditorBase::readRawData(QByteArray& outRawData)
+{
+    if (!_recoveredData.isNull())
+    {
+        outRawData = std::move(_recoveredData);
+        _recoveredData = QByteArray();
+
+        // Recovered data differs from the file and must be journaled again ASAP
+        syncStatus = SyncStatus::NotSync;
+        onContentsChanged();
+        QTimer::singleShot(0, this, &EditorBase::writeRecoverySnapshot);
+
+        return true;
+    }
+
+    if (_filePath.isEmpty()) return true;
+
+    QFile file(_filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return false;
+
+    outRawData = file.readAll();
+    return true;
+}
+
 void EditorBase::onContentsChanged()
 {
     // New changes are not discarded by the user and we should ask about saving them
@@ -210,7 +344,13 @@ void EditorBase::initialize()
 void EditorBase::finalize()
 {
     assert(_initialized);
+
+    waitForSave();
     _initialized = false;
+
+    // Closed or reloaded normally, unsaved changes are discarded by the user
+    if (_recoverySnapshotTimer) _recoverySnapshotTimer->stop();
+    _recoveryJournal.reset();
 }
 
 // The editor gets "on stage", it's been clicked on and is now the only active one.
@@ -246,9 +386,13 @@ bool EditorBase::hasChanges() const
 }
 
 // Causes the editor to save all it's progress to the file.
-// targetPath should be absolute file path.
-bool EditorBase::saveAs(const QString& targetPath)
+// targetPath should be absolute file path. In async mode returns after the document is
+// serialized, the result of writing is reported later. Otherwise returns the result of writing.
+bool EditorBase::saveAs(const QString& targetPath, bool async)
 {
+    // The result of the previous save is processed first, only one save state is kept
+    waitForSave();
+
     const QString prevFilePath = _filePath;
 
     QString actualPath;
@@ -277,72 +421,92 @@ bool EditorBase::saveAs(const QString& targetPath)
     }
     else actualPath = targetPath;
 
-    // Stop monitoring the file, the changes that are about to occur are not
-    // picked up as being from an external program! Also file renaming breaks
-    // watching it, so re-enabling monitor is necessary.
-    enableFileMonitoring(false);
+    _savePrevFilePath = prevFilePath;
+    _savePrevSyncStatus = syncStatus;
+    _saveInProgress = true;
+
+    // Do it before obtaining raw data since it may contain relative pathes.
+    // For example imageset XML contains a relative path to underlying image.
+    _filePath = actualPath;
+
+    // The snapshot is taken here, the editing may continue while it is being written
+    QByteArray rawData;
+    getRawData(rawData);
+
+    // The changes that are about to occur must not be picked up as being from an external program.
+    // When saving to another file, the monitoring is switched to it after it is written.
+    if (_monitoredFilePath == QDir::cleanPath(actualPath))
+        qobject_cast<Application*>(qApp)->getFileWatcher()->setExpectedContents(actualPath, rawData);
+    else
+        enableFileMonitoring(false);
+    /*
+        if self.compatibilityManager is not None:
+            outputData = self.compatibilityManager.transform(self.compatibilityManager.EditorNativeType, self.desiredSavingDataType, self.nativeData)
+    */
+
+    // The saved state is what we have now, changes made during writing will be unsaved
+    markAsUnchanged();
+
+    // Written by a separate thread to not block editing, in parallel with other files when saving all
+    _pendingSave = FileWriter::write(actualPath, rawData);
 
-    // If the file already exists, rename it to avoid data losing due to save error
-    const bool tmpUsed = QFileInfo(actualPath).exists();
-    if (tmpUsed)
+    if (!async) return waitForSave();
+
+    if (!_saveWatcher)
     {
-        QFile prevFile(actualPath);
-        if (!prevFile.rename(actualPath + ".bak"))
-        {
-            QMessageBox::critical(qobject_cast<Application*>(qApp)->getMainWindow(),
-                                  "Error saving file!",
-                                  "CEED encountered an error trying to save the file " + actualPath);
-            return false;
-        }
+        _saveWatcher = new QFutureWatcher<bool>(this);
+        connect(_saveWatcher, &QFutureWatcher<bool>::finished, this, &EditorBase::onSaveFinished);
     }
+    _saveWatcher->setFuture(_pendingSave);
 
-    QFile file(actualPath);
-    if (file.open(QIODevice::WriteOnly))
-    {
-        // Do it before obtaining raw data since it may contain relative pathes.
-        // For example imageset XML contains a relative path to underlying image.
-        _filePath = actualPath;
+    return true;
+}
 
-        QByteArray rawData;
-        getRawData(rawData);
-        /*
-            if self.compatibilityManager is not None:
-                outputData = self.compatibilityManager.transform(self.compatibilityManager.EditorNativeType, self.desiredSavingDataType, self.nativeData)
-        */
+// Blocks until the pending save is finished, returns its result
+bool EditorBase::waitForSave()
+{
+    if (!_saveInProgress) return true;
 
-        const auto written = file.write(rawData);
-        file.close();
+    _pendingSave.waitForFinished();
+    const bool result = _pendingSave.result();
+    onSaveFinished();
+    return result;
+}
 
-        if (written == rawData.size())
-        {
-            if (tmpUsed) QFile(actualPath + ".bak").remove();
-            enableFileMonitoring(true);
+void EditorBase::onSaveFinished()
+{
+    // Already processed by waitForSave()
+    if (!_saveInProgress || !_pendingSave.isFinished()) return;
 
-            markAsUnchanged();
+    _saveInProgress = false;
 
-            if (prevFilePath != _filePath)
-            {
-                _labelText = QFileInfo(_filePath).fileName();
-                emit filePathChanged(prevFilePath, _filePath);
-            }
+    if (_pendingSave.result())
+    {
+        enableFileMonitoring(true);
+
+        // Recovery data is not needed if nothing was changed while saving
+        if (!hasChanges()) restartRecoveryJournal();
 
-            return true;
+        if (_savePrevFilePath != _filePath)
+        {
+            _labelText = QFileInfo(_filePath).fileName();
+            emit filePathChanged(_savePrevFilePath, _filePath);
         }
+
+        return;
     }
 
-    // Something went wrong, show error and restore backup
+    // Something went wrong, the file is left untouched, show error and return to the unsaved state
     QMessageBox::critical(qobject_cast<Application*>(qApp)->getMainWindow(),
                           "Error saving file!",
-                          "CEED encountered an error trying to save the file " + actualPath);
+                          "CEED encountered an error trying to save the file " + _filePath);
 
-    if (tmpUsed)
-    {
-        QFile(actualPath).remove();
-        QFile(actualPath + ".bak").rename(actualPath);
-    }
-    enableFileMonitoring(true);
+    _filePath = _savePrevFilePath;
+    syncStatus = (_savePrevSyncStatus == SyncStatus::Sync) ? SyncStatus::NotSync : _savePrevSyncStatus;
+    if (undoStack) undoStack->resetClean();
 
-    return false;
+    enableFileMonitoring(true);
+    onContentsChanged();
 }
 
 // Either reload file from disk or confirm desynchronization
@@ -396,6 +560,19 @@ bool EditorBase::confirmClosing()
     return false;
 }
 
+// Sums memory reported by undo commands. Commands not reporting it are small enough to be ignored.
+size_t EditorBase::getUndoMemoryFootprint() const
+{
+    if (!undoStack) return 0;
+
+    size_t footprint = 0;
+    for (int i = 0; i < undoStack->count(); ++i)
+        if (auto cmd = dynamic_cast<const IUndoMemoryFootprint*>(undoStack->command(i)))
+            footprint += cmd->getMemoryFootprint();
+
+    return footprint;
+}
+
 void EditorBase::undo()
 {
     if (undoStack) undoStack->undo();
@@ -3,16 +3,22 @@
 
 #include "qstring.h"
 #include "qvariant.h"
+#include "qfuture.h"
+#include "qelapsedtimer.h"
 #include <memory>
+#include <functional>
 
 // This is the base class for a class that takes a file and allows manipulation with it
 
 class QWidget;
 class QUndoStack;
-class QFileSystemWatcher;
 class QSettings;
 class MainWindow;
 class CEGUIProject;
+class UndoDataStore;
+class RecoveryJournal;
+class QTimer;
+template<typename T> class QFutureWatcher;
 
 typedef std::unique_ptr<class EditorBase> EditorBasePtr;
 
@@ -41,9 +47,11 @@ public:
     virtual void restoreState(const QSettings& /*settings*/, const QString& /*rootPath*/) {}
     void reloadData();
     void destroy();
+    void setRecoveredData(QByteArray&& rawData) { _recoveredData = std::move(rawData); }
 
-    bool save() { return saveAs(_filePath); }
-    bool saveAs(const QString& targetPath);
+    bool save(bool async = false) { return saveAs(_filePath, async); }
+    bool saveAs(const QString& targetPath, bool async = false);
+    bool waitForSave();
     void resolveSyncConflict(bool reload);
     bool confirmClosing();
 
@@ -63,6 +71,8 @@ public:
 
     virtual QWidget* getWidget() = 0;
     QUndoStack* getUndoStack() const { return undoStack; }
+    UndoDataStore* getUndoDataStore() const { return _undoDataStore.get(); }
+    size_t getUndoMemoryFootprint() const;
     virtual bool hasChanges() const;
     bool isModifiedExternally() const { return syncStatus == SyncStatus::Conflict; }
     virtual bool requiresProject() const { return false; }
@@ -88,13 +98,30 @@ protected:
     void onContentsChanged();
 
     void enableFileMonitoring(bool enable);
+    void onUndoStackIndexChanged(int index);
+    void onSaveFinished();
+    void restartRecoveryJournal();
+    void writeRecoverySnapshot();
+    void startRecoverySnapshotTimer();
+    bool readRawData(QByteArray& outRawData);
 
     virtual void getRawData(QByteArray& /*outRawData*/) {}
+    virtual std::function<QByteArray()> getRawDataSnapshot();
     virtual void markAsUnchanged();
 
-    QFileSystemWatcher* fileMonitor = nullptr; //???one central, compare path?
     QUndoStack* undoStack = nullptr;
+    std::unique_ptr<UndoDataStore> _undoDataStore;
+    std::unique_ptr<RecoveryJournal> _recoveryJournal;
+    QTimer* _recoverySnapshotTimer = nullptr;
+    QElapsedTimer _sinceLastEdit;     // Snapshots wait until the user pauses
+    QByteArray _recoveredData; // Unsaved data from the crash recovery journal, used instead of the file contents
+    QFutureWatcher<bool>* _saveWatcher = nullptr;
+    QFuture<bool> _pendingSave;
+    QString _savePrevFilePath;
+    SyncStatus _savePrevSyncStatus = SyncStatus::Sync;
+    bool _saveInProgress = false;
     QString _filePath;
+    QString _monitoredFilePath; // Subscribed to the application file watcher
     QString _labelText;
     SyncStatus syncStatus = SyncStatus::Sync;
     bool _initialized = false;
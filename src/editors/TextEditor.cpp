@@ -63,6 +63,12 @@ void TextEditor::getRawData(QByteArray& outRawData)
         outRawData = textDocument->toPlainText().toUtf8();
 }
 
+std::function<QByteArray()> TextEditor::getRawDataSnapshot()
+{
+    const QString text = textDocument ? textDocument->toPlainText() : QString();
+    return [text]() { return text.toUtf8(); };
+}
+
 void TextEditor::markAsUnchanged()
 {
     if (textDocument) textDocument->setModified(false);
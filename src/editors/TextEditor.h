@@ -38,6 +38,7 @@ protected:
     virtual QString getDefaultFolder(CEGUIProject* project) const override;
 
     virtual void getRawData(QByteArray& outRawData) override;
+    virtual std::function<QByteArray()> getRawDataSnapshot() override;
     virtual void markAsUnchanged() override;
 
     void updateFont();
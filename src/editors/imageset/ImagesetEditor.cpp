@@ -6,6 +6,7 @@
 #include "src/util/SettingsSection.h"
 #include "src/util/SettingsEntry.h"
 #include "src/ui/imageset/ImagesetEditorDockWidget.h"
+#include "src/ui/imageset/ImagesetIssuesDockWidget.h"
 #include "src/ui/imageset/ImagesetEntry.h"
 #include "src/ui/MainWindow.h"
 #include "src/cegui/CEGUIProject.h"
@@ -15,6 +16,7 @@
 #include "qfile.h"
 #include "qmessagebox.h"
 #include "qtoolbar.h"
+#include "qaction.h"
 
 ImagesetEditor::ImagesetEditor(const QString& filePath)
     : MultiModeEditor(/*imageset_compatibility.manager, */ filePath)
@@ -32,17 +34,17 @@ void ImagesetEditor::initialize()
 
     QDomDocument doc;
 
-    if (!_filePath.isEmpty())
+    QByteArray rawData;
+    if (!readRawData(rawData))
     {
-        QFile file(_filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-        {
-            assert(false);
-            return;
-        }
+        assert(false);
+        return;
+    }
 
-        const auto fileSize = file.size();
-        if (!doc.setContent(&file))
+    if (!_filePath.isEmpty())
+    {
+        const auto fileSize = rawData.size();
+        if (!doc.setContent(rawData))
         {
             // Things didn't go smooth
             // 2 reasons for that
@@ -84,6 +86,9 @@ void ImagesetEditor::activate(MainWindow& mainWindow)
     mainWindow.addDockWidget(Qt::RightDockWidgetArea, visualMode->getDockWidget());
     visualMode->getDockWidget()->setVisible(true);
 
+    mainWindow.addDockWidget(Qt::RightDockWidgetArea, visualMode->getIssuesDockWidget());
+    visualMode->getIssuesDockWidget()->setVisible(issuesDockWidgetVisible);
+
     auto editorMenu = mainWindow.getEditorMenu();
     editorMenu->setTitle("&Imageset");
     visualMode->rebuildEditorMenu(editorMenu);
@@ -94,6 +99,8 @@ void ImagesetEditor::activate(MainWindow& mainWindow)
 void ImagesetEditor::deactivate(MainWindow& mainWindow)
 {
     mainWindow.removeDockWidget(visualMode->getDockWidget());
+    issuesDockWidgetVisible = visualMode->getIssuesDockWidget()->isVisible();
+    mainWindow.removeDockWidget(visualMode->getIssuesDockWidget());
     mainWindow.removeToolBar(mainWindow.getToolbar("Imageset"));
     MultiModeEditor::deactivate(mainWindow);
 }
@@ -140,14 +147,18 @@ void ImagesetEditor::zoomReset()
         visualMode->zoomReset();
 }
 
-QString ImagesetEditor::getSourceCode() const
+QDomDocument ImagesetEditor::getSourceDocument() const
 {
     QDomDocument doc;
     auto xmlRoot = doc.createElement("Imageset");
     visualMode->getImagesetEntry()->saveToElement(xmlRoot);
     doc.appendChild(xmlRoot);
+    return doc;
+}
 
-    return doc.toString(4);
+QString ImagesetEditor::getSourceCode() const
+{
+    return getSourceDocument().toString(4);
 }
 
 QString ImagesetEditor::getFileTypesDescription() const
@@ -175,6 +186,20 @@ void ImagesetEditor::getRawData(QByteArray& outRawData)
     outRawData = getSourceCode().toUtf8();
 }
 
+// The code being edited is recovered as is, without propagating it to the visual mode.
+// The document is built here and converted to text in the caller thread, nobody else shares it.
+std::function<QByteArray()> ImagesetEditor::getRawDataSnapshot()
+{
+    if (tabs.currentWidget() == codeMode)
+    {
+        const QString code = codeMode->toPlainText();
+        return [code]() { return code.toUtf8(); };
+    }
+
+    const QDomDocument doc = getSourceDocument();
+    return [doc]() { return doc.toString(4).toUtf8(); };
+}
+
 void ImagesetEditor::createSettings(Settings& mgr)
 {
     auto catImageset = mgr.createCategory("imageset", "Imageset editing");
@@ -191,6 +216,53 @@ void ImagesetEditor::createSettings(Settings& mgr)
                                   "it seems. If you have a very good GPU, don't tick this.",
                                   "checkbox", true, 2));
     secVisual->addEntry(std::move(entry));
+
+    auto secAutoSlice = catImageset->createSection("auto_slice", "Auto slice");
+
+    entry.reset(new SettingsEntry(*secAutoSlice, "alpha_threshold", 0, "Alpha threshold",
+                                  "Pixels with alpha above this value (0 - 254) are considered a part of some sprite.",
+                                  "int", false, 1));
+    secAutoSlice->addEntry(std::move(entry));
+
+    entry.reset(new SettingsEntry(*secAutoSlice, "padding", 0, "Padding",
+                                  "Number of pixels added around each found sprite.",
+                                  "int", false, 2));
+    secAutoSlice->addEntry(std::move(entry));
+
+    entry.reset(new SettingsEntry(*secAutoSlice, "min_size", 2, "Minimum size",
+                                  "Sprites smaller than this in both dimensions are considered noise and skipped.",
+                                  "int", false, 3));
+    secAutoSlice->addEntry(std::move(entry));
+
+    entry.reset(new SettingsEntry(*secAutoSlice, "merge_distance", 0, "Merge distance",
+                                  "Sprites separated by less than this number of transparent pixels are merged into one image. "
+                                  "Useful for sprites consisting of separate parts, like text or particles.",
+                                  "int", false, 4));
+    secAutoSlice->addEntry(std::move(entry));
+
+    auto secRepack = catImageset->createSection("repack", "Repack");
+
+    entry.reset(new SettingsEntry(*secRepack, "trim", true, "Trim transparent borders",
+                                  "Transparent borders of images are cut off when repacking, offsets of images are adjusted to keep them in place.",
+                                  "checkbox", false, 1));
+    secRepack->addEntry(std::move(entry));
+
+    entry.reset(new SettingsEntry(*secRepack, "power_of_two", true, "Power of two size",
+                                  "The repacked image has power of two dimensions. Some older GPUs require this.",
+                                  "checkbox", false, 2));
+    secRepack->addEntry(std::move(entry));
+
+    entry.reset(new SettingsEntry(*secRepack, "spacing", 1, "Spacing",
+                                  "Number of transparent pixels between images. Prevents colors of neighbouring images from bleeding in when filtering.",
+                                  "int", false, 3));
+    secRepack->addEntry(std::move(entry));
+
+    auto secExport = catImageset->createSection("export", "Export");
+
+    entry.reset(new SettingsEntry(*secExport, "scales", QString("0.75 0.5"), "Scales",
+                                  "Space separated scales of imageset variants written by 'Export Scaled Variants'.",
+                                  "string", false, 1));
+    secExport->addEntry(std::move(entry));
 }
 
 void ImagesetEditor::createActions(Application& app)
@@ -201,6 +273,23 @@ void ImagesetEditor::createActions(Application& app)
                        "When you select an image definition, a crosshair will appear in it representing it's offset centrepoint.",
                        QIcon(":/icons/imageset_editing/edit_offsets.png"), QKeySequence(Qt::Key_Space), true);
 
+    auto pixelGridAction = app.registerAction("imageset", "pixel_grid", "Show &Pixel Grid",
+                                              "Draws borders of texels when zoomed in enough to see them.",
+                                              QIcon(), QKeySequence(), true);
+    pixelGridAction->setChecked(true);
+
+    app.registerAction("imageset", "usage_heatmap", "Show &Usage Heatmap",
+                       "Colours images by the number of references from project layouts, looknfeels, schemes and fonts. Unused images are blue, the most used ones are red.",
+                       QIcon(), QKeySequence(), true);
+
+    app.registerAction("imageset", "find_usages", "&Find Usages",
+                       "Lists layouts, looknfeels and other project files that use the selected image, or the whole imageset if no image is selected.",
+                       QIcon(), QKeySequence(Qt::SHIFT + Qt::Key_F12));
+
+    app.registerAction("imageset", "rename_in_project", "&Rename in Project...",
+                       "Renames the selected image in this imageset and in all project files that use it.",
+                       QIcon(), QKeySequence(Qt::SHIFT + Qt::Key_F6));
+
     app.registerAction("imageset", "cycle_overlapping", "Cycle O&verlapping Image Definitions",
                        "When images definition overlap in such a way that makes it hard/impossible to select the definition you want, this allows you to select on of them and then just cycle until the right one is selected.",
                        QIcon(":/icons/imageset_editing/cycle_overlapping.png"), QKeySequence(Qt::Key_Q));
@@ -213,6 +302,15 @@ void ImagesetEditor::createActions(Application& app)
                        "Duplicates selected image definitions.",
                        QIcon(":/icons/imageset_editing/duplicate_image.png"));
 
+    app.registerAction("imageset", "auto_slice", "&Auto Slice Sprites",
+                       "Creates image definitions for all sprites of the imageset image not covered yet. Sprites are separated by transparent pixels, see Auto slice settings.");
+
+    app.registerAction("imageset", "repack", "&Repack Images",
+                       "Trims transparent borders of images and packs them into a new smaller image, which is saved next to the current one. See Repack settings.");
+
+    app.registerAction("imageset", "export_scaled", "&Export Scaled Variants",
+                       "Writes copies of the imageset and its image scaled by factors from Export settings next to the imageset file. Images are resampled separately, so they don't bleed into each other.");
+
     app.registerAction("imageset", "focus_image_list_filter_box", "&Filter...",
                        "This allows you to easily press a shortcut and immediately search through image definitions without having to reach for a mouse.",
                        QIcon(":/icons/imageset_editing/focus_image_list_filter_box.png"), QKeySequence(QKeySequence::Find));
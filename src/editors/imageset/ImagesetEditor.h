@@ -16,6 +16,7 @@ class ImagesetVisualMode;
 class ImagesetCodeMode;
 class Settings;
 class Application;
+class QDomDocument;
 
 class ImagesetEditor : public MultiModeEditor
 {
@@ -45,6 +46,7 @@ public:
 
     ImagesetVisualMode* getVisualMode() const { return visualMode; }
     QString getSourceCode() const;
+    QDomDocument getSourceDocument() const;
 
 protected:
 
@@ -53,9 +55,11 @@ protected:
     virtual QString getDefaultFolder(CEGUIProject* project) const override;
 
     virtual void getRawData(QByteArray& outRawData) override;
+    virtual std::function<QByteArray()> getRawDataSnapshot() override;
 
     ImagesetVisualMode* visualMode = nullptr;
     ImagesetCodeMode* codeMode = nullptr;
+    bool issuesDockWidgetVisible = false; // Docks are hidden when removed from the main window
 };
 
 class ImagesetEditorFactory : public EditorFactoryBase
@@ -4,8 +4,35 @@
 #include "src/ui/imageset/ImageEntry.h"
 #include "src/ui/imageset/ImageOffsetMark.h"
 #include "src/ui/imageset/ImagesetEditorDockWidget.h"
+#include "src/QtStdHash.h"
+#include "qsavefile.h"
+#include "qfileinfo.h"
+#include "qmessagebox.h"
+#include <unordered_map>
+#include <unordered_set>
 #include <math.h>
 
+// Images are removed in one pass, lists of images and issues are updated only once
+template<class T>
+static std::vector<QString> getRecordNames(const std::vector<T>& records)
+{
+    std::vector<QString> names;
+    names.reserve(records.size());
+    for (const auto& rec : records)
+        names.push_back(rec.name);
+    return names;
+}
+
+// Image records of big imagesets are not negligible, mostly because of names
+template<class T>
+static size_t getRecordsFootprint(const std::vector<T>& records)
+{
+    size_t footprint = records.size() * sizeof(T);
+    for (const auto& rec : records)
+        footprint += static_cast<size_t>(rec.name.size()) * sizeof(QChar);
+    return footprint;
+}
+
 ImagesetMoveCommand::ImagesetMoveCommand(ImagesetVisualMode& visualMode, std::vector<Record>&& imageRecords)
     : _visualMode(visualMode)
     , _imageRecords(std::move(imageRecords))
@@ -422,14 +449,18 @@ void ImagesetDeleteCommand::undo()
 
 void ImagesetDeleteCommand::redo()
 {
-    for (auto& rec : _imageRecords)
-        _visualMode.getImagesetEntry()->removeImageEntry(rec.name);
+    _visualMode.getImagesetEntry()->removeImageEntries(getRecordNames(_imageRecords));
 
     _visualMode.getDockWidget()->refresh();
 
     QUndoCommand::redo();
 }
 
+size_t ImagesetDeleteCommand::getMemoryFootprint() const
+{
+    return sizeof(ImagesetDeleteCommand) + getRecordsFootprint(_imageRecords);
+}
+
 //---------------------------------------------------------------------
 
 ImagesetRenameCommand::ImagesetRenameCommand(ImagesetVisualMode& visualMode, const QString& oldName, const QString& newName)
@@ -582,8 +613,7 @@ void ImagesetDuplicateCommand::undo()
 {
     QUndoCommand::undo();
 
-    for (auto& rec : _imageRecords)
-        _visualMode.getImagesetEntry()->removeImageEntry(rec.name);
+    _visualMode.getImagesetEntry()->removeImageEntries(getRecordNames(_imageRecords));
 
     _visualMode.getDockWidget()->refresh();
 }
@@ -605,6 +635,11 @@ void ImagesetDuplicateCommand::redo()
     QUndoCommand::redo();
 }
 
+size_t ImagesetDuplicateCommand::getMemoryFootprint() const
+{
+    return sizeof(ImagesetDuplicateCommand) + getRecordsFootprint(_imageRecords);
+}
+
 //---------------------------------------------------------------------
 
 ImagesetPasteCommand::ImagesetPasteCommand(ImagesetVisualMode& visualMode, std::vector<ImagesetPasteCommand::Record>&& imageRecords)
@@ -621,8 +656,7 @@ void ImagesetPasteCommand::undo()
 {
     QUndoCommand::undo();
 
-    for (auto& rec : _imageRecords)
-        _visualMode.getImagesetEntry()->removeImageEntry(rec.name);
+    _visualMode.getImagesetEntry()->removeImageEntries(getRecordNames(_imageRecords));
 
     _visualMode.getDockWidget()->refresh();
 }
@@ -643,3 +677,145 @@ void ImagesetPasteCommand::redo()
 
     QUndoCommand::redo();
 }
+
+size_t ImagesetPasteCommand::getMemoryFootprint() const
+{
+    return sizeof(ImagesetPasteCommand) + getRecordsFootprint(_imageRecords);
+}
+
+//---------------------------------------------------------------------
+
+ImagesetAutoSliceCommand::ImagesetAutoSliceCommand(ImagesetVisualMode& visualMode, std::vector<ImagesetAutoSliceCommand::Record>&& imageRecords)
+    : _visualMode(visualMode)
+    , _imageRecords(std::move(imageRecords))
+{
+    setText(QString("Auto slice %1 images").arg(_imageRecords.size()));
+}
+
+void ImagesetAutoSliceCommand::undo()
+{
+    QUndoCommand::undo();
+
+    // There may be thousands of images, remove them in one pass
+    _visualMode.getImagesetEntry()->removeImageEntries(getRecordNames(_imageRecords));
+
+    _visualMode.getDockWidget()->refresh();
+}
+
+void ImagesetAutoSliceCommand::redo()
+{
+    for (auto& rec : _imageRecords)
+    {
+        auto image = _visualMode.getImagesetEntry()->createImageEntry();
+        image->setName(rec.name);
+        image->setPos(rec.pos);
+        image->setRect(0.0, 0.0, rec.size.width(), rec.size.height());
+    }
+
+    _visualMode.getDockWidget()->refresh();
+
+    QUndoCommand::redo();
+}
+
+size_t ImagesetAutoSliceCommand::getMemoryFootprint() const
+{
+    return sizeof(ImagesetAutoSliceCommand) + getRecordsFootprint(_imageRecords);
+}
+
+//---------------------------------------------------------------------
+
+// Repacking touches all images, lookup by name one by one would be quadratic
+static std::unordered_map<QString, ImageEntry*> getImageEntriesByName(const ImagesetEntry& imagesetEntry)
+{
+    std::unordered_map<QString, ImageEntry*> images;
+    for (ImageEntry* image : imagesetEntry.getImageEntries())
+        images.emplace(image->name(), image);
+    return images;
+}
+
+bool ImagesetRepackCommand::writeImageFile(const QString& filePath, const QByteArray& imageData)
+{
+    QSaveFile file(filePath);
+    return file.open(QFile::WriteOnly) && file.write(imageData) == imageData.size() && file.commit();
+}
+
+ImagesetRepackCommand::ImagesetRepackCommand(ImagesetVisualMode& visualMode, const QString& oldImageFile, const QString& newImageFile,
+                                             QByteArray&& newImageData, std::vector<ImagesetRepackCommand::Record>&& imageRecords)
+    : _visualMode(visualMode)
+    , _oldImageFile(oldImageFile)
+    , _newImageFile(newImageFile)
+    , _newImageData(visualMode.getEditor().getUndoDataStore(), std::move(newImageData))
+    , _imageRecords(std::move(imageRecords))
+{
+    setText(QString("Repack %1 images to '%2'").arg(_imageRecords.size()).arg(_newImageFile));
+
+    // Loading the new image moves these ones, the command is created before it is pushed and redone
+    std::unordered_set<QString> repackedNames;
+    for (const auto& rec : _imageRecords)
+        repackedNames.insert(rec.name);
+
+    for (ImageEntry* image : _visualMode.getImagesetEntry()->getImageEntries())
+        if (repackedNames.find(image->name()) == repackedNames.end())
+            _skippedRecords.push_back({ image->name(), image->pos() });
+}
+
+void ImagesetRepackCommand::undo()
+{
+    QUndoCommand::undo();
+
+    // Switch first, so that the file watcher forgets the repacked file before it is removed
+    _visualMode.getImagesetEntry()->loadImage(_oldImageFile);
+    QFile::remove(_newImageFile);
+
+    const auto images = getImageEntriesByName(*_visualMode.getImagesetEntry());
+    for (auto& rec : _imageRecords)
+    {
+        // Position is constrained by the current size, so the size goes first
+        auto image = images.at(rec.name);
+        image->setRect(0.0, 0.0, rec.oldSize.width(), rec.oldSize.height());
+        image->setPos(rec.oldPos);
+        image->setOffsetX(rec.oldOffset.x());
+        image->setOffsetY(rec.oldOffset.y());
+        image->updateDockWidget();
+    }
+
+    for (auto& rec : _skippedRecords)
+    {
+        auto image = images.at(rec.name);
+        image->setPos(rec.pos);
+        image->updateDockWidget();
+    }
+
+    _visualMode.getDockWidget()->refreshImagesetInfo();
+}
+
+void ImagesetRepackCommand::redo()
+{
+    // The file was written before the first redo, only undo removes it
+    if (!QFileInfo::exists(_newImageFile) && !writeImageFile(_newImageFile, _newImageData.get()))
+        QMessageBox::critical(nullptr, "Repack", QString("Failed to save the repacked image to '%1'.").arg(_newImageFile));
+
+    _visualMode.getImagesetEntry()->loadImage(_newImageFile);
+
+    const auto images = getImageEntriesByName(*_visualMode.getImagesetEntry());
+    for (auto& rec : _imageRecords)
+    {
+        // Position is constrained by the current size, so the size goes first
+        auto image = images.at(rec.name);
+        image->setRect(0.0, 0.0, rec.newSize.width(), rec.newSize.height());
+        image->setPos(rec.newPos);
+        image->setOffsetX(rec.newOffset.x());
+        image->setOffsetY(rec.newOffset.y());
+        image->updateDockWidget();
+    }
+
+    _visualMode.getDockWidget()->refreshImagesetInfo();
+
+    QUndoCommand::redo();
+}
+
+size_t ImagesetRepackCommand::getMemoryFootprint() const
+{
+    return sizeof(ImagesetRepackCommand) + _newImageData.getMemoryFootprint() +
+            getRecordsFootprint(_imageRecords) + getRecordsFootprint(_skippedRecords);
+}
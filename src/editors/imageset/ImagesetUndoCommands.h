@@ -4,6 +4,7 @@
 #include "qundostack.h"
 #include "qvariant.h"
 #include "qrect.h"
+#include "src/util/UndoData.h"
 
 constexpr int ImagesetUndoCommandBase = 1100;
 
@@ -164,7 +165,7 @@ protected:
 };
 
 // Deletes given image entries
-class ImagesetDeleteCommand : public QUndoCommand
+class ImagesetDeleteCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
@@ -181,6 +182,7 @@ public:
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override { return ImagesetUndoCommandBase + 7; }
+    virtual size_t getMemoryFootprint() const override;
 
 protected:
 
@@ -265,7 +267,7 @@ protected:
 };
 
 // Duplicates given image entries
-class ImagesetDuplicateCommand : public QUndoCommand
+class ImagesetDuplicateCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
@@ -282,6 +284,7 @@ public:
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override { return ImagesetUndoCommandBase + 12; }
+    virtual size_t getMemoryFootprint() const override;
 
 protected:
 
@@ -291,7 +294,7 @@ protected:
 
 // This command pastes clipboard data to the given imageset. Based on ImagesetDuplicateCommand.
 // TODO: combine with ImagesetDuplicateCommand? Lots of similar code.
-class ImagesetPasteCommand : public QUndoCommand
+class ImagesetPasteCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
@@ -308,6 +311,7 @@ public:
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override { return ImagesetUndoCommandBase + 13; }
+    virtual size_t getMemoryFootprint() const override;
 
 protected:
 
@@ -315,4 +319,74 @@ protected:
     std::vector<Record> _imageRecords;
 };
 
+// Creates images found by the automatic slicing of the imageset image
+class ImagesetAutoSliceCommand : public QUndoCommand, public IUndoMemoryFootprint
+{
+public:
+
+    struct Record
+    {
+        QString name;
+        QPointF pos;
+        QSizeF size;
+    };
+
+    ImagesetAutoSliceCommand(ImagesetVisualMode& visualMode, std::vector<Record>&& imageRecords);
+
+    virtual void undo() override;
+    virtual void redo() override;
+    virtual int id() const override { return ImagesetUndoCommandBase + 14; }
+    virtual size_t getMemoryFootprint() const override;
+
+protected:
+
+    ImagesetVisualMode& _visualMode;
+    std::vector<Record> _imageRecords;
+};
+
+// Switches the imageset to a repacked image and moves all images to their places on it.
+// Images not repacked (outside the old image) are constrained to the new one, their positions
+// are stored to be restored on undo.
+// The repacked image file is created by the command, undo removes it and switches back to the original image
+class ImagesetRepackCommand : public QUndoCommand, public IUndoMemoryFootprint
+{
+public:
+
+    struct Record
+    {
+        QString name;
+        QPointF oldPos;
+        QSizeF oldSize;
+        QPoint oldOffset;
+        QPointF newPos;
+        QSizeF newSize;
+        QPoint newOffset;
+    };
+
+    struct SkippedRecord
+    {
+        QString name;
+        QPointF pos;
+    };
+
+    static bool writeImageFile(const QString& filePath, const QByteArray& imageData);
+
+    ImagesetRepackCommand(ImagesetVisualMode& visualMode, const QString& oldImageFile, const QString& newImageFile,
+                          QByteArray&& newImageData, std::vector<Record>&& imageRecords);
+
+    virtual void undo() override;
+    virtual void redo() override;
+    virtual int id() const override { return ImagesetUndoCommandBase + 15; }
+    virtual size_t getMemoryFootprint() const override;
+
+protected:
+
+    ImagesetVisualMode& _visualMode;
+    QString _oldImageFile;
+    QString _newImageFile;
+    UndoData _newImageData; // Encoded PNG
+    std::vector<Record> _imageRecords;
+    std::vector<SkippedRecord> _skippedRecords;
+};
+
 #endif // IMAGESETUNDOCOMMANDS_H
@@ -3,12 +3,19 @@
 #include "src/util/Settings.h"
 #include "src/util/SettingsCategory.h"
 #include "src/util/SettingsEntry.h"
+#include "src/util/SpriteSlicer.h"
+#include "src/util/RectPacker.h"
+#include "src/QtStdHash.h"
 #include "src/ui/imageset/ImagesetEntry.h"
 #include "src/ui/imageset/ImageEntry.h"
 #include "src/ui/imageset/ImageOffsetMark.h"
 #include "src/ui/imageset/ImagesetEditorDockWidget.h"
+#include "src/ui/imageset/ImagesetIssuesDockWidget.h"
+#include "src/ui/imageset/ImageUsageCounter.h"
 #include "src/ui/ResizingHandle.h"
+#include "src/util/TiledImage.h"
 #include "src/ui/MainWindow.h"
+#include "src/ui/SymbolUsagesDockWidget.h"
 #include "src/Application.h"
 #include <qclipboard.h>
 #include <qmimedata.h>
@@ -18,6 +25,19 @@
 #include <qdom.h>
 #include <qrubberband.h>
 #include <qlabel.h>
+#include <qmessagebox.h>
+#include <qpainter.h>
+#include <qfileinfo.h>
+#include <qdir.h>
+#include <qregularexpression.h>
+#include <qsavefile.h>
+#include <qbuffer.h>
+#include <qfuturewatcher.h>
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <cmath>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
 
 constexpr qreal newImageHalfSize = 25.0;
 
@@ -69,19 +89,40 @@ ImagesetVisualMode::ImagesetVisualMode(MultiModeEditor& editor)
         helpLabel->setStyleSheet("background : rgba(32, 32, 32, 128); color : rgba(255, 255, 255, 255)");
     }
 
+    // Color of the texel under the cursor, shown only when magnified
+    _pixelInfoLabel = new QLabel(this);
+    _pixelInfoLabel->setStyleSheet("background : rgba(32, 32, 32, 128); color : rgba(255, 255, 255, 255)");
+    _pixelInfoLabel->setVisible(false);
+    connect(this, &ResizableGraphicsView::zoomChanged, this, &ImagesetVisualMode::updatePixelInfo);
+
     setDragMode(RubberBandDrag);
     setBackgroundBrush(QBrush(Qt::lightGray));
 
     connect(scene(), &QGraphicsScene::selectionChanged, this, &ImagesetVisualMode::slot_selectionChanged);
 
+    imageUsageCounter = new ImageUsageCounter(this);
+    connect(imageUsageCounter, &ImageUsageCounter::countsChanged, [this]()
+    {
+        if (usageHeatmapAction->isChecked()) scene()->update();
+    });
+
+    issuesDockWidget = new ImagesetIssuesDockWidget(*this);
+    issuesDockWidget->setVisible(false);
     dockWidget = new ImagesetEditorDockWidget(*this);
 
     Application* app = qobject_cast<Application*>(qApp);
 
     editOffsetsAction = app->getAction("imageset/edit_offsets");
+    pixelGridAction = app->getAction("imageset/pixel_grid");
+    usageHeatmapAction = app->getAction("imageset/usage_heatmap");
     cycleOverlappingAction = app->getAction("imageset/cycle_overlapping");
     createImageAction = app->getAction("imageset/create_image");
     duplicateSelectedImagesAction = app->getAction("imageset/duplicate_image");
+    autoSliceAction = app->getAction("imageset/auto_slice");
+    repackAction = app->getAction("imageset/repack");
+    exportScaledAction = app->getAction("imageset/export_scaled");
+    findUsagesAction = app->getAction("imageset/find_usages");
+    renameInProjectAction = app->getAction("imageset/rename_in_project");
     focusImageListFilterBoxAction = app->getAction("imageset/focus_image_list_filter_box");
     //app->setActionsEnabled("imageset", false);
 
@@ -90,7 +131,10 @@ ImagesetVisualMode::ImagesetVisualMode(MultiModeEditor& editor)
     contextMenu = new QMenu(this);
     contextMenu->addAction(createImageAction);
     contextMenu->addAction(duplicateSelectedImagesAction);
+    contextMenu->addAction(autoSliceAction);
     contextMenu->addAction(mainWindow->getActionDeleteSelected());
+    contextMenu->addAction(findUsagesAction);
+    contextMenu->addAction(renameInProjectAction);
     contextMenu->addSeparator();
     contextMenu->addAction(cycleOverlappingAction);
     contextMenu->addSeparator();
@@ -99,6 +143,8 @@ ImagesetVisualMode::ImagesetVisualMode(MultiModeEditor& editor)
     contextMenu->addAction(mainWindow->getActionZoomReset());
     contextMenu->addSeparator();
     contextMenu->addAction(editOffsetsAction);
+    contextMenu->addAction(pixelGridAction);
+    contextMenu->addAction(usageHeatmapAction);
 
     initViewHelpText();
 
@@ -116,8 +162,10 @@ ImagesetVisualMode::~ImagesetVisualMode()
     qobject_cast<Application*>(qApp)->getMainWindow()->freeOpenGLWidget(viewport());
 
     // Order matters!
+    dockWidget->setImagesetEntry(nullptr);
     delete imagesetEntry;
     delete dockWidget;
+    delete issuesDockWidget;
 }
 
 void ImagesetVisualMode::initViewHelpText()
@@ -144,6 +192,8 @@ void ImagesetVisualMode::activate(MainWindow& mainWindow, bool editorActivated)
 
     // Call this every time the visual editing is shown to sync all entries up
     slot_toggleEditOffsets(editOffsetsAction->isChecked());
+    slot_togglePixelGrid(pixelGridAction->isChecked());
+    slot_toggleUsageHeatmap(usageHeatmapAction->isChecked());
 
     setFocus();
 }
@@ -163,18 +213,28 @@ bool ImagesetVisualMode::deactivate(MainWindow& mainWindow, bool editorDeactivat
 void ImagesetVisualMode::createActiveStateConnections()
 {
     _activeStateConnections.push_back(connect(editOffsetsAction, &QAction::toggled, this, &ImagesetVisualMode::slot_toggleEditOffsets));
+    _activeStateConnections.push_back(connect(pixelGridAction, &QAction::toggled, this, &ImagesetVisualMode::slot_togglePixelGrid));
+    _activeStateConnections.push_back(connect(usageHeatmapAction, &QAction::toggled, this, &ImagesetVisualMode::slot_toggleUsageHeatmap));
     _activeStateConnections.push_back(connect(cycleOverlappingAction, &QAction::triggered, this, &ImagesetVisualMode::cycleOverlappingImages));
     _activeStateConnections.push_back(connect(createImageAction, &QAction::triggered, this, &ImagesetVisualMode::createImageEntryAtCursor));
     _activeStateConnections.push_back(connect(duplicateSelectedImagesAction, &QAction::triggered, this, &ImagesetVisualMode::duplicateSelectedImageEntries));
+    _activeStateConnections.push_back(connect(autoSliceAction, &QAction::triggered, this, &ImagesetVisualMode::autoSliceImages));
+    _activeStateConnections.push_back(connect(repackAction, &QAction::triggered, this, &ImagesetVisualMode::repackImages));
+    _activeStateConnections.push_back(connect(exportScaledAction, &QAction::triggered, this, &ImagesetVisualMode::exportScaledVariants));
+    _activeStateConnections.push_back(connect(findUsagesAction, &QAction::triggered, this, &ImagesetVisualMode::findUsages));
+    _activeStateConnections.push_back(connect(renameInProjectAction, &QAction::triggered, this, &ImagesetVisualMode::renameInProject));
     _activeStateConnections.push_back(connect(focusImageListFilterBoxAction, &QAction::triggered, dockWidget, &ImagesetEditorDockWidget::focusImageListFilterBox));
 }
 
 void ImagesetVisualMode::loadImagesetEntryFromElement(const QDomElement& xmlRoot)
 {
+    dockWidget->setImagesetEntry(nullptr);
     scene()->clear();
 
     imagesetEntry = new ImagesetEntry(*this);
     imagesetEntry->loadFromElement(xmlRoot);
+    imagesetEntry->setShowPixelGrid(pixelGridAction->isChecked());
+    imagesetEntry->setShowUsageHeatmap(usageHeatmapAction->isChecked());
     scene()->addItem(imagesetEntry);
 
     refreshSceneRect();
@@ -188,10 +248,18 @@ void ImagesetVisualMode::rebuildEditorMenu(QMenu* editorMenu)
     // Similar to the toolbar, includes the focus filter box action
     editorMenu->addAction(createImageAction);
     editorMenu->addAction(duplicateSelectedImagesAction);
+    editorMenu->addAction(autoSliceAction);
+    editorMenu->addAction(repackAction);
+    editorMenu->addAction(exportScaledAction);
     editorMenu->addSeparator();
+    editorMenu->addAction(findUsagesAction);
+    editorMenu->addAction(renameInProjectAction);
     editorMenu->addAction(cycleOverlappingAction);
+    editorMenu->addAction(issuesDockWidget->toggleViewAction());
     editorMenu->addSeparator();
     editorMenu->addAction(editOffsetsAction);
+    editorMenu->addAction(pixelGridAction);
+    editorMenu->addAction(usageHeatmapAction);
     editorMenu->addSeparator();
     editorMenu->addAction(focusImageListFilterBoxAction);
 }
@@ -346,6 +414,441 @@ bool ImagesetVisualMode::duplicateSelectedImageEntries()
     return duplicateImageEntries(imageEntries);
 }
 
+// Proposes an image for each sprite found on the imageset image, sprites already covered by images are skipped
+bool ImagesetVisualMode::autoSliceImages()
+{
+    if (!imagesetEntry || !imagesetEntry->hasImage()) return false;
+
+    const QImage& image = imagesetEntry->getImage();
+    if (!image.hasAlphaChannel())
+    {
+        QMessageBox::warning(this, "Auto slice", "The imageset image has no alpha channel, sprites can't be separated from the background.");
+        return false;
+    }
+
+    auto&& settings = qobject_cast<Application*>(qApp)->getSettings();
+    SpriteSlicer::Params params;
+    params.alphaThreshold = settings->getEntryValue("imageset/auto_slice/alpha_threshold").toInt();
+    params.padding = settings->getEntryValue("imageset/auto_slice/padding").toInt();
+    params.minSize = settings->getEntryValue("imageset/auto_slice/min_size").toInt();
+    params.mergeDistance = settings->getEntryValue("imageset/auto_slice/merge_distance").toInt();
+
+    const auto rects = SpriteSlicer::findSprites(image, params);
+
+    std::vector<QRect> definedRects;
+    std::unordered_set<QString> usedNames;
+    for (ImageEntry* imageEntry : imagesetEntry->getImageEntries())
+    {
+        definedRects.push_back(imageEntry->getImageRect());
+        usedNames.insert(imageEntry->name());
+    }
+
+    std::vector<ImagesetAutoSliceCommand::Record> undo;
+    int index = 1;
+    for (const QRect& rect : rects)
+    {
+        const bool alreadyDefined = std::any_of(definedRects.begin(), definedRects.end(), [&rect](const QRect& definedRect)
+        {
+            return definedRect.intersects(rect);
+        });
+        if (alreadyDefined) continue;
+
+        ImagesetAutoSliceCommand::Record rec;
+        do
+        {
+            rec.name = QString("Sprite_%1").arg(index++);
+        }
+        while (usedNames.find(rec.name) != usedNames.end());
+        rec.pos = rect.topLeft();
+        rec.size = rect.size();
+        undo.push_back(std::move(rec));
+    }
+
+    if (undo.empty())
+    {
+        QMessageBox::information(this, "Auto slice", "No new sprites found on the imageset image.");
+        return false;
+    }
+
+    _editor.getUndoStack()->push(new ImagesetAutoSliceCommand(*this, std::move(undo)));
+    return true;
+}
+
+// Returns the bounding rect of pixels with non-zero alpha inside the rect, null if all of them are transparent
+static QRect getOpaqueBounds(const QImage& image, const QRect& rect)
+{
+    int left = rect.right() + 1;
+    int right = rect.left() - 1;
+    int top = -1;
+    int bottom = -1;
+    for (int y = rect.top(); y <= rect.bottom(); ++y)
+    {
+        const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+
+        int x = rect.left();
+        while (x <= rect.right() && !qAlpha(line[x])) ++x;
+        if (x > rect.right()) continue;
+
+        if (top < 0) top = y;
+        bottom = y;
+        left = std::min(left, x);
+
+        x = rect.right();
+        while (x > right && !qAlpha(line[x])) --x;
+        right = std::max(right, x);
+    }
+
+    return (top < 0) ? QRect() : QRect(QPoint(left, top), QPoint(right, bottom));
+}
+
+// Trims transparent borders of images and packs them into a new smaller image. The current image
+// file is never overwritten, the repacked one is saved next to it, so that undo can switch back.
+bool ImagesetVisualMode::repackImages()
+{
+    if (!imagesetEntry || !imagesetEntry->hasImage() || imagesetEntry->getImageEntries().empty()) return false;
+
+    auto&& settings = qobject_cast<Application*>(qApp)->getSettings();
+    const bool trim = settings->getEntryValue("imageset/repack/trim").toBool();
+    const bool powerOfTwo = settings->getEntryValue("imageset/repack/power_of_two").toBool();
+    const int spacing = std::max(0, settings->getEntryValue("imageset/repack/spacing").toInt());
+
+    const QImage source = imagesetEntry->getImage().convertToFormat(QImage::Format_ARGB32);
+
+    // Images with the same source rect share one packed rect
+    std::vector<QRect> packedSourceRects;
+    std::unordered_map<QRect, size_t> packedIndices;
+    std::vector<ImageEntry*> images;
+    std::vector<size_t> imagePackedIndices;
+    std::vector<QPoint> trimOffsets;
+    for (ImageEntry* imageEntry : imagesetEntry->getImageEntries())
+    {
+        // Images outside the image have nothing to pack
+        const QRect imageRect = imageEntry->getImageRect();
+        const QRect rect = imageRect.intersected(source.rect());
+        if (rect.isEmpty()) continue;
+
+        QRect sourceRect = trim ? getOpaqueBounds(source, rect) : rect;
+        if (sourceRect.isNull()) sourceRect = QRect(rect.topLeft(), QSize(1, 1));
+
+        auto it = packedIndices.find(sourceRect);
+        if (it == packedIndices.end())
+        {
+            it = packedIndices.emplace(sourceRect, packedSourceRects.size()).first;
+            packedSourceRects.push_back(sourceRect);
+        }
+
+        images.push_back(imageEntry);
+        imagePackedIndices.push_back(it->second);
+        trimOffsets.push_back(sourceRect.topLeft() - imageRect.topLeft());
+    }
+
+    std::vector<QSize> sizes;
+    sizes.reserve(packedSourceRects.size());
+    for (const QRect& rect : packedSourceRects)
+        sizes.push_back(rect.size());
+
+    std::vector<QPoint> positions;
+    const QSize atlasSize = RectPacker::findAtlasSize(sizes, spacing, powerOfTwo, positions);
+
+    const qint64 oldBytes = static_cast<qint64>(source.width()) * source.height() * 4;
+    const qint64 newBytes = static_cast<qint64>(atlasSize.width()) * atlasSize.height() * 4;
+    if (atlasSize.isEmpty() || newBytes >= oldBytes)
+    {
+        QMessageBox::information(this, "Repack", "The imageset image is already packed tightly, nothing to save.");
+        return false;
+    }
+
+    QImage atlas(atlasSize, QImage::Format_ARGB32);
+    atlas.fill(Qt::transparent);
+    {
+        QPainter painter(&atlas);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (size_t i = 0; i < packedSourceRects.size(); ++i)
+            painter.drawImage(positions[i], source, packedSourceRects[i]);
+    }
+
+    // Repacking the repacked image must not produce '_packed_packed'
+    const QFileInfo currentFileInfo(imagesetEntry->getImageFile());
+    QString baseName = currentFileInfo.completeBaseName();
+    baseName.remove(QRegularExpression("_packed\\d*$"));
+    QString newFilePath;
+    int counter = 1;
+    do
+    {
+        const QString suffix = (counter > 1) ? QString::number(counter) : QString();
+        newFilePath = currentFileInfo.dir().absoluteFilePath(QString("%1_packed%2.png").arg(baseName, suffix));
+        ++counter;
+    }
+    while (QFileInfo::exists(newFilePath));
+
+    // The command keeps the encoded image to recreate the file when redone after undo
+    QByteArray imageData;
+    {
+        QBuffer buffer(&imageData);
+        buffer.open(QIODevice::WriteOnly);
+        atlas.save(&buffer, "PNG");
+    }
+
+    if (imageData.isEmpty() || !ImagesetRepackCommand::writeImageFile(newFilePath, imageData))
+    {
+        QMessageBox::critical(this, "Repack", QString("Failed to save the repacked image to '%1'.").arg(newFilePath));
+        return false;
+    }
+
+    std::vector<ImagesetRepackCommand::Record> undo;
+    undo.reserve(images.size());
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        ImageEntry* imageEntry = images[i];
+        const size_t packedIndex = imagePackedIndices[i];
+
+        ImagesetRepackCommand::Record rec;
+        rec.name = imageEntry->name();
+        rec.oldPos = imageEntry->pos();
+        rec.oldSize = imageEntry->rect().size();
+        rec.oldOffset = QPoint(imageEntry->offsetX(), imageEntry->offsetY());
+        rec.newPos = positions[packedIndex];
+        rec.newSize = packedSourceRects[packedIndex].size();
+
+        // Trimmed pixels are rendered at the same place as before
+        rec.newOffset = rec.oldOffset + trimOffsets[i];
+
+        undo.push_back(std::move(rec));
+    }
+
+    _editor.getUndoStack()->push(new ImagesetRepackCommand(*this, imagesetEntry->getImageFile(), newFilePath, std::move(imageData), std::move(undo)));
+
+    QMessageBox::information(this, "Repack",
+                             QString("Images were repacked from %1x%2 to %3x%4 and saved to '%5'.\n"
+                                     "Texture memory: %6 KB -> %7 KB (%8% saved).")
+                             .arg(source.width()).arg(source.height())
+                             .arg(atlasSize.width()).arg(atlasSize.height())
+                             .arg(QFileInfo(newFilePath).fileName())
+                             .arg(oldBytes / 1024).arg(newBytes / 1024)
+                             .arg(100 - newBytes * 100 / oldBytes));
+
+    return true;
+}
+
+namespace
+{
+
+// Everything needed to write one scaled variant of the imageset, prepared in the GUI thread
+struct ScaledVariant
+{
+    qreal scale;
+    QString imagesetFilePath;
+    QString imageFilePath;
+    QString imagesetXml;
+    QImage source;
+    std::vector<std::pair<QRect, QRect>> rects; // Source rect -> scaled rect, each unique source rect once
+};
+
+}
+
+// Keeps adjacent images adjacent after rounding
+static QRect scaleRect(const QRect& rect, qreal scale)
+{
+    const int left = qRound(rect.left() * scale);
+    const int top = qRound(rect.top() * scale);
+    const int right = qRound((rect.left() + rect.width()) * scale);
+    const int bottom = qRound((rect.top() + rect.height()) * scale);
+    return QRect(left, top, std::max(1, right - left), std::max(1, bottom - top));
+}
+
+static void scaleIntAttribute(QDomElement& xml, const QString& name, qreal scale)
+{
+    if (xml.hasAttribute(name))
+        xml.setAttribute(name, QString::number(qRound(xml.attribute(name).toInt() * scale)));
+}
+
+// Runs in a worker thread, returns an error message or an empty string
+static QString writeScaledVariant(const ScaledVariant& variant)
+{
+    const QSize size(static_cast<int>(std::ceil(variant.source.width() * variant.scale)),
+                     static_cast<int>(std::ceil(variant.source.height() * variant.scale)));
+    QImage atlas(size, QImage::Format_ARGB32_Premultiplied);
+    atlas.fill(Qt::transparent);
+
+    // Premultiplied alpha keeps transparent pixels from darkening edges while filtering
+    const QImage source = variant.source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    // Each image is resampled separately, so that pixels of neighbours don't bleed into it
+    {
+        QPainter painter(&atlas);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        for (const auto& pair : variant.rects)
+        {
+            const QImage scaled = source.copy(pair.first).scaled(pair.second.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            painter.drawImage(pair.second.topLeft(), scaled);
+        }
+    }
+
+    // Both files are written to temporaries first and replace previous ones only if both are complete,
+    // so that a failure never leaves a truncated image next to a valid imageset
+    QSaveFile imageFile(variant.imageFilePath);
+    if (!imageFile.open(QIODevice::WriteOnly) || !atlas.save(&imageFile, "PNG"))
+        return QString("Failed to write '%1'").arg(variant.imageFilePath);
+
+    QSaveFile imagesetFile(variant.imagesetFilePath);
+    const QByteArray imagesetData = variant.imagesetXml.toUtf8();
+    if (!imagesetFile.open(QIODevice::WriteOnly) || imagesetFile.write(imagesetData) != imagesetData.size())
+        return QString("Failed to write '%1'").arg(variant.imagesetFilePath);
+
+    if (!imageFile.commit())
+        return QString("Failed to write '%1'").arg(variant.imageFilePath);
+    if (!imagesetFile.commit())
+        return QString("Failed to write '%1'").arg(variant.imagesetFilePath);
+
+    return QString();
+}
+
+// Writes downscaled (or upscaled) copies of the image and the imageset next to the imageset file,
+// like 'name_0.5x.imageset' + 'image_0.5x.png'. All variants are processed in parallel.
+bool ImagesetVisualMode::exportScaledVariants()
+{
+    if (_exportingScaledVariants || !imagesetEntry || !imagesetEntry->hasImage()) return false;
+
+    auto&& settings = qobject_cast<Application*>(qApp)->getSettings();
+    std::vector<qreal> scales;
+    for (const QString& scaleString : settings->getEntryValue("imageset/export/scales").toString().split(' '))
+    {
+        // Empty parts between repeated spaces don't parse and are skipped
+        bool ok = false;
+        const qreal scale = scaleString.toDouble(&ok);
+        if (ok && scale > 0.0 && scale <= 4.0 && !qFuzzyCompare(scale, 1.0)) scales.push_back(scale);
+    }
+
+    if (scales.empty())
+    {
+        QMessageBox::warning(this, "Export scaled", "No scales to export, see Export settings of the imageset editor.");
+        return false;
+    }
+
+    QDomDocument doc;
+    auto xmlRoot = doc.createElement("Imageset");
+    imagesetEntry->saveToElement(xmlRoot);
+    doc.appendChild(xmlRoot);
+
+    std::vector<QRect> sourceRects;
+    std::unordered_map<QRect, size_t> sourceRectIndices;
+    for (ImageEntry* imageEntry : imagesetEntry->getImageEntries())
+    {
+        const QRect rect = imageEntry->getImageRect();
+        if (sourceRectIndices.emplace(rect, sourceRects.size()).second)
+            sourceRects.push_back(rect);
+    }
+
+    const QFileInfo imagesetFileInfo(_editor.getFilePath());
+    const QFileInfo imageFileInfo(imagesetEntry->getImageFile());
+    const QImage source = imagesetEntry->getImage();
+
+    QVector<ScaledVariant> variants;
+    for (qreal scale : scales)
+    {
+        ScaledVariant variant;
+        variant.scale = scale;
+        variant.source = source;
+
+        const QString suffix = QString("_%1x").arg(scale);
+        variant.imagesetFilePath = imagesetFileInfo.dir().absoluteFilePath(imagesetFileInfo.completeBaseName() + suffix + ".imageset");
+        variant.imageFilePath = imageFileInfo.dir().absoluteFilePath(imageFileInfo.completeBaseName() + suffix + ".png");
+
+        variant.rects.reserve(sourceRects.size());
+        for (const QRect& rect : sourceRects)
+            variant.rects.emplace_back(rect, scaleRect(rect, scale));
+
+        // The imageset keeps its name, so that references to its images work with any variant
+        QDomElement scaledRoot = xmlRoot.cloneNode(true).toElement();
+        scaledRoot.setAttribute("imagefile", QDir::cleanPath(imagesetFileInfo.dir().relativeFilePath(variant.imageFilePath)));
+        scaleIntAttribute(scaledRoot, "nativeHorzRes", scale);
+        scaleIntAttribute(scaledRoot, "nativeVertRes", scale);
+
+        for (auto xmlImage = scaledRoot.firstChildElement("Image"); !xmlImage.isNull(); xmlImage = xmlImage.nextSiblingElement("Image"))
+        {
+            const QRect rect(xmlImage.attribute("xPos").toInt(), xmlImage.attribute("yPos").toInt(),
+                             xmlImage.attribute("width").toInt(), xmlImage.attribute("height").toInt());
+            const QRect scaledRect = scaleRect(rect, scale);
+            xmlImage.setAttribute("xPos", QString::number(scaledRect.x()));
+            xmlImage.setAttribute("yPos", QString::number(scaledRect.y()));
+            xmlImage.setAttribute("width", QString::number(scaledRect.width()));
+            xmlImage.setAttribute("height", QString::number(scaledRect.height()));
+            scaleIntAttribute(xmlImage, "xOffset", scale);
+            scaleIntAttribute(xmlImage, "yOffset", scale);
+            scaleIntAttribute(xmlImage, "nativeHorzRes", scale);
+            scaleIntAttribute(xmlImage, "nativeVertRes", scale);
+        }
+
+        QDomDocument scaledDoc;
+        scaledDoc.appendChild(scaledDoc.importNode(scaledRoot, true));
+        variant.imagesetXml = scaledDoc.toString(4);
+
+        variants.push_back(std::move(variant));
+    }
+
+    _exportingScaledVariants = true;
+
+    auto watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, variants]()
+    {
+        _exportingScaledVariants = false;
+
+        QStringList errors;
+        QStringList written;
+        const auto results = watcher->future().results();
+        for (int i = 0; i < results.size(); ++i)
+        {
+            if (results[i].isEmpty())
+                written.push_back(QFileInfo(variants[i].imagesetFilePath).fileName());
+            else
+                errors.push_back(results[i]);
+        }
+
+        if (errors.empty())
+            QMessageBox::information(this, "Export scaled", "Exported " + written.join(", "));
+        else
+            QMessageBox::critical(this, "Export scaled", errors.join("\n"));
+
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::mapped(variants, writeScaledVariant));
+    return true;
+}
+
+// Shows where the selected image is used in the project, or the whole imageset if no single image is selected
+void ImagesetVisualMode::findUsages()
+{
+    if (!imagesetEntry) return;
+
+    ImageEntry* imageEntry = nullptr;
+    auto selection = scene()->selectedItems();
+    if (selection.size() == 1) imageEntry = dynamic_cast<ImageEntry*>(selection[0]);
+
+    auto usagesWidget = qobject_cast<Application*>(qApp)->getMainWindow()->getSymbolUsagesDockWidget();
+    if (imageEntry)
+        usagesWidget->showUsages(ProjectSymbolIndex::SymbolType::Image, imagesetEntry->name() + '/' + imageEntry->name());
+    else
+        usagesWidget->showUsages(ProjectSymbolIndex::SymbolType::Imageset, imagesetEntry->name());
+}
+
+// Renames the selected image everywhere in the project, the imageset file is rewritten on disk too
+void ImagesetVisualMode::renameInProject()
+{
+    if (!imagesetEntry) return;
+
+    auto selection = scene()->selectedItems();
+    auto imageEntry = (selection.size() == 1) ? dynamic_cast<ImageEntry*>(selection[0]) : nullptr;
+    if (!imageEntry)
+    {
+        QMessageBox::information(this, "Rename in Project", "Select a single image to rename.");
+        return;
+    }
+
+    auto usagesWidget = qobject_cast<Application*>(qApp)->getMainWindow()->getSymbolUsagesDockWidget();
+    usagesWidget->renameSymbol(ProjectSymbolIndex::SymbolType::Image, imagesetEntry->name() + '/' + imageEntry->name());
+}
+
 bool ImagesetVisualMode::cut()
 {
     if (!copy()) return false;
@@ -503,6 +1006,20 @@ void ImagesetVisualMode::slot_toggleEditOffsets(bool enabled)
     if (imagesetEntry) imagesetEntry->setShowOffsets(enabled);
 }
 
+void ImagesetVisualMode::slot_togglePixelGrid(bool enabled)
+{
+    if (imagesetEntry) imagesetEntry->setShowPixelGrid(enabled);
+}
+
+// Counts follow the project symbol index, which tracks changes of project files
+void ImagesetVisualMode::slot_toggleUsageHeatmap(bool enabled)
+{
+    if (!imagesetEntry) return;
+
+    imagesetEntry->setShowUsageHeatmap(enabled);
+    if (enabled) imageUsageCounter->update(imagesetEntry->name());
+}
+
 void ImagesetVisualMode::slot_customContextMenu(QPoint point)
 {
     contextMenu->exec(mapToGlobal(point));
@@ -513,9 +1030,35 @@ QPoint ImagesetVisualMode::roundToImagePixels(QPoint src) const
     return mapFromScene(mapToScene(src).toPoint());
 }
 
+void ImagesetVisualMode::updatePixelInfo()
+{
+    const QPoint texel(static_cast<int>(std::floor(_lastCursorScenePos.x())), static_cast<int>(std::floor(_lastCursorScenePos.y())));
+    if (!imagesetEntry || transform().m11() < TiledImage::MagnifiedMinScale || !underMouse() || !imagesetEntry->getImage().valid(texel))
+    {
+        _pixelInfoLabel->setVisible(false);
+        return;
+    }
+
+    // The image is stored premultiplied
+    const QRgb rgba = qUnpremultiply(imagesetEntry->getImage().pixel(texel));
+    _pixelInfoLabel->setText(QString("X: %1, Y: %2   R: %3 G: %4 B: %5 A: %6")
+                             .arg(texel.x()).arg(texel.y())
+                             .arg(qRed(rgba)).arg(qGreen(rgba)).arg(qBlue(rgba)).arg(qAlpha(rgba)));
+    _pixelInfoLabel->adjustSize();
+    _pixelInfoLabel->move(0, height() - _pixelInfoLabel->height());
+    _pixelInfoLabel->setVisible(true);
+}
+
+void ImagesetVisualMode::leaveEvent(QEvent* event)
+{
+    _pixelInfoLabel->setVisible(false);
+    ResizableGraphicsView::leaveEvent(event);
+}
+
 void ImagesetVisualMode::mouseMoveEvent(QMouseEvent* event)
 {
     _lastCursorScenePos = mapToScene(event->pos());
+    updatePixelInfo();
 
     if (_rubberBand && _rubberBand->isVisible())
     {
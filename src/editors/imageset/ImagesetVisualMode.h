@@ -9,9 +9,12 @@
 class ImageEntry;
 class ImagesetEntry;
 class ImagesetEditorDockWidget;
+class ImagesetIssuesDockWidget;
+class ImageUsageCounter;
 class QDomElement;
 class QMenu;
 class QRubberBand;
+class QLabel;
 
 class ImagesetVisualMode : public ResizableGraphicsView, public IEditMode
 {
@@ -37,6 +40,11 @@ public:
     bool deleteSelectedImageEntries();
     bool duplicateImageEntries(const std::vector<ImageEntry*>& imageEntries);
     bool duplicateSelectedImageEntries();
+    bool autoSliceImages();
+    bool repackImages();
+    bool exportScaledVariants();
+    void findUsages();
+    void renameInProject();
 
     bool cut();
     bool copy();
@@ -44,12 +52,16 @@ public:
 
     ImagesetEntry* getImagesetEntry() const { return imagesetEntry; }
     ImagesetEditorDockWidget* getDockWidget() const { return dockWidget; }
+    ImagesetIssuesDockWidget* getIssuesDockWidget() const { return issuesDockWidget; }
+    ImageUsageCounter* getImageUsageCounter() const { return imageUsageCounter; }
 
 protected slots:
 
     bool cycleOverlappingImages();
     void slot_selectionChanged();
     void slot_toggleEditOffsets(bool enabled);
+    void slot_togglePixelGrid(bool enabled);
+    void slot_toggleUsageHeatmap(bool enabled);
     void slot_customContextMenu(QPoint point);
 
 protected:
@@ -58,23 +70,36 @@ protected:
     virtual void mousePressEvent(QMouseEvent* event) override;
     virtual void mouseReleaseEvent(QMouseEvent* event) override;
     virtual void keyReleaseEvent(QKeyEvent* event) override;
+    virtual void leaveEvent(QEvent* event) override;
 
     void initViewHelpText();
     void createActiveStateConnections();
     QString getNewImageName(const QString& desiredName, QString copyPrefix = "", QString copySuffix = "_copy");
     QPoint roundToImagePixels(QPoint src) const;
+    void updatePixelInfo();
 
     ImagesetEntry* imagesetEntry = nullptr;
     ImagesetEditorDockWidget* dockWidget = nullptr;
+    ImagesetIssuesDockWidget* issuesDockWidget = nullptr;
+    ImageUsageCounter* imageUsageCounter = nullptr;
     QMenu* contextMenu = nullptr;
     QRubberBand* _rubberBand = nullptr;
+    QLabel* _pixelInfoLabel = nullptr;
     QPoint _mouseDownPos;
     QPointF _lastCursorScenePos;
+    bool _exportingScaledVariants = false;
 
     QAction* editOffsetsAction = nullptr;
+    QAction* pixelGridAction = nullptr;
+    QAction* usageHeatmapAction = nullptr;
     QAction* cycleOverlappingAction = nullptr;
     QAction* createImageAction = nullptr;
     QAction* duplicateSelectedImagesAction = nullptr;
+    QAction* autoSliceAction = nullptr;
+    QAction* repackAction = nullptr;
+    QAction* exportScaledAction = nullptr;
+    QAction* findUsagesAction = nullptr;
+    QAction* renameInProjectAction = nullptr;
     QAction* focusImageListFilterBoxAction = nullptr;
 };
 
@@ -75,16 +75,10 @@ void LayoutEditor::initialize()
     MultiModeEditor::initialize();
 
     QByteArray rawData;
-    if (!_filePath.isEmpty())
+    if (!readRawData(rawData))
     {
-        QFile file(_filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-        {
-            QMessageBox::warning(nullptr, "File read error", "Layout editor can't read file " + _filePath);
-            return;
-        }
-
-        rawData = file.readAll();
+        QMessageBox::warning(nullptr, "File read error", "Layout editor can't read file " + _filePath);
+        return;
     }
 
     loadVisualFromString(rawData);
@@ -231,6 +225,24 @@ void LayoutEditor::getRawData(QByteArray& outRawData)
     outRawData = CEGUIUtils::stringToQString(layoutString).toUtf8();
 }
 
+// CEGUI can be used only from the GUI thread, only the conversion is left to the caller thread.
+// The code being edited is recovered as is, without propagating it to the visual mode.
+std::function<QByteArray()> LayoutEditor::getRawDataSnapshot()
+{
+    if (tabs.currentWidget() == codeMode)
+    {
+        const QString code = codeMode->toPlainText();
+        return [code]() { return code.toUtf8(); };
+    }
+
+    // Nothing to recover, and no warning must pop up in the middle of editing
+    auto currentRootWidget = visualMode->getRootWidget();
+    if (!currentRootWidget) return []() { return QByteArray(); };
+
+    const CEGUI::String layoutString = CEGUI::WindowManager::getSingleton().getLayoutAsString(*currentRootWidget);
+    return [layoutString]() { return CEGUIUtils::stringToQString(layoutString).toUtf8(); };
+}
+
 void LayoutEditor::createSettings(Settings& mgr)
 {
     auto catImageset = mgr.createCategory("layout", "Layout editing");
@@ -52,6 +52,7 @@ protected:
     virtual QString getDefaultFolder(CEGUIProject* project) const override;
 
     virtual void getRawData(QByteArray& outRawData) override;
+    virtual std::function<QByteArray()> getRawDataSnapshot() override;
 
     LayoutVisualMode* visualMode = nullptr;
     LayoutCodeMode* codeMode = nullptr;
@@ -13,13 +13,14 @@
 #include <qtimer.h>
 
 static LayoutManipulator* CreateManipulatorFromDataStream(LayoutVisualMode& visualMode, LayoutManipulator* parent,
-                                                          QDataStream& stream, size_t index = std::numeric_limits<size_t>().max())
+                                                          QDataStream& stream, size_t index = std::numeric_limits<size_t>().max(),
+                                                          CEGUIUtils::UniqueNameAllocator* nameAllocator = nullptr)
 {
     LayoutManipulator* manipulator;
 
     if (parent)
     {
-        CEGUI::Window* widget = CEGUIUtils::deserializeWidget(stream, parent->getWidget(), index);
+        CEGUI::Window* widget = CEGUIUtils::deserializeWidget(stream, parent->getWidget(), index, nameAllocator);
         assert(widget);
         if (!widget) return nullptr;
 
@@ -35,7 +36,7 @@ static LayoutManipulator* CreateManipulatorFromDataStream(LayoutVisualMode& visu
     else
     {
         // No parent, root widget
-        CEGUI::Window* widget = CEGUIUtils::deserializeWidget(stream, nullptr);
+        CEGUI::Window* widget = CEGUIUtils::deserializeWidget(stream, nullptr, std::numeric_limits<size_t>().max(), nameAllocator);
         assert(widget);
         if (!widget) return nullptr;
 
@@ -230,8 +231,10 @@ LayoutDeleteCommand::LayoutDeleteCommand(LayoutVisualMode& visualMode, QStringLi
         rec.indexInParent = manipulator->getWidgetIndexInParent();
 
         // Serialize deleted hierarchy for undo
-        QDataStream stream(&rec.data, QIODevice::WriteOnly);
+        QByteArray data;
+        QDataStream stream(&data, QIODevice::WriteOnly);
         CEGUIUtils::serializeWidget(*manipulator->getWidget(), stream, true);
+        rec.data = UndoData(_visualMode.getEditor().getUndoDataStore(), std::move(data));
 
         _records.push_back(std::move(rec));
     }
@@ -252,15 +255,21 @@ void LayoutDeleteCommand::undo()
 {
     QUndoCommand::undo();
 
+    _visualMode.getScene()->deferLayoutContainerUpdates(true);
+
+    CEGUIUtils::UniqueNameAllocator nameAllocator;
     for (auto& rec : _records)
     {
         const int sepPos = rec.path.lastIndexOf('/');
         LayoutManipulator* parent = (sepPos < 0) ? nullptr : _visualMode.getScene()->getManipulatorByPath(rec.path.left(sepPos));
 
-        QDataStream stream(&rec.data, QIODevice::ReadOnly);
-        CreateManipulatorFromDataStream(_visualMode, parent, stream, rec.indexInParent);
+        const QByteArray data = rec.data.get();
+        QDataStream stream(data);
+        CreateManipulatorFromDataStream(_visualMode, parent, stream, rec.indexInParent, &nameAllocator);
     }
 
+    _visualMode.getScene()->deferLayoutContainerUpdates(false);
+
     _visualMode.getHierarchyDockWidget()->refresh();
 }
 
@@ -274,6 +283,14 @@ void LayoutDeleteCommand::redo()
     QUndoCommand::redo();
 }
 
+size_t LayoutDeleteCommand::getMemoryFootprint() const
+{
+    size_t footprint = sizeof(LayoutDeleteCommand);
+    for (const auto& rec : _records)
+        footprint += sizeof(Record) + rec.data.getMemoryFootprint();
+    return footprint;
+}
+
 //---------------------------------------------------------------------
 
 LayoutCreateCommand::LayoutCreateCommand(LayoutVisualMode& visualMode, const QString& parentPath,
@@ -515,6 +532,16 @@ bool LayoutPropertyEditCommand::mergeWith(const QUndoCommand* other)
     return false;
 }
 
+// Values like texts or whole property sets of many widgets may be big
+size_t LayoutPropertyEditCommand::getMemoryFootprint() const
+{
+    size_t footprint = sizeof(LayoutPropertyEditCommand) + _records.size() * sizeof(Record);
+    for (const auto& rec : _records)
+        footprint += static_cast<size_t>(rec.path.size()) * sizeof(QChar) +
+                (rec.oldValue.size() + rec.newValue.size()) * sizeof(CEGUI::String::value_type);
+    return footprint;
+}
+
 void LayoutPropertyEditCommand::setProperty(const QString& widgetPath, const CEGUI::String& value, const QStringList& propertiesToUpdate)
 {
     auto manipulator = _visualMode.getScene()->getManipulatorByPath(widgetPath);
@@ -781,6 +808,7 @@ void LayoutMoveInHierarchyCommand::undo()
 
     _visualMode.getScene()->clearSelection();
     _visualMode.getHierarchyDockWidget()->getTreeView()->clearSelection();
+    _visualMode.getScene()->deferLayoutContainerUpdates(true);
 
     for (auto it = _records.rbegin(); it != _records.rend(); ++it)
     {
@@ -825,6 +853,7 @@ void LayoutMoveInHierarchyCommand::undo()
         if (newParentManipulator) newParentManipulator->updateFromWidget(true, true);
     }
 
+    _visualMode.getScene()->deferLayoutContainerUpdates(false);
     _visualMode.getHierarchyDockWidget()->refresh();
 }
 
@@ -832,6 +861,7 @@ void LayoutMoveInHierarchyCommand::redo()
 {
     _visualMode.getScene()->clearSelection();
     _visualMode.getHierarchyDockWidget()->getTreeView()->clearSelection();
+    _visualMode.getScene()->deferLayoutContainerUpdates(true);
 
     for (const auto& rec : _records)
     {
@@ -872,6 +902,7 @@ void LayoutMoveInHierarchyCommand::redo()
         oldParentManipulator->updateFromWidget(true, true);
     }
 
+    _visualMode.getScene()->deferLayoutContainerUpdates(false);
     _visualMode.getHierarchyDockWidget()->refresh();
 
     QUndoCommand::redo();
@@ -884,7 +915,7 @@ LayoutPasteCommand::LayoutPasteCommand(LayoutVisualMode& visualMode,
                                        QByteArray&& data)
     : _visualMode(visualMode)
     , _targetPath(targetPath)
-    , _data(std::move(data))
+    , _data(visualMode.getEditor().getUndoDataStore(), std::move(data))
 {
 }
 
@@ -906,8 +937,11 @@ void LayoutPasteCommand::redo()
     auto target = scene->getManipulatorByPath(_targetPath);
 
     scene->clearSelection();
+    scene->deferLayoutContainerUpdates(true);
 
-    QDataStream stream(&_data, QIODevice::ReadOnly);
+    CEGUIUtils::UniqueNameAllocator nameAllocator;
+    const QByteArray data = _data.get();
+    QDataStream stream(data);
     while (!stream.atEnd())
     {
         if (!target && !_createdWidgets.empty())
@@ -916,7 +950,7 @@ void LayoutPasteCommand::redo()
             break;
         }
 
-        if (auto manipulator = CreateManipulatorFromDataStream(_visualMode, target, stream))
+        if (auto manipulator = CreateManipulatorFromDataStream(_visualMode, target, stream, std::numeric_limits<size_t>().max(), &nameAllocator))
             _createdWidgets.push_back(manipulator->getWidgetPath());
     }
 
@@ -924,6 +958,8 @@ void LayoutPasteCommand::redo()
     // repositions of the pasted widgets into the manipulator data.
     if (target) target->updateFromWidget(true, true);
 
+    scene->deferLayoutContainerUpdates(false);
+
     _visualMode.getHierarchyDockWidget()->refresh();
 
     if (_createdWidgets.size() == 1)
@@ -934,6 +970,11 @@ void LayoutPasteCommand::redo()
     QUndoCommand::redo();
 }
 
+size_t LayoutPasteCommand::getMemoryFootprint() const
+{
+    return sizeof(LayoutPasteCommand) + _data.getMemoryFootprint();
+}
+
 //---------------------------------------------------------------------
 
 LayoutDuplicateCommand::LayoutDuplicateCommand(LayoutVisualMode& visualMode, std::vector<Record>&& records)
@@ -967,24 +1008,43 @@ void LayoutDuplicateCommand::undo()
 void LayoutDuplicateCommand::redo()
 {
     _visualMode.getScene()->clearSelection();
+    _visualMode.getScene()->deferLayoutContainerUpdates(true);
 
+    // Parents are updated once after all insertions, not after each of them
+    std::set<LayoutManipulator*> parentManipulators;
+    CEGUIUtils::UniqueNameAllocator nameAllocator;
     for (auto& rec : _records)
     {
         auto parentManipulator = _visualMode.getScene()->getManipulatorByPath(rec.parentPath);
 
-        QDataStream stream(&rec.data, QIODevice::ReadOnly);
-        if (auto manipulator = CreateManipulatorFromDataStream(_visualMode, parentManipulator, stream, rec.childIndex + 1))
+        const QByteArray data = rec.data.get();
+        QDataStream stream(data);
+        if (auto manipulator = CreateManipulatorFromDataStream(_visualMode, parentManipulator, stream, rec.childIndex + 1, &nameAllocator))
         {
             _createdWidgets.push_back(manipulator->getWidgetPath());
-            parentManipulator->updateFromWidget(true, true);
+            parentManipulators.insert(parentManipulator);
         }
     }
 
+    LayoutManipulator::removeNestedManipulators(parentManipulators);
+    for (LayoutManipulator* parentManipulator : parentManipulators)
+        parentManipulator->updateFromWidget(true, true);
+
+    _visualMode.getScene()->deferLayoutContainerUpdates(false);
+
     _visualMode.getHierarchyDockWidget()->refresh();
 
     QUndoCommand::redo();
 }
 
+size_t LayoutDuplicateCommand::getMemoryFootprint() const
+{
+    size_t footprint = sizeof(LayoutDuplicateCommand);
+    for (const auto& rec : _records)
+        footprint += sizeof(Record) + rec.data.getMemoryFootprint();
+    return footprint;
+}
+
 //---------------------------------------------------------------------
 
 LayoutRenameCommand::LayoutRenameCommand(LayoutVisualMode& visualMode, const QString& path, const QString& newName)
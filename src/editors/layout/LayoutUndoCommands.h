@@ -4,6 +4,7 @@
 #include "qundostack.h"
 #include "qvariant.h"
 #include "qrect.h"
+#include "src/util/UndoData.h"
 #include <CEGUI/String.h>
 #include <CEGUI/UVector.h>
 #include <CEGUI/USize.h>
@@ -67,7 +68,7 @@ protected:
 };
 
 // This command deletes given widgets
-class LayoutDeleteCommand : public QUndoCommand
+class LayoutDeleteCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
@@ -76,6 +77,7 @@ public:
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override { return LayoutUndoCommandBase + 3; }
+    virtual size_t getMemoryFootprint() const override;
 
 protected:
 
@@ -83,7 +85,7 @@ protected:
     {
         QString path;
         size_t indexInParent;
-        QByteArray data;
+        UndoData data;
     };
 
     LayoutVisualMode& _visualMode;
@@ -119,7 +121,7 @@ protected:
 };
 
 // This command changes a property of a widget
-class LayoutPropertyEditCommand : public QUndoCommand
+class LayoutPropertyEditCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
@@ -136,6 +138,7 @@ public:
     virtual void redo() override;
     virtual int id() const override { return LayoutUndoCommandBase + 5; }
     virtual bool mergeWith(const QUndoCommand* other) override;
+    virtual size_t getMemoryFootprint() const override;
 
     bool isValueInvalid() const { return _invalidValue; }
 
@@ -244,7 +247,7 @@ protected:
 };
 
 // This command pastes clipboard data to the given widget
-class LayoutPasteCommand : public QUndoCommand
+class LayoutPasteCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
@@ -253,24 +256,25 @@ public:
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override { return LayoutUndoCommandBase + 9; }
+    virtual size_t getMemoryFootprint() const override;
 
 protected:
 
     LayoutVisualMode& _visualMode;
     QString _targetPath;
-    QByteArray _data;
+    UndoData _data;
     std::vector<QString> _createdWidgets;
 };
 
 // This command duplicates selected widgets
-class LayoutDuplicateCommand : public QUndoCommand
+class LayoutDuplicateCommand : public QUndoCommand, public IUndoMemoryFootprint
 {
 public:
 
     struct Record
     {
         QString parentPath;
-        QByteArray data; // To aviod reserialization on undo/redo
+        UndoData data; // To aviod reserialization on undo/redo
         size_t childIndex;
         QString name;
     };
@@ -280,6 +284,7 @@ public:
     virtual void undo() override;
     virtual void redo() override;
     virtual int id() const override { return LayoutUndoCommandBase + 10; }
+    virtual size_t getMemoryFootprint() const override;
 
 protected:
 
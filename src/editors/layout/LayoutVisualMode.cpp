@@ -317,7 +317,6 @@ bool LayoutVisualMode::duplicate()
 
     std::vector<LayoutDuplicateCommand::Record> records;
 
-    QByteArray bytes;
     for (LayoutManipulator* manipulator : selectedWidgets)
     {
         auto parentManipulator = dynamic_cast<LayoutManipulator*>(manipulator->parentItem());
@@ -325,6 +324,7 @@ bool LayoutVisualMode::duplicate()
         // Can't duplicate the root
         if (!parentManipulator) continue;
 
+        QByteArray bytes;
         QDataStream stream(&bytes, QIODevice::WriteOnly);
         if (!CEGUIUtils::serializeWidget(*manipulator->getWidget(), stream, true))
             return false;
@@ -332,7 +332,7 @@ bool LayoutVisualMode::duplicate()
         if (!bytes.size()) continue;
 
         LayoutDuplicateCommand::Record rec;
-        std::swap(rec.data, bytes);
+        rec.data = UndoData(_editor.getUndoDataStore(), std::move(bytes));
         rec.name = manipulator->getWidgetName();
         rec.childIndex = manipulator->getWidgetIndexInParent();
         rec.parentPath = parentManipulator->getWidgetPath();
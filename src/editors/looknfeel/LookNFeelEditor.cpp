@@ -170,6 +170,23 @@ void LookNFeelEditor::getRawData(QByteArray& outRawData)
     outRawData = CEGUIUtils::stringToQString(lookAndFeelString).toUtf8();
 }
 
+// CEGUI can be used only from the GUI thread, only the conversion is left to the caller thread.
+// The code being edited is recovered as is, without propagating it to the visual mode.
+std::function<QByteArray()> LookNFeelEditor::getRawDataSnapshot()
+{
+    if (tabs.currentWidget() == codeMode)
+    {
+        const QString code = codeMode->toPlainText();
+        return [code]() { return code.toUtf8(); };
+    }
+
+    std::unordered_set<CEGUI::String> nameSet;
+    getWidgetLookFeelNames(nameSet);
+
+    const CEGUI::String lookAndFeelString = CEGUI::WidgetLookManager::getSingleton().getWidgetLookSetAsString(nameSet);
+    return [lookAndFeelString]() { return CEGUIUtils::stringToQString(lookAndFeelString).toUtf8(); };
+}
+
 /*
     @staticmethod
     def unmapMappedNameIntoOriginalParts(mappedName):
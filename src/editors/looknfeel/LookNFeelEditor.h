@@ -36,6 +36,7 @@ protected:
     virtual QString getDefaultFolder(CEGUIProject* project) const override;
 
     virtual void getRawData(QByteArray& outRawData) override;
+    virtual std::function<QByteArray()> getRawDataSnapshot() override;
 
     LookNFeelVisualMode* visualMode = nullptr;
     LookNFeelCodeMode* codeMode = nullptr;
@@ -0,0 +1,311 @@
+#include "src/ui/DirectoryListModel.h"
+#include "qdiriterator.h"
+#include "qfileiconprovider.h"
+#include "qmimedatabase.h"
+#include "qcollator.h"
+#include "qmutex.h"
+#include "qtimer.h"
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <algorithm>
+#include <atomic>
+
+// Batches are taken from the worker by timer, so that the view is not updated for every few entries
+static constexpr int FetchIntervalMs = 100;
+
+// Shared with the worker, which may outlive the model when canceled
+struct DirectoryListModel::Listing
+{
+    QString dirPath;
+    std::atomic<bool> canceled { false };
+
+    QMutex mutex;
+    std::vector<Entry> listed; // Not fetched by the model yet
+    std::vector<Entry> sorted; // All entries, set when finished
+    bool finished = false;
+};
+
+DirectoryListModel::DirectoryListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    _fetchTimer = new QTimer(this);
+    _fetchTimer->setInterval(FetchIntervalMs);
+    connect(_fetchTimer, &QTimer::timeout, this, &DirectoryListModel::fetchListed);
+}
+
+DirectoryListModel::~DirectoryListModel()
+{
+    cancelListing();
+}
+
+void DirectoryListModel::setDirectory(const QString& dirPath)
+{
+    cancelListing();
+
+    beginResetModel();
+    _dirPath = dirPath;
+    _entries.clear();
+    _visible.clear();
+    endResetModel();
+
+    startListing(false);
+}
+
+// Lists the directory again, current entries stay visible until the new list is ready
+void DirectoryListModel::refresh()
+{
+    if (_dirPath.isEmpty()) return;
+
+    // Entries of an unfinished listing are incomplete anyway
+    if (_listing && !_replaceOnFinish)
+    {
+        setDirectory(_dirPath);
+        return;
+    }
+
+    cancelListing();
+    startListing(true);
+}
+
+// Plain text filters by substring, '*' and '?' are wildcards. Case insensitive.
+void DirectoryListModel::setNameFilter(const QString& filter)
+{
+    if (_filter == filter) return;
+
+    _filter = filter;
+    if (_filter.contains('*') || _filter.contains('?'))
+        _filterRegex = QRegularExpression(QRegularExpression::wildcardToRegularExpression("*" + _filter + "*"),
+                                          QRegularExpression::CaseInsensitiveOption);
+    else
+        _filterRegex = QRegularExpression();
+
+    beginResetModel();
+    _visible.clear();
+    collectVisible(0, _visible);
+    endResetModel();
+}
+
+const DirectoryListModel::Entry* DirectoryListModel::getEntry(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(_visible.size())) return nullptr;
+    return &_entries[_visible[static_cast<size_t>(index.row())]];
+}
+
+QModelIndex DirectoryListModel::indexOf(const QString& name) const
+{
+    for (size_t row = 0; row < _visible.size(); ++row)
+        if (_entries[_visible[row]].name == name)
+            return index(static_cast<int>(row));
+
+    return QModelIndex();
+}
+
+int DirectoryListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(_visible.size());
+}
+
+QVariant DirectoryListModel::data(const QModelIndex& index, int role) const
+{
+    const Entry* entry = getEntry(index);
+    if (!entry) return QVariant();
+
+    switch (role)
+    {
+        case Qt::DisplayRole:
+            return entry->name;
+        case Qt::DecorationRole:
+            return getIcon(*entry);
+        default:
+            return QVariant();
+    }
+}
+
+// Runs in a worker thread
+void DirectoryListModel::listDirectory(const std::shared_ptr<Listing>& listing)
+{
+    QMimeDatabase mimeDatabase;
+    std::unordered_map<QString, QString> iconNames; // By suffix, looking up MIME types is not free
+
+    QCollator collator;
+    collator.setNumericMode(true);
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    auto isLess = [&collator](const Entry& a, const Entry& b)
+    {
+        if (a.isDir != b.isDir) return a.isDir;
+        return collator.compare(a.name, b.name) < 0;
+    };
+
+    std::vector<Entry> all;
+    std::vector<Entry> batch;
+    auto publishBatch = [&]()
+    {
+        std::sort(batch.begin(), batch.end(), isLess);
+        all.insert(all.end(), batch.begin(), batch.end());
+
+        QMutexLocker lock(&listing->mutex);
+        listing->listed.insert(listing->listed.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        batch.clear();
+    };
+
+    QDirIterator it(listing->dirPath, QDir::AllEntries | QDir::NoDotAndDotDot);
+    while (it.hasNext())
+    {
+        if (listing->canceled) return;
+
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        Entry entry { info.fileName(), QString(), info.isDir() };
+        if (!entry.isDir)
+        {
+            const QString suffix = info.suffix().toLower();
+            auto iconIt = iconNames.find(suffix);
+            if (iconIt == iconNames.end())
+                iconIt = iconNames.emplace(suffix, mimeDatabase.mimeTypeForFile(entry.name, QMimeDatabase::MatchExtension).iconName()).first;
+            entry.iconName = iconIt->second;
+        }
+
+        batch.push_back(std::move(entry));
+        if (batch.size() >= BatchSize) publishBatch();
+    }
+
+    publishBatch();
+
+    std::sort(all.begin(), all.end(), isLess);
+
+    QMutexLocker lock(&listing->mutex);
+    listing->sorted = std::move(all);
+    listing->finished = true;
+}
+
+void DirectoryListModel::startListing(bool keepEntries)
+{
+    _replaceOnFinish = keepEntries;
+    _listing = std::make_shared<Listing>();
+    _listing->dirPath = _dirPath;
+
+    QtConcurrent::run(&DirectoryListModel::listDirectory, _listing);
+
+    _fetchTimer->start();
+    emit listingStarted();
+}
+
+void DirectoryListModel::cancelListing()
+{
+    _fetchTimer->stop();
+    if (!_listing) return;
+
+    _listing->canceled = true;
+    _listing.reset();
+}
+
+void DirectoryListModel::fetchListed()
+{
+    if (!_listing) return;
+
+    std::vector<Entry> listed;
+    std::vector<Entry> sorted;
+    bool finished;
+    {
+        QMutexLocker lock(&_listing->mutex);
+        listed.swap(_listing->listed);
+        finished = _listing->finished;
+        if (finished) sorted.swap(_listing->sorted);
+    }
+
+    // Show entries as they are listed, in the order of batches
+    if (!_replaceOnFinish && !listed.empty())
+    {
+        const size_t first = _entries.size();
+        _entries.insert(_entries.end(), std::make_move_iterator(listed.begin()), std::make_move_iterator(listed.end()));
+
+        std::vector<size_t> added;
+        collectVisible(first, added);
+        if (!added.empty())
+        {
+            const int row = static_cast<int>(_visible.size());
+            beginInsertRows(QModelIndex(), row, row + static_cast<int>(added.size()) - 1);
+            _visible.insert(_visible.end(), added.begin(), added.end());
+            endInsertRows();
+        }
+    }
+
+    if (!finished) return;
+
+    _fetchTimer->stop();
+    _listing.reset();
+
+    if (_replaceOnFinish)
+    {
+        beginResetModel();
+        _entries = std::move(sorted);
+        _visible.clear();
+        collectVisible(0, _visible);
+        endResetModel();
+    }
+    else
+    {
+        // The same entries in the final order, keep the selection and the current item
+        emit layoutAboutToBeChanged();
+
+        const QModelIndexList oldIndexes = persistentIndexList();
+        QStringList names;
+        for (const QModelIndex& oldIndex : oldIndexes)
+            names.push_back(getEntry(oldIndex) ? getEntry(oldIndex)->name : QString());
+
+        _entries = std::move(sorted);
+        _visible.clear();
+        collectVisible(0, _visible);
+
+        if (!oldIndexes.empty())
+        {
+            std::unordered_map<QString, int> rows;
+            for (size_t row = 0; row < _visible.size(); ++row)
+                rows.emplace(_entries[_visible[row]].name, static_cast<int>(row));
+
+            QModelIndexList newIndexes;
+            for (const QString& name : names)
+            {
+                auto it = rows.find(name);
+                newIndexes.push_back(it == rows.end() ? QModelIndex() : index(it->second));
+            }
+
+            changePersistentIndexList(oldIndexes, newIndexes);
+        }
+
+        emit layoutChanged();
+    }
+
+    emit listingFinished();
+}
+
+bool DirectoryListModel::matchesFilter(const Entry& entry) const
+{
+    if (_filter.isEmpty()) return true;
+    if (_filterRegex.pattern().isEmpty()) return entry.name.contains(_filter, Qt::CaseInsensitive);
+    return _filterRegex.match(entry.name).hasMatch();
+}
+
+// Collects indices of matching entries starting from 'first'
+void DirectoryListModel::collectVisible(size_t first, std::vector<size_t>& outVisible) const
+{
+    for (size_t i = first; i < _entries.size(); ++i)
+        if (matchesFilter(_entries[i]))
+            outVisible.push_back(i);
+}
+
+// Icons are created in the UI thread and shared by all entries of the same type
+const QIcon& DirectoryListModel::getIcon(const Entry& entry) const
+{
+    const QString key = entry.isDir ? QString("/") : entry.iconName;
+    auto it = _icons.find(key);
+    if (it != _icons.end()) return it->second;
+
+    QFileIconProvider iconProvider;
+    QIcon icon;
+    if (entry.isDir)
+        icon = iconProvider.icon(QFileIconProvider::Folder);
+    else
+        icon = QIcon::fromTheme(entry.iconName, iconProvider.icon(QFileIconProvider::File));
+
+    return _icons.emplace(key, icon).first->second;
+}
@@ -0,0 +1,80 @@
+#ifndef DIRECTORYLISTMODEL_H
+#define DIRECTORYLISTMODEL_H
+
+#include "qabstractitemmodel.h"
+#include "qicon.h"
+#include "qregularexpression.h"
+#include "src/QtStdHash.h"
+#include <unordered_map>
+#include <memory>
+#include <vector>
+
+// Lists one directory for the file system browser. Listing, sorting and icon type detection run on
+// the global thread pool, so that huge directories on slow disks don't freeze the UI. Entries appear
+// in batches while being listed and are sorted when the listing finishes. Navigating elsewhere cancels
+// the listing in progress. The name filter only looks at already listed entries.
+
+class QTimer;
+
+class DirectoryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+
+    struct Entry
+    {
+        QString name;
+        QString iconName; // Freedesktop icon name of the MIME type, empty for directories
+        bool isDir;
+    };
+
+    DirectoryListModel(QObject* parent = nullptr);
+    virtual ~DirectoryListModel() override;
+
+    void setDirectory(const QString& dirPath);
+    void refresh();
+    void setNameFilter(const QString& filter);
+
+    const QString& getDirectory() const { return _dirPath; }
+    bool isListing() const { return _listing != nullptr; }
+    const Entry* getEntry(const QModelIndex& index) const;
+    QModelIndex indexOf(const QString& name) const;
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+signals:
+
+    void listingStarted();
+    void listingFinished();
+
+protected:
+
+    struct Listing;
+
+    static constexpr size_t BatchSize = 512;
+
+    static void listDirectory(const std::shared_ptr<Listing>& listing);
+
+    void startListing(bool keepEntries);
+    void cancelListing();
+    void fetchListed();
+    bool matchesFilter(const Entry& entry) const;
+    void collectVisible(size_t first, std::vector<size_t>& outVisible) const;
+    const QIcon& getIcon(const Entry& entry) const;
+
+    QString _dirPath;
+    QString _filter;
+    QRegularExpression _filterRegex; // For wildcard filters only
+    std::vector<Entry> _entries;
+    std::vector<size_t> _visible; // Indices of entries matching the filter
+
+    std::shared_ptr<Listing> _listing;
+    bool _replaceOnFinish = false; // Refreshing keeps old entries until the new list is ready
+    QTimer* _fetchTimer = nullptr;
+
+    mutable std::unordered_map<QString, QIcon> _icons;
+};
+
+#endif // DIRECTORYLISTMODEL_H
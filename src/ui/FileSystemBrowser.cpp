@@ -4,6 +4,8 @@
 #include "src/cegui/CEGUIProject.h"
 #include "src/ui/MainWindow.h"
 #include "src/util/Utils.h"
+#include "src/util/FileWatcher.h"
+#include "src/Application.h"
 #include "src/editors/EditorBase.h"
 #include <qaction.h>
 #include <qmenu.h>
@@ -15,11 +17,20 @@ FileSystemBrowser::FileSystemBrowser(QWidget *parent) :
 {
     ui->setupUi(this);
 
-    model.setReadOnly(true);
-
     auto view = findChild<QListView*>("view");
     view->setModel(&model);
 
+    connect(ui->filterBox, &QLineEdit::textChanged, &model, &DirectoryListModel::setNameFilter);
+    connect(&model, &DirectoryListModel::listingStarted, this, [this]()
+    {
+        ui->view->viewport()->setCursor(Qt::BusyCursor);
+    });
+    connect(&model, &DirectoryListModel::listingFinished, this, &FileSystemBrowser::onListingFinished);
+
+    // Directory contents are listed once, changes are tracked by the watcher
+    auto fileWatcher = qobject_cast<Application*>(qApp)->getFileWatcher();
+    connect(fileWatcher, &FileWatcher::directoryChanged, this, &FileSystemBrowser::onDirectoryChanged);
+
     // Set to project directory if project open, otherwise to user's home
     if (CEGUIManager::Instance().isProjectLoaded())
         setDirectory(CEGUIManager::Instance().getCurrentProject()->getAbsolutePathOf(""));
@@ -31,6 +42,9 @@ FileSystemBrowser::FileSystemBrowser(QWidget *parent) :
 
 FileSystemBrowser::~FileSystemBrowser()
 {
+    if (!directory.isEmpty())
+        qobject_cast<Application*>(qApp)->getFileWatcher()->unwatchDirectory(directory);
+
     delete ui;
 }
 
@@ -73,12 +87,17 @@ void FileSystemBrowser::setDirectory(const QString& dir)
 
     if (!QFileInfo(absDir).isDir()) return;
 
-    directory = absDir;
-
-    model.setRootPath(directory);
+    // Listing may take a while, don't repeat it for the same directory
+    if (absDir != directory)
+    {
+        auto fileWatcher = qobject_cast<Application*>(qApp)->getFileWatcher();
+        if (!directory.isEmpty()) fileWatcher->unwatchDirectory(directory);
+        fileWatcher->watchDirectory(absDir);
 
-    auto view = findChild<QListView*>("view");
-    view->setRootIndex(model.index(directory));
+        directory = absDir;
+        fileToSelect.clear();
+        model.setDirectory(directory);
+    }
 
     // Add the path to pathBox and select it
     //
@@ -109,13 +128,42 @@ QToolButton* FileSystemBrowser::projectDirectoryButton() const
     return ui->projectDirectoryButton;
 }
 
+void FileSystemBrowser::onDirectoryChanged(const QString& dirPath)
+{
+    if (dirPath != directory) return;
+
+    // The list is replaced when refreshed, select the same file again
+    auto entry = model.getEntry(ui->view->currentIndex());
+    if (entry) fileToSelect = entry->name;
+
+    model.refresh();
+}
+
+void FileSystemBrowser::onListingFinished()
+{
+    ui->view->viewport()->unsetCursor();
+
+    if (fileToSelect.isEmpty()) return;
+
+    auto modelIndex = model.indexOf(fileToSelect);
+    if (modelIndex.isValid())
+    {
+        ui->view->setCurrentIndex(modelIndex);
+        ui->view->scrollTo(modelIndex);
+    }
+
+    fileToSelect.clear();
+}
+
 // Slot that gets triggered whenever user double clicks anything in the filesystem view
 void FileSystemBrowser::on_view_doubleClicked(const QModelIndex& index)
 {
-    QString childPath = index.data().toString();
-    QString absolutePath = QDir::cleanPath(QDir(directory).filePath(childPath));
+    auto entry = model.getEntry(index);
+    if (!entry) return;
 
-    if (QFileInfo(absolutePath).isDir())
+    QString absolutePath = QDir::cleanPath(QDir(directory).filePath(entry->name));
+
+    if (entry->isDir)
         setDirectory(absolutePath);
     else
         emit fileOpenRequested(absolutePath);
@@ -146,10 +194,9 @@ void FileSystemBrowser::on_activeFileDirectoryButton_pressed()
 
     setDirectory(QFileInfo(filePath).path());
 
-    // Select the active file
-    auto modelIndex = model.index(filePath);
-    if (modelIndex.isValid())
-        ui->view->setCurrentIndex(modelIndex);
+    // Select the active file, now or when it is listed
+    fileToSelect = QFileInfo(filePath).fileName();
+    if (!model.isListing()) onListingFinished();
 }
 
 // Slot that gets triggered whenever the user selects an path from the list
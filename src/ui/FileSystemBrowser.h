@@ -2,7 +2,7 @@
 #define FILESYSTEMBROWSER_H
 
 #include <QDockWidget>
-#include "qfilesystemmodel.h"
+#include "src/ui/DirectoryListModel.h"
 
 // This class represents the file system browser dock widget, usually located right bottom
 // in the main window. It can browse your entire filesystem and if you double click a file
@@ -53,12 +53,15 @@ private:
 
     void setupContextMenu();
     void openContainingFolderForSelection();
+    void onDirectoryChanged(const QString& dirPath);
+    void onListingFinished();
 
     Ui::FileSystemBrowser *ui;
     QMenu* contextMenu = nullptr;
 
-    QFileSystemModel model;
+    DirectoryListModel model;
     QString directory;
+    QString fileToSelect; // Selected when it appears in the listing
 };
 
 #endif // FILESYSTEMBROWSER_H
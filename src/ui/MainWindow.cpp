@@ -5,6 +5,8 @@
 #include "qpushbutton.h"
 #include "qfiledialog.h"
 #include "qmessagebox.h"
+#include "qinputdialog.h"
+#include "qprogressdialog.h"
 #include "qdesktopservices.h"
 #include "qtabbar.h"
 #include "qsettings.h"
@@ -14,9 +16,12 @@
 #include "src/util/Settings.h"
 #include "src/util/SettingsEntry.h"
 #include "src/util/RecentlyUsed.h"
+#include "src/util/RecoveryJournal.h"
+#include "src/util/FileWriter.h"
 #include "src/util/Utils.h"
 #include "src/cegui/CEGUIManager.h"
 #include "src/cegui/CEGUIProject.h"
+#include "src/cegui/LayoutBatchRenderer.h"
 #include "src/editors/NoEditor.h"
 #include "src/editors/TextEditor.h"
 #include "src/editors/BitmapEditor.h"
@@ -33,6 +38,9 @@
 #include "src/ui/ProjectManager.h"
 #include "src/ui/FileSystemBrowser.h"
 #include "src/ui/UndoViewer.h"
+#include "src/ui/SymbolUsagesDockWidget.h"
+#include "src/ui/ResourceDependenciesDockWidget.h"
+#include "src/ui/ProjectAnalysisDockWidget.h"
 #include "QtnProperty/PropertyWidget.h"
 #include <qclipboard.h>
 #include <qlabel.h>
@@ -110,6 +118,21 @@ MainWindow::MainWindow(QWidget *parent) :
     undoViewer->setVisible(false);
     addDockWidget(Qt::DockWidgetArea::LeftDockWidgetArea, undoViewer);
 
+    symbolUsagesDockWidget = new SymbolUsagesDockWidget(this);
+    symbolUsagesDockWidget->setVisible(false);
+    connect(symbolUsagesDockWidget, &SymbolUsagesDockWidget::fileOpenRequested, this, &MainWindow::openEditorTab);
+    addDockWidget(Qt::DockWidgetArea::BottomDockWidgetArea, symbolUsagesDockWidget);
+
+    dependenciesDockWidget = new ResourceDependenciesDockWidget(this);
+    dependenciesDockWidget->setVisible(false);
+    connect(dependenciesDockWidget, &ResourceDependenciesDockWidget::fileOpenRequested, this, &MainWindow::openEditorTab);
+    addDockWidget(Qt::DockWidgetArea::BottomDockWidgetArea, dependenciesDockWidget);
+
+    analysisDockWidget = new ProjectAnalysisDockWidget(this);
+    analysisDockWidget->setVisible(false);
+    connect(analysisDockWidget, &ProjectAnalysisDockWidget::fileOpenRequested, this, &MainWindow::openEditorTab);
+    addDockWidget(Qt::DockWidgetArea::BottomDockWidgetArea, analysisDockWidget);
+
     setupToolbars();
 
     // Setup dynamic menus
@@ -391,6 +414,9 @@ void MainWindow::updateProjectDependentUI(CEGUIProject* newProject)
     const bool isProjectLoaded = !!newProject;
 
     projectManager->setProject(newProject);
+    symbolUsagesDockWidget->setSymbolIndex(isProjectLoaded ? CEGUIManager::Instance().getSymbolIndex() : nullptr);
+    dependenciesDockWidget->setSymbolIndex(isProjectLoaded ? CEGUIManager::Instance().getSymbolIndex() : nullptr);
+    analysisDockWidget->setSymbolIndex(isProjectLoaded ? CEGUIManager::Instance().getSymbolIndex() : nullptr);
 
     if (isProjectLoaded)
     {
@@ -421,6 +447,8 @@ void MainWindow::updateProjectDependentUI(CEGUIProject* newProject)
     ui->actionCloseProject->setEnabled(isProjectLoaded);
     ui->actionProjectSettings->setEnabled(isProjectLoaded);
     ui->actionReloadResources->setEnabled(isProjectLoaded);
+    ui->actionAnalyzeProject->setEnabled(isProjectLoaded);
+    ui->actionRenderLayouts->setEnabled(isProjectLoaded);
 }
 
 bool MainWindow::confirmProjectClosing(bool onlyModified)
@@ -501,6 +529,82 @@ void MainWindow::loadProject(const QString& path)
     }
 }
 
+// Offers to restore unsaved changes from journals left by a crashed session
+void MainWindow::recoverUnsavedChanges(const QStringList& journalPaths)
+{
+    for (const QString& journalPath : journalPaths)
+    {
+        RecoveryJournal::Contents contents;
+        if (!RecoveryJournal::read(journalPath, contents))
+        {
+            RecoveryJournal::remove(journalPath);
+            continue;
+        }
+
+        QString message = tr("CEED was closed unexpectedly while '%1' had unsaved changes. "
+                             "Do you want to recover them?").arg(contents.filePath);
+        const bool fileExists = QFileInfo::exists(contents.filePath);
+        if (!fileExists)
+            message += tr("\n\nThe file doesn't exist anymore, you will be asked where to save the recovered contents.");
+        else if (QFileInfo(contents.filePath).lastModified() != contents.baseModified)
+            message += tr("\n\nThe file was modified after the changes were made, recovering will overwrite these modifications on save!");
+        if (!contents.lostChanges.isEmpty())
+            message += tr("\n\n%1 last change(s) can't be recovered: %2").arg(contents.lostChanges.size()).arg(contents.lostChanges.join(", "));
+
+        const auto result = QMessageBox::question(this, tr("Recover unsaved changes?"), message,
+                                                  QMessageBox::Yes | QMessageBox::No | QMessageBox::Cancel,
+                                                  QMessageBox::Yes);
+
+        // Cancel keeps the journal to be offered next time
+        if (result == QMessageBox::Cancel) continue;
+
+        if (result != QMessageBox::Yes)
+        {
+            RecoveryJournal::remove(journalPath);
+            continue;
+        }
+
+        // Editors open only existing files. The recovered contents are written where the user wants them,
+        // the original location might have been removed intentionally.
+        if (!fileExists)
+        {
+            const QString filePath = QFileDialog::getSaveFileName(this, tr("Save recovered contents of '%1'").arg(contents.filePath),
+                                                                  contents.filePath);
+            if (filePath.isEmpty()) continue;
+
+            if (!FileWriter::write(filePath, contents.data).result())
+            {
+                QMessageBox::critical(this, tr("Error saving file!"),
+                                      tr("CEED encountered an error trying to save the file %1, the recovered contents are kept to be offered next time.").arg(filePath));
+                continue;
+            }
+
+            RecoveryJournal::remove(journalPath);
+            openEditorTab(QDir::cleanPath(filePath));
+            continue;
+        }
+
+        RecoveryJournal::remove(journalPath);
+
+        // The file may be already opened when the project restored its tabs
+        auto it = std::find_if(activeEditors.begin(), activeEditors.end(), [&contents](const EditorBasePtr& element)
+        {
+            return element->getFilePath() == contents.filePath;
+        });
+        if (it != activeEditors.end())
+        {
+            if ((*it)->hasChanges()) continue;
+            closeEditorTab(it->get());
+        }
+
+        auto editor = createEditorForFile(contents.filePath);
+        if (!editor || dynamic_cast<NoEditor*>(editor.get())) continue;
+
+        editor->setRecoveredData(std::move(contents.data));
+        initEditor(std::move(editor));
+    }
+}
+
 void MainWindow::on_actionNewProject_triggered()
 {
     if (!confirmProjectClosing(false)) return;
@@ -556,6 +660,9 @@ void MainWindow::on_actionProjectSettings_triggered()
     {
         dialog.apply(*CEGUIManager::Instance().getCurrentProject());
         CEGUIManager::Instance().syncProjectToCEGUIInstance();
+        symbolUsagesDockWidget->setSymbolIndex(CEGUIManager::Instance().getSymbolIndex());
+        dependenciesDockWidget->setSymbolIndex(CEGUIManager::Instance().getSymbolIndex());
+        analysisDockWidget->setSymbolIndex(CEGUIManager::Instance().getSymbolIndex());
     }
 }
 
@@ -696,7 +803,7 @@ void MainWindow::on_tabs_currentChanged(int index)
         ui->actionUndo->setText("Undo");
         ui->actionRedo->setText("Redo");
 
-        undoViewer->setUndoStack(nullptr);
+        undoViewer->setEditor(nullptr);
     }
 
     setStatusMessage("");
@@ -721,10 +828,13 @@ void MainWindow::on_tabs_currentChanged(int index)
 
         currentEditor->activate(*this);
 
+        if (!currentEditor->getFilePath().isEmpty())
+            dependenciesDockWidget->showFile(currentEditor->getFilePath());
+
         auto undoStack = currentEditor->getUndoStack();
         if (undoStack)
         {
-            undoViewer->setUndoStack(undoStack);
+            undoViewer->setEditor(currentEditor);
 
             ui->actionUndo->setEnabled(undoStack->canUndo());
             ui->actionRedo->setEnabled(undoStack->canRedo());
@@ -888,6 +998,16 @@ EditorBase* MainWindow::getEditorForTab(QWidget* tabWidget) const
     return (it == activeEditors.end()) ? nullptr : it->get();
 }
 
+// Returns an editor opened for the file at given absolutePath or nullptr
+EditorBase* MainWindow::getEditorForFile(const QString& absolutePath) const
+{
+    const QString path = QDir::cleanPath(absolutePath);
+    for (auto&& editor : activeEditors)
+        if (QDir::cleanPath(editor->getFilePath()) == path)
+            return editor.get();
+    return nullptr;
+}
+
 // Activates (makes current) the tab for the path specified
 bool MainWindow::activateEditorTabByFilePath(const QString& absolutePath)
 {
@@ -1206,7 +1326,7 @@ void MainWindow::on_actionDelete_triggered()
 
 void MainWindow::on_actionSave_triggered()
 {
-    if (currentEditor) currentEditor->save();
+    if (currentEditor) currentEditor->save(true);
 }
 
 void MainWindow::on_actionSaveAs_triggered()
@@ -1217,7 +1337,7 @@ void MainWindow::on_actionSaveAs_triggered()
     {
         // The new file saving dialog is handled inside an EditorBase
         // FIXME: REFACTOR!
-        currentEditor->saveAs("");
+        currentEditor->saveAs("", true);
     }
     else
     {
@@ -1233,24 +1353,25 @@ void MainWindow::on_actionSaveAs_triggered()
         dialog.selectFile(currentEditor->getFilePath());
 
         if (dialog.exec())
-            currentEditor->saveAs(dialog.selectedFiles()[0]);
+            currentEditor->saveAs(dialog.selectedFiles()[0], true);
     }
 }
 
 // Saves all opened tabbed editors and opened project (if any)
 void MainWindow::on_actionSaveAll_triggered()
 {
+    // Files are written in background, in parallel, while the next editor is being serialized
     auto project =  CEGUIManager::Instance().getCurrentProject();
-    if (project) project->save();
+    if (project) project->save(QString(), true);
 
     for (auto&& editor : activeEditors)
-        editor->save();
+        editor->save(true);
 }
 
 void MainWindow::on_actionSaveProject_triggered()
 {
     auto project =  CEGUIManager::Instance().getCurrentProject();
-    if (project) project->save();
+    if (project) project->save(QString(), true);
 }
 
 bool MainWindow::on_actionCloseProject_triggered()
@@ -1296,6 +1417,60 @@ bool MainWindow::on_actionCloseProject_triggered()
     return true;
 }
 
+void MainWindow::on_actionAnalyzeProject_triggered()
+{
+    analysisDockWidget->setVisible(true);
+    analysisDockWidget->raise();
+    analysisDockWidget->analyze();
+}
+
+void MainWindow::on_actionRenderLayouts_triggered()
+{
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    if (!project) return;
+
+    const QString outputDir = QFileDialog::getExistingDirectory(this, "Select a folder for layout thumbnails", project->getAbsolutePathOf(""));
+    if (outputDir.isEmpty()) return;
+
+    bool ok = false;
+    const QString resolutionList = QInputDialog::getText(this, "Render Layout Thumbnails", "Resolutions (e.g. 1280x720, 800x600):",
+                                                         QLineEdit::Normal, project->getDefaultResolutionString(), &ok);
+    if (!ok) return;
+
+    const auto resolutions = LayoutBatchRenderer::parseResolutions(resolutionList, project->getDefaultResolution());
+    if (resolutions.empty())
+    {
+        QMessageBox::warning(this, "Render Layout Thumbnails", "No valid resolutions specified.");
+        return;
+    }
+
+    const QStringList layoutPaths = LayoutBatchRenderer::findLayouts(*project);
+    const int total = layoutPaths.size() * static_cast<int>(resolutions.size());
+
+    QProgressDialog progress("Rendering layouts...", "Cancel", 0, total, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+
+    LayoutBatchRenderer renderer(*project, outputDir);
+    const QStringList errors = renderer.render(layoutPaths, resolutions, [&progress](int done, int)
+    {
+        progress.setValue(done);
+        return !progress.wasCanceled();
+    });
+
+    progress.close();
+
+    if (!errors.empty())
+    {
+        constexpr int maxErrorsShown = 20;
+        QString text = errors.mid(0, maxErrorsShown).join('\n');
+        if (errors.size() > maxErrorsShown) text += QString("\n... and %1 more").arg(errors.size() - maxErrorsShown);
+        QMessageBox::warning(this, "Render Layout Thumbnails", text);
+    }
+
+    setStatusMessage(QString("%1 layout thumbnails saved to %2").arg(renderer.getRenderedCount()).arg(outputDir));
+}
+
 void MainWindow::on_actionReloadResources_triggered()
 {
     // Since we are effectively unloading the project and potentially nuking resources of it
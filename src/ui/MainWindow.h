@@ -13,6 +13,9 @@ class MainWindow;
 class ProjectManager;
 class FileSystemBrowser;
 class UndoViewer;
+class SymbolUsagesDockWidget;
+class ResourceDependenciesDockWidget;
+class ProjectAnalysisDockWidget;
 class SettingsDialog;
 class RecentlyUsedMenuEntry;
 class CEGUIProject;
@@ -31,7 +34,9 @@ public:
     ~MainWindow() override;
 
     QDockWidget* getPropertyDockWidget() const { return propertyDockWidget; }
+    SymbolUsagesDockWidget* getSymbolUsagesDockWidget() const { return symbolUsagesDockWidget; }
     EditorBase* getCurrentEditor() const { return currentEditor; }
+    EditorBase* getEditorForFile(const QString& absolutePath) const;
     QMenu* getEditorMenu() const;
     void setEditorMenuEnabled(bool enabled);
     QToolBar* createToolbar(const QString& name);
@@ -39,6 +44,7 @@ public:
     void setStatusMessage(const QString& msg);
 
     void loadProject(const QString& path);
+    void recoverUnsavedChanges(const QStringList& journalPaths);
 
     // Common actions
     QAction* getActionCut() const;
@@ -115,6 +121,8 @@ private slots:
     void on_actionSaveProject_triggered();
     bool on_actionCloseProject_triggered();
     void on_actionReloadResources_triggered();
+    void on_actionAnalyzeProject_triggered();
+    void on_actionRenderLayouts_triggered();
     void on_actionNewLayout_triggered();
     void on_actionNewImageset_triggered();
     void on_actionNewOtherFile_triggered();
@@ -148,6 +156,9 @@ private:
     ProjectManager* projectManager = nullptr;
     FileSystemBrowser* fsBrowser = nullptr;
     UndoViewer* undoViewer = nullptr;
+    SymbolUsagesDockWidget* symbolUsagesDockWidget = nullptr;
+    ResourceDependenciesDockWidget* dependenciesDockWidget = nullptr;
+    ProjectAnalysisDockWidget* analysisDockWidget = nullptr;
     QDockWidget* propertyDockWidget = nullptr;
     SettingsDialog* settingsDialog = nullptr;
     RecentlyUsedMenuEntry* recentlyUsedFiles = nullptr;
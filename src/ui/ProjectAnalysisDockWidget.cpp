@@ -0,0 +1,183 @@
+#include "src/ui/ProjectAnalysisDockWidget.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/CEGUIProject.h"
+#include "qapplication.h"
+#include "qpushbutton.h"
+#include "qlabel.h"
+#include "qtreewidget.h"
+#include "qboxlayout.h"
+#include "qfiledialog.h"
+#include "qmessagebox.h"
+#include "qelapsedtimer.h"
+
+ProjectAnalysisDockWidget::ProjectAnalysisDockWidget(QWidget* parent)
+    : QDockWidget(parent)
+{
+    setObjectName("Project Analysis dock widget");
+    setWindowTitle("Project Analysis");
+
+    _analyzeButton = new QPushButton("Analyze");
+    _analyzeButton->setToolTip("Find unused and missing resources in the whole project");
+    _analyzeButton->setEnabled(false);
+
+    _exportButton = new QPushButton("Export...");
+    _exportButton->setToolTip("Save found issues to a CSV file");
+    _exportButton->setEnabled(false);
+
+    _summary = new QLabel();
+
+    _results = new QTreeWidget();
+    _results->setHeaderHidden(true);
+    _results->setUniformRowHeights(true);
+
+    auto controlsLayout = new QHBoxLayout();
+    controlsLayout->addWidget(_analyzeButton);
+    controlsLayout->addWidget(_exportButton);
+    controlsLayout->addWidget(_summary, 1);
+
+    auto contentsWidget = new QWidget();
+    auto contentsLayout = new QVBoxLayout(contentsWidget);
+    auto margins = contentsLayout->contentsMargins();
+    margins.setTop(0);
+    contentsLayout->setContentsMargins(margins);
+    contentsLayout->addLayout(controlsLayout);
+    contentsLayout->addWidget(_results);
+
+    setWidget(contentsWidget);
+
+    connect(_analyzeButton, &QPushButton::clicked, this, &ProjectAnalysisDockWidget::analyze);
+    connect(_exportButton, &QPushButton::clicked, this, &ProjectAnalysisDockWidget::onExportClicked);
+    connect(_results, &QTreeWidget::itemActivated, this, &ProjectAnalysisDockWidget::onItemActivated);
+}
+
+void ProjectAnalysisDockWidget::setSymbolIndex(ProjectSymbolIndex* index)
+{
+    if (_index == index) return;
+
+    disconnect(_indexConnection);
+    _index = index;
+    if (_index)
+        _indexConnection = connect(_index, &ProjectSymbolIndex::indexChanged, this, &ProjectAnalysisDockWidget::onIndexChanged);
+
+    // Results of another project are meaningless
+    _analyzeWhenReady = false;
+    clearResults();
+    _analyzeButton->setEnabled(_index != nullptr);
+}
+
+// Analyzes now or as soon as the project is indexed
+void ProjectAnalysisDockWidget::analyze()
+{
+    if (!_index) return;
+
+    clearResults();
+
+    if (!_index->isReady())
+    {
+        _analyzeWhenReady = true;
+        _summary->setText("Indexing the project...");
+        return;
+    }
+
+    _analyzeWhenReady = false;
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer timer;
+    timer.start();
+    _issues = ProjectAnalyzer::analyze(*_index);
+    const qint64 elapsed = timer.elapsed();
+    showResults();
+    QApplication::restoreOverrideCursor();
+
+    _summary->setText(QString("%1 issues in %2 files, analyzed in %3 ms")
+                      .arg(_issues.size()).arg(_index->getFiles().size()).arg(elapsed));
+}
+
+// Shown results become outdated, but are kept until the user asks for a new analysis
+void ProjectAnalysisDockWidget::onIndexChanged()
+{
+    if (_analyzeWhenReady && _index && _index->isReady())
+        analyze();
+}
+
+void ProjectAnalysisDockWidget::onItemActivated(QTreeWidgetItem* item)
+{
+    const QString filePath = item->data(0, Qt::UserRole).toString();
+    if (!filePath.isEmpty()) emit fileOpenRequested(filePath);
+}
+
+void ProjectAnalysisDockWidget::onExportClicked()
+{
+    if (_issues.empty()) return;
+
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    const QString defaultPath = project ? project->getAbsolutePathOf("project_analysis.csv") : QString();
+    const QString filePath = QFileDialog::getSaveFileName(this, "Export analysis results", defaultPath, "CSV files (*.csv)");
+    if (filePath.isEmpty()) return;
+
+    if (!ProjectAnalyzer::exportToCsv(filePath, _issues, [this](const QString& path) { return getDisplayPath(path); }))
+        QMessageBox::critical(this, "Export failed", QString("Failed to write '%1'").arg(filePath));
+}
+
+void ProjectAnalysisDockWidget::clearResults()
+{
+    _issues.clear();
+    _results->clear();
+    _summary->clear();
+    _exportButton->setEnabled(false);
+}
+
+// Issues are sorted by kind and type, so groups are built in one pass
+void ProjectAnalysisDockWidget::showResults()
+{
+    _results->setUpdatesEnabled(false);
+
+    QTreeWidgetItem* kindItem = nullptr;
+    QTreeWidgetItem* typeItem = nullptr;
+    for (size_t i = 0; i < _issues.size(); ++i)
+    {
+        const auto& issue = _issues[i];
+
+        if (!kindItem || (i > 0 && _issues[i - 1].kind != issue.kind))
+        {
+            kindItem = new QTreeWidgetItem(QStringList(ProjectAnalyzer::getKindName(issue.kind)));
+            _results->addTopLevelItem(kindItem);
+            typeItem = nullptr;
+        }
+
+        if (!typeItem || _issues[i - 1].typeName != issue.typeName)
+            typeItem = new QTreeWidgetItem(kindItem, QStringList(issue.typeName));
+
+        QString text = issue.name + " - " + getDisplayPath(issue.filePath);
+        if (issue.line > 0) text += QString(":%1").arg(issue.line);
+        if (issue.count > 1) text += QString(" (%1 times)").arg(issue.count);
+
+        auto item = new QTreeWidgetItem(typeItem, QStringList(text));
+        item->setData(0, Qt::UserRole, issue.filePath);
+        item->setToolTip(0, issue.filePath);
+    }
+
+    // Append counts to group titles
+    for (int i = 0; i < _results->topLevelItemCount(); ++i)
+    {
+        auto group = _results->topLevelItem(i);
+        int count = 0;
+        for (int j = 0; j < group->childCount(); ++j)
+        {
+            auto subgroup = group->child(j);
+            subgroup->setText(0, QString("%1 (%2)").arg(subgroup->text(0)).arg(subgroup->childCount()));
+            count += subgroup->childCount();
+        }
+        group->setText(0, QString("%1 (%2)").arg(group->text(0)).arg(count));
+        group->setExpanded(true);
+    }
+
+    _results->setUpdatesEnabled(true);
+    _exportButton->setEnabled(!_issues.empty());
+}
+
+QString ProjectAnalysisDockWidget::getDisplayPath(const QString& absolutePath) const
+{
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    return project ? project->getRelativePathOf(absolutePath) : absolutePath;
+}
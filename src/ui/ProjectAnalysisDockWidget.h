@@ -0,0 +1,54 @@
+#ifndef PROJECTANALYSISDOCKWIDGET_H
+#define PROJECTANALYSISDOCKWIDGET_H
+
+#include <QDockWidget>
+#include "src/cegui/ProjectAnalyzer.h"
+
+// Shows unused and missing resources of the whole project found by the project analyzer,
+// grouped by the kind of issue and the resource type. Activating an item opens the file
+// in an editor. Results can be exported to CSV.
+
+class QLabel;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+class ProjectAnalysisDockWidget : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+
+    explicit ProjectAnalysisDockWidget(QWidget* parent = nullptr);
+
+    void setSymbolIndex(ProjectSymbolIndex* index);
+    void analyze();
+
+signals:
+
+    void fileOpenRequested(const QString& absolutePath);
+
+protected slots:
+
+    void onIndexChanged();
+    void onItemActivated(QTreeWidgetItem* item);
+    void onExportClicked();
+
+protected:
+
+    void clearResults();
+    void showResults();
+    QString getDisplayPath(const QString& absolutePath) const;
+
+    ProjectSymbolIndex* _index = nullptr;
+    QMetaObject::Connection _indexConnection;
+    std::vector<ProjectAnalyzer::Issue> _issues;
+    bool _analyzeWhenReady = false;
+
+    QPushButton* _analyzeButton = nullptr;
+    QPushButton* _exportButton = nullptr;
+    QLabel* _summary = nullptr;
+    QTreeWidget* _results = nullptr;
+};
+
+#endif // PROJECTANALYSISDOCKWIDGET_H
@@ -0,0 +1,123 @@
+#include "src/ui/ResourceDependenciesDockWidget.h"
+#include "src/cegui/ProjectSymbolIndex.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/CEGUIProject.h"
+#include "qlineedit.h"
+#include "qcompleter.h"
+#include "qstringlistmodel.h"
+#include "qtreewidget.h"
+#include "qboxlayout.h"
+#include "qdir.h"
+
+ResourceDependenciesDockWidget::ResourceDependenciesDockWidget(QWidget* parent)
+    : QDockWidget(parent)
+{
+    setObjectName("Resource Dependencies dock widget");
+    setWindowTitle("Resource Dependencies");
+
+    _completionModel = new QStringListModel(this);
+    auto completer = new QCompleter(_completionModel, this);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setFilterMode(Qt::MatchContains);
+
+    _file = new QLineEdit();
+    _file->setPlaceholderText("Project file");
+    _file->setClearButtonEnabled(true);
+    _file->setCompleter(completer);
+
+    _results = new QTreeWidget();
+    _results->setHeaderHidden(true);
+    _results->setUniformRowHeights(true);
+
+    auto contentsWidget = new QWidget();
+    auto contentsLayout = new QVBoxLayout(contentsWidget);
+    auto margins = contentsLayout->contentsMargins();
+    margins.setTop(0);
+    contentsLayout->setContentsMargins(margins);
+    contentsLayout->addWidget(_file);
+    contentsLayout->addWidget(_results);
+
+    setWidget(contentsWidget);
+
+    connect(_file, &QLineEdit::textChanged, this, &ResourceDependenciesDockWidget::refresh);
+    connect(_results, &QTreeWidget::itemActivated, this, &ResourceDependenciesDockWidget::onItemActivated);
+}
+
+void ResourceDependenciesDockWidget::setSymbolIndex(ProjectSymbolIndex* index)
+{
+    if (_index == index) return;
+
+    disconnect(_indexConnection);
+    _index = index;
+    if (_index)
+        _indexConnection = connect(_index, &ProjectSymbolIndex::indexChanged, this, &ResourceDependenciesDockWidget::onIndexChanged);
+
+    onIndexChanged();
+}
+
+void ResourceDependenciesDockWidget::showFile(const QString& absolutePath)
+{
+    _file->setText(getDisplayPath(absolutePath)); // Refreshes results
+}
+
+void ResourceDependenciesDockWidget::onIndexChanged()
+{
+    QStringList displayPaths;
+    if (_index)
+        for (const QString& filePath : _index->getFilePaths())
+            displayPaths.push_back(getDisplayPath(filePath));
+    _completionModel->setStringList(displayPaths);
+
+    refresh();
+}
+
+void ResourceDependenciesDockWidget::onItemActivated(QTreeWidgetItem* item)
+{
+    const QString filePath = item->data(0, Qt::UserRole).toString();
+    if (!filePath.isEmpty()) emit fileOpenRequested(filePath);
+}
+
+void ResourceDependenciesDockWidget::refresh()
+{
+    _results->clear();
+
+    const QString displayPath = _file->text().trimmed();
+    if (!_index || displayPath.isEmpty()) return;
+
+    if (!_index->isReady())
+    {
+        _results->addTopLevelItem(new QTreeWidgetItem(QStringList("Indexing the project...")));
+        return;
+    }
+
+    const QString filePath = getAbsolutePath(displayPath);
+    addFiles("Depends on", _index->getDependencies(filePath));
+    addFiles("Used by", _index->getDependents(filePath));
+    addFiles("Affected if changed", _index->getAffectedFiles(filePath));
+    _results->expandAll();
+}
+
+void ResourceDependenciesDockWidget::addFiles(const QString& title, const QStringList& filePaths)
+{
+    auto group = new QTreeWidgetItem(QStringList(QString("%1 (%2)").arg(title).arg(filePaths.size())));
+    _results->addTopLevelItem(group);
+
+    for (const QString& filePath : filePaths)
+    {
+        auto item = new QTreeWidgetItem(group, QStringList(getDisplayPath(filePath)));
+        item->setData(0, Qt::UserRole, filePath);
+        item->setToolTip(0, filePath);
+    }
+}
+
+QString ResourceDependenciesDockWidget::getDisplayPath(const QString& absolutePath) const
+{
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    return project ? project->getRelativePathOf(absolutePath) : absolutePath;
+}
+
+QString ResourceDependenciesDockWidget::getAbsolutePath(const QString& displayPath) const
+{
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    return QDir::cleanPath(project ? project->getAbsolutePathOf(displayPath) : displayPath);
+}
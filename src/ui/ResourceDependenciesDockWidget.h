@@ -0,0 +1,50 @@
+#ifndef RESOURCEDEPENDENCIESDOCKWIDGET_H
+#define RESOURCEDEPENDENCIESDOCKWIDGET_H
+
+#include <QDockWidget>
+
+// Shows which project files the given file depends on, which files use it directly and
+// everything affected if it changes. Follows the current editor, any file can be typed in.
+
+class ProjectSymbolIndex;
+class QLineEdit;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QStringListModel;
+
+class ResourceDependenciesDockWidget : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+
+    explicit ResourceDependenciesDockWidget(QWidget* parent = nullptr);
+
+    void setSymbolIndex(ProjectSymbolIndex* index);
+    void showFile(const QString& absolutePath);
+
+signals:
+
+    void fileOpenRequested(const QString& absolutePath);
+
+protected slots:
+
+    void onIndexChanged();
+    void onItemActivated(QTreeWidgetItem* item);
+
+protected:
+
+    void refresh();
+    void addFiles(const QString& title, const QStringList& filePaths);
+    QString getDisplayPath(const QString& absolutePath) const;
+    QString getAbsolutePath(const QString& displayPath) const;
+
+    ProjectSymbolIndex* _index = nullptr;
+    QMetaObject::Connection _indexConnection;
+
+    QLineEdit* _file = nullptr;
+    QStringListModel* _completionModel = nullptr;
+    QTreeWidget* _results = nullptr;
+};
+
+#endif // RESOURCEDEPENDENCIESDOCKWIDGET_H
@@ -0,0 +1,163 @@
+#include "src/ui/SymbolUsagesDockWidget.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/CEGUIProject.h"
+#include "src/ui/dialogs/RenameSymbolDialog.h"
+#include "qcombobox.h"
+#include "qlineedit.h"
+#include "qcompleter.h"
+#include "qstringlistmodel.h"
+#include "qtreewidget.h"
+#include "qheaderview.h"
+#include "qpushbutton.h"
+#include "qboxlayout.h"
+
+SymbolUsagesDockWidget::SymbolUsagesDockWidget(QWidget* parent)
+    : QDockWidget(parent)
+{
+    setObjectName("Find Usages dock widget");
+    setWindowTitle("Find Usages");
+
+    _type = new QComboBox();
+    for (int i = 0; i < static_cast<int>(ProjectSymbolIndex::SymbolType::Count); ++i)
+        _type->addItem(ProjectSymbolIndex::getTypeName(static_cast<ProjectSymbolIndex::SymbolType>(i)));
+    _type->setCurrentIndex(static_cast<int>(ProjectSymbolIndex::SymbolType::Image));
+
+    _completionModel = new QStringListModel(this);
+    auto completer = new QCompleter(_completionModel, this);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    completer->setFilterMode(Qt::MatchContains);
+    completer->setModelSorting(QCompleter::CaseSensitivelySortedModel);
+
+    _name = new QLineEdit();
+    _name->setPlaceholderText("Name");
+    _name->setClearButtonEnabled(true);
+    _name->setCompleter(completer);
+
+    _results = new QTreeWidget();
+    _results->setHeaderHidden(true);
+    _results->setUniformRowHeights(true);
+
+    _renameButton = new QPushButton("Rename...");
+    _renameButton->setToolTip("Renames the resource in all project files that define or use it");
+    _renameButton->setEnabled(false);
+
+    auto searchLayout = new QHBoxLayout();
+    searchLayout->addWidget(_type);
+    searchLayout->addWidget(_name, 1);
+    searchLayout->addWidget(_renameButton);
+
+    auto contentsWidget = new QWidget();
+    auto contentsLayout = new QVBoxLayout(contentsWidget);
+    auto margins = contentsLayout->contentsMargins();
+    margins.setTop(0);
+    contentsLayout->setContentsMargins(margins);
+    contentsLayout->addLayout(searchLayout);
+    contentsLayout->addWidget(_results);
+
+    setWidget(contentsWidget);
+
+    connect(_type, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &SymbolUsagesDockWidget::onTypeChanged);
+    connect(_name, &QLineEdit::textChanged, this, &SymbolUsagesDockWidget::refresh);
+    connect(_results, &QTreeWidget::itemActivated, this, &SymbolUsagesDockWidget::onItemActivated);
+    connect(_renameButton, &QPushButton::clicked, this, &SymbolUsagesDockWidget::onRenameClicked);
+}
+
+void SymbolUsagesDockWidget::setSymbolIndex(ProjectSymbolIndex* index)
+{
+    if (_index == index) return;
+
+    disconnect(_indexConnection);
+    _index = index;
+    if (_index)
+        _indexConnection = connect(_index, &ProjectSymbolIndex::indexChanged, this, &SymbolUsagesDockWidget::onIndexChanged);
+
+    onIndexChanged();
+}
+
+void SymbolUsagesDockWidget::showUsages(ProjectSymbolIndex::SymbolType type, const QString& name)
+{
+    {
+        const QSignalBlocker blocker(_type);
+        _type->setCurrentIndex(static_cast<int>(type));
+    }
+    _completionModel->setStringList(_index ? _index->getNames(type) : QStringList());
+    _name->setText(name); // Refreshes results
+
+    setVisible(true);
+    raise();
+}
+
+void SymbolUsagesDockWidget::renameSymbol(ProjectSymbolIndex::SymbolType type, const QString& name)
+{
+    if (!_index || !SymbolRenamer::canRename(type)) return;
+
+    RenameSymbolDialog dialog(*_index, type, name, this);
+    dialog.exec();
+}
+
+void SymbolUsagesDockWidget::onIndexChanged()
+{
+    onTypeChanged();
+}
+
+void SymbolUsagesDockWidget::onTypeChanged()
+{
+    const auto type = static_cast<ProjectSymbolIndex::SymbolType>(_type->currentIndex());
+    _completionModel->setStringList(_index ? _index->getNames(type) : QStringList());
+    refresh();
+}
+
+void SymbolUsagesDockWidget::onItemActivated(QTreeWidgetItem* item)
+{
+    const QString filePath = item->data(0, Qt::UserRole).toString();
+    if (!filePath.isEmpty()) emit fileOpenRequested(filePath);
+}
+
+void SymbolUsagesDockWidget::onRenameClicked()
+{
+    renameSymbol(static_cast<ProjectSymbolIndex::SymbolType>(_type->currentIndex()), _name->text().trimmed());
+}
+
+void SymbolUsagesDockWidget::refresh()
+{
+    _results->clear();
+    _renameButton->setEnabled(false);
+
+    const QString name = _name->text().trimmed();
+    if (!_index || name.isEmpty()) return;
+
+    if (!_index->isReady())
+    {
+        _results->addTopLevelItem(new QTreeWidgetItem(QStringList("Indexing the project...")));
+        return;
+    }
+
+    const auto type = static_cast<ProjectSymbolIndex::SymbolType>(_type->currentIndex());
+    const auto symbol = _index->getSymbol(type, name);
+    if (!symbol)
+    {
+        _results->addTopLevelItem(new QTreeWidgetItem(QStringList("Not found in the project")));
+        return;
+    }
+
+    addLocations("Definitions", symbol->definitions);
+    addLocations("Usages", symbol->usages);
+    _results->expandAll();
+
+    _renameButton->setEnabled(SymbolRenamer::canRename(type));
+}
+
+void SymbolUsagesDockWidget::addLocations(const QString& title, const std::vector<ProjectSymbolIndex::Location>& locations)
+{
+    auto group = new QTreeWidgetItem(QStringList(QString("%1 (%2)").arg(title).arg(locations.size())));
+    _results->addTopLevelItem(group);
+
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    for (const auto& location : locations)
+    {
+        const QString displayPath = project ? project->getRelativePathOf(location.filePath) : location.filePath;
+        auto item = new QTreeWidgetItem(group, QStringList(QString("%1:%2").arg(displayPath).arg(location.line)));
+        item->setData(0, Qt::UserRole, location.filePath);
+        item->setToolTip(0, location.filePath);
+    }
+}
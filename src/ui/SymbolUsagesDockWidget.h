@@ -0,0 +1,56 @@
+#ifndef SYMBOLUSAGESDOCKWIDGET_H
+#define SYMBOLUSAGESDOCKWIDGET_H
+
+#include <QDockWidget>
+#include "src/cegui/ProjectSymbolIndex.h"
+
+// Lists definitions and usages of a project resource (image, font, widget look etc) found
+// by the project symbol index. Activating a location opens the file in an editor. Found resources
+// can be renamed in all these files at once.
+
+class QComboBox;
+class QLineEdit;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+class QStringListModel;
+
+class SymbolUsagesDockWidget : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+
+    explicit SymbolUsagesDockWidget(QWidget* parent = nullptr);
+
+    void setSymbolIndex(ProjectSymbolIndex* index);
+    void showUsages(ProjectSymbolIndex::SymbolType type, const QString& name);
+    void renameSymbol(ProjectSymbolIndex::SymbolType type, const QString& name);
+
+signals:
+
+    void fileOpenRequested(const QString& absolutePath);
+
+protected slots:
+
+    void onIndexChanged();
+    void onTypeChanged();
+    void onItemActivated(QTreeWidgetItem* item);
+    void onRenameClicked();
+
+protected:
+
+    void refresh();
+    void addLocations(const QString& title, const std::vector<ProjectSymbolIndex::Location>& locations);
+
+    ProjectSymbolIndex* _index = nullptr;
+    QMetaObject::Connection _indexConnection;
+
+    QComboBox* _type = nullptr;
+    QLineEdit* _name = nullptr;
+    QStringListModel* _completionModel = nullptr;
+    QTreeWidget* _results = nullptr;
+    QPushButton* _renameButton = nullptr;
+};
+
+#endif // SYMBOLUSAGESDOCKWIDGET_H
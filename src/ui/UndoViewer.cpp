@@ -1,6 +1,11 @@
 #include "src/ui/UndoViewer.h"
+#include "src/editors/EditorBase.h"
+#include "src/util/UndoData.h"
 #include "qundoview.h"
+#include "qundostack.h"
 #include "qboxlayout.h"
+#include "qlabel.h"
+#include "qlocale.h"
 
 UndoViewer::UndoViewer(QWidget *parent) :
     QDockWidget(parent)
@@ -18,13 +23,42 @@ UndoViewer::UndoViewer(QWidget *parent) :
     contentsLayout->setContentsMargins(margins);
     contentsLayout->addWidget(view);
 
+    memoryLabel = new QLabel();
+    contentsLayout->addWidget(memoryLabel);
+
     setWidget(contentsWidget);
 }
 
-void UndoViewer::setUndoStack(QUndoStack* undoStack)
+void UndoViewer::setEditor(EditorBase* editor)
 {
+    disconnect(_indexChangedConnection);
+
+    _editor = editor;
+    auto undoStack = _editor ? _editor->getUndoStack() : nullptr;
     view->setStack(undoStack);
 
+    // Commands are added, merged and dropped only when the index changes
+    if (undoStack)
+        _indexChangedConnection = connect(undoStack, &QUndoStack::indexChanged, this, &UndoViewer::updateMemoryLabel);
+
+    updateMemoryLabel();
+
     // If stack is None this effectively disables the entire dock widget to improve UX
     setEnabled(!!undoStack);
 }
+
+void UndoViewer::updateMemoryLabel()
+{
+    if (!_editor || !_editor->getUndoStack())
+    {
+        memoryLabel->clear();
+        return;
+    }
+
+    const QLocale locale;
+    QString text = QString("History data: %1 in memory").arg(locale.formattedDataSize(static_cast<qint64>(_editor->getUndoMemoryFootprint())));
+    if (auto dataStore = _editor->getUndoDataStore())
+        if (dataStore->getSpilledSize())
+            text += QString(", %1 on disk").arg(locale.formattedDataSize(static_cast<qint64>(dataStore->getSpilledSize())));
+    memoryLabel->setText(text);
+}
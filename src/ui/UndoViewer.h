@@ -2,11 +2,13 @@
 #define UNDOVIEWER_H
 
 #include <QDockWidget>
+#include "qpointer.h"
 
-// A dockwidget able to view the entire undo history of given undo stack
+// A dockwidget able to view the entire undo history of given editor and the memory it occupies
 
 class QUndoView;
-class QUndoStack;
+class QLabel;
+class EditorBase;
 
 class UndoViewer : public QDockWidget
 {
@@ -16,11 +18,16 @@ public:
 
     explicit UndoViewer(QWidget *parent = nullptr);
 
-    void setUndoStack(QUndoStack* undoStack);
+    void setEditor(EditorBase* editor);
 
 protected:
 
+    void updateMemoryLabel();
+
     QUndoView* view = nullptr;
+    QLabel* memoryLabel = nullptr;
+    QPointer<EditorBase> _editor;
+    QMetaObject::Connection _indexChangedConnection;
 };
 
 #endif // UNDOVIEWER_H
@@ -0,0 +1,133 @@
+#include "src/ui/dialogs/RenameSymbolDialog.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/CEGUIProject.h"
+#include "src/editors/EditorBase.h"
+#include "src/ui/MainWindow.h"
+#include "src/Application.h"
+#include "qlineedit.h"
+#include "qlabel.h"
+#include "qplaintextedit.h"
+#include "qpushbutton.h"
+#include "qdialogbuttonbox.h"
+#include "qboxlayout.h"
+#include "qformlayout.h"
+#include "qmessagebox.h"
+#include "qfontdatabase.h"
+
+RenameSymbolDialog::RenameSymbolDialog(const ProjectSymbolIndex& index, ProjectSymbolIndex::SymbolType type, const QString& name, QWidget* parent)
+    : QDialog(parent)
+    , _index(index)
+    , _type(type)
+    , _oldName(name)
+{
+    setWindowTitle(QString("Rename %1").arg(ProjectSymbolIndex::getTypeName(type)));
+    resize(700, 500);
+
+    _newName = new QLineEdit(name);
+    _newName->selectAll();
+
+    _summary = new QLabel();
+    _summary->setWordWrap(true);
+
+    _diff = new QPlainTextEdit();
+    _diff->setReadOnly(true);
+    _diff->setLineWrapMode(QPlainTextEdit::NoWrap);
+    _diff->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    auto buttons = new QDialogButtonBox(QDialogButtonBox::Cancel);
+    _previewButton = buttons->addButton("&Preview", QDialogButtonBox::ActionRole);
+    _applyButton = buttons->addButton("&Rename", QDialogButtonBox::AcceptRole);
+    _previewButton->setDefault(true);
+    _applyButton->setEnabled(false);
+
+    auto formLayout = new QFormLayout();
+    formLayout->addRow("Old name:", new QLabel(name));
+    formLayout->addRow("New name:", _newName);
+
+    auto layout = new QVBoxLayout(this);
+    layout->addLayout(formLayout);
+    layout->addWidget(_summary);
+    layout->addWidget(_diff, 1);
+    layout->addWidget(buttons);
+
+    connect(_newName, &QLineEdit::textChanged, this, &RenameSymbolDialog::onNameChanged);
+    connect(_previewButton, &QPushButton::clicked, this, &RenameSymbolDialog::preview);
+    connect(_applyButton, &QPushButton::clicked, this, &RenameSymbolDialog::apply);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+}
+
+// A preview is valid only for the name it was made for
+void RenameSymbolDialog::onNameChanged()
+{
+    _renamer.reset();
+    _applyButton->setEnabled(false);
+    _previewButton->setDefault(true);
+    _summary->clear();
+    _diff->clear();
+}
+
+void RenameSymbolDialog::preview()
+{
+    onNameChanged();
+
+    auto renamer = std::make_unique<SymbolRenamer>(_index, _type, _oldName, _newName->text());
+    const QString error = renamer->validate();
+    if (!error.isEmpty())
+    {
+        _summary->setText(error);
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    renamer->prepare();
+    QApplication::restoreOverrideCursor();
+
+    if (renamer->getChanges().empty())
+    {
+        _summary->setText("Nothing to rename, the project index may be outdated");
+        return;
+    }
+
+    auto project = CEGUIManager::Instance().getCurrentProject();
+    _diff->setPlainText(renamer->getDiff([project](const QString& filePath)
+    {
+        return project ? project->getRelativePathOf(filePath) : filePath;
+    }));
+    _summary->setText(QString("%1 replacements in %2 files")
+                      .arg(renamer->getReplacementCount()).arg(renamer->getChanges().size()));
+
+    _renamer = std::move(renamer);
+    _applyButton->setEnabled(true);
+    _applyButton->setDefault(true);
+}
+
+void RenameSymbolDialog::apply()
+{
+    if (!_renamer) return;
+
+    // Files are replaced on disk, unsaved changes in editors would conflict with that
+    auto mainWindow = qobject_cast<Application*>(qApp)->getMainWindow();
+    QStringList unsavedFiles;
+    for (const auto& change : _renamer->getChanges())
+    {
+        auto editor = mainWindow->getEditorForFile(change.filePath);
+        if (editor && editor->hasChanges()) unsavedFiles.append(change.filePath);
+    }
+
+    if (!unsavedFiles.empty())
+    {
+        QMessageBox::warning(this, "Unsaved changes",
+                             "Save or discard changes in these files before renaming:\n\n" + unsavedFiles.join('\n'));
+        return;
+    }
+
+    const QString error = _renamer->apply();
+    if (!error.isEmpty())
+    {
+        QMessageBox::critical(this, "Rename failed", error);
+        onNameChanged();
+        return;
+    }
+
+    accept();
+}
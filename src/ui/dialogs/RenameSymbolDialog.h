@@ -0,0 +1,44 @@
+#ifndef RENAMESYMBOLDIALOG_H
+#define RENAMESYMBOLDIALOG_H
+
+#include <QDialog>
+#include "src/cegui/SymbolRenamer.h"
+#include <memory>
+
+// Asks for a new name of a project resource, previews changes in all affected files and applies them
+
+class QLineEdit;
+class QLabel;
+class QPlainTextEdit;
+class QPushButton;
+
+class RenameSymbolDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+
+    RenameSymbolDialog(const ProjectSymbolIndex& index, ProjectSymbolIndex::SymbolType type, const QString& name, QWidget* parent = nullptr);
+
+protected slots:
+
+    void onNameChanged();
+    void preview();
+    void apply();
+
+protected:
+
+    const ProjectSymbolIndex& _index;
+    ProjectSymbolIndex::SymbolType _type;
+    QString _oldName;
+
+    std::unique_ptr<SymbolRenamer> _renamer; // Prepared for the current new name, if previewed
+
+    QLineEdit* _newName = nullptr;
+    QLabel* _summary = nullptr;
+    QPlainTextEdit* _diff = nullptr;
+    QPushButton* _previewButton = nullptr;
+    QPushButton* _applyButton = nullptr;
+};
+
+#endif // RENAMESYMBOLDIALOG_H
@@ -3,14 +3,17 @@
 #include "src/ui/imageset/ImageLabel.h"
 #include "src/ui/imageset/ImageOffsetMark.h"
 #include "src/ui/imageset/ImagesetEditorDockWidget.h"
+#include "src/ui/imageset/ImageEntryListModel.h"
+#include "src/ui/imageset/ImageIssueListModel.h"
+#include "src/ui/imageset/ImagesetIssuesDockWidget.h"
+#include "src/ui/imageset/ImageUsageCounter.h"
+#include "src/editors/imageset/ImagesetVisualMode.h"
 #include "src/ui/MainWindow.h" // for status bar
-#include "src/util/Utils.h"
 #include "src/util/Settings.h"
 #include "src/Application.h"
 #include "qstatusbar.h"
 #include "qdom.h"
 #include "qpainter.h"
-#include "qlistwidget.h"
 #include <math.h>
 
 ImageEntry::ImageEntry(QGraphicsItem* parent)
@@ -30,12 +33,12 @@ ImageEntry::ImageEntry(QGraphicsItem* parent)
 
 ImageEntry::~ImageEntry()
 {
-    if (listItem)
-    {
-        listItem->setData(Qt::UserRole + 2, QVariant());
-        listItem = nullptr;
-        //???or delete list item?
-    }
+}
+
+ImagesetEditorDockWidget* ImageEntry::getDockWidget() const
+{
+    auto imagesetEntry = static_cast<ImagesetEntry*>(parentItem());
+    return imagesetEntry ? imagesetEntry->getVisualMode().getDockWidget() : nullptr;
 }
 
 // We simply round the rectangle because we only support "full" pixels
@@ -121,43 +124,27 @@ void ImageEntry::saveToElement(QDomElement& xml)
 // If we are selected in the dock widget, this updates the property box
 void ImageEntry::updateDockWidget()
 {
-    if (!listItem) return;
+    auto dockWidget = getDockWidget();
+    if (!dockWidget) return;
 
     updateListItem();
 
-    // TODO: redesign?
-    auto dockWidget = listItem->data(Qt::UserRole + 1).value<ImagesetEditorDockWidget*>();
     if (dockWidget->getActiveImageEntry() == this)
         dockWidget->refreshActiveImageEntry();
 }
 
 // Updates the list item associated with this image entry in the dock widget
+// Thumbnails are taken from the cache of the imageset by the list model itself
 void ImageEntry::updateListItem()
 {
-    if (!listItem) return;
-
-    listItem->setText(name());
-
-    QPixmap pixmap = getPixmap();
-    if (pixmap.isNull())
-    {
-        listItem->setIcon(QIcon());
-    }
-    else
-    {
-        constexpr int previewWidth = 24;
-        constexpr int previewHeight = 24;
-
-        QPixmap preview(previewWidth, previewHeight);
-        QPainter painter(&preview);
-        painter.setBrush(Utils::getCheckerboardBrush());
-        painter.drawRect(0, 0, previewWidth, previewHeight);
-        QPixmap scaledPixmap = getPixmap().scaled(QSize(previewWidth, previewHeight), Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        painter.drawPixmap((previewWidth - scaledPixmap.width()) / 2, (previewHeight - scaledPixmap.height()) / 2, scaledPixmap);
-        painter.end();
-
-        listItem->setIcon(QIcon(preview));
-    }
+    auto imagesetEntry = static_cast<ImagesetEntry*>(parentItem());
+    if (!imagesetEntry) return;
+
+    auto&& visualMode = imagesetEntry->getVisualMode();
+    if (auto dockWidget = visualMode.getDockWidget())
+        dockWidget->getImageListModel()->updateImageEntry(this);
+    if (auto issuesDockWidget = visualMode.getIssuesDockWidget())
+        issuesDockWidget->getModel()->updateImageEntry(this);
 }
 
 void ImageEntry::showLabel(bool show)
@@ -165,6 +152,13 @@ void ImageEntry::showLabel(bool show)
     label->setVisible(show);
 }
 
+// Returns the rectangle of the underlying image this ImageEntry has set
+QRect ImageEntry::getImageRect() const
+{
+    return QRect(static_cast<int>(pos().x()), static_cast<int>(pos().y()),
+                 static_cast<int>(rect().width()), static_cast<int>(rect().height()));
+}
+
 QString ImageEntry::name() const
 {
     return label->toPlainText();
@@ -236,6 +230,13 @@ void ImageEntry::paint(QPainter* painter, const QStyleOptionGraphicsItem* option
 {
     ResizableRectItem::paint(painter, option, widget);
 
+    ImagesetEntry* imagesetEntry = static_cast<ImagesetEntry*>(parentItem());
+    if (imagesetEntry->showUsageHeatmap())
+    {
+        auto counter = imagesetEntry->getVisualMode().getImageUsageCounter();
+        if (counter->isReady()) painter->fillRect(rect(), counter->getHeatColor(name()));
+    }
+
     // To be more visible, we draw yellow rect over the usual dashed double colour rect
     if (isSelected())
     {
@@ -286,7 +287,7 @@ QVariant ImageEntry::itemChange(GraphicsItemChange change, const QVariant& value
 
         // If, for whatever reason, the loading of the pixmap failed, we don't constrain to the empty null pixmap
         ImagesetEntry* imagesetEntry = static_cast<ImagesetEntry*>(parentItem());
-        if (!imagesetEntry->pixmap().isNull())
+        if (imagesetEntry->hasImage())
         {
             auto parentRect = imagesetEntry->boundingRect();
             parentRect.setWidth(parentRect.width() - rect().width());
@@ -321,8 +322,15 @@ void ImageEntry::hoverEnterEvent(QGraphicsSceneHoverEvent* event)
     if (settings->getEntryValue("imageset/visual/overlay_image_labels").toBool())
         label->setVisible(true);
 
-    app->getMainWindow()->setStatusMessage(QString("Image: '%1'\t\tXPos: %2, YPos: %3, Width: %4, Height: %5")
-                                                   .arg(name()).arg(pos().x()).arg(pos().y()).arg(rect().width()).arg(rect().height()));
+    QString status = QString("Image: '%1'\t\tXPos: %2, YPos: %3, Width: %4, Height: %5")
+            .arg(name()).arg(pos().x()).arg(pos().y()).arg(rect().width()).arg(rect().height());
+
+    ImagesetEntry* imagesetEntry = static_cast<ImagesetEntry*>(parentItem());
+    auto counter = imagesetEntry->getVisualMode().getImageUsageCounter();
+    if (imagesetEntry->showUsageHeatmap() && counter->isReady())
+        status += QString("\t\tReferences: %1").arg(counter->getCount(name()));
+
+    app->getMainWindow()->setStatusMessage(status);
 
     _isHovered = true;
 }
@@ -350,34 +358,10 @@ void ImageEntry::onPotentialMove(bool move)
     oldPosition.setY(-10000.0);
 }
 
-// Creates and returns a pixmap containing what's in the underlying image in the rectangle
-// that this ImageEntry has set. This is mostly used for preview thumbnails in the dock widget.
-QPixmap ImageEntry::getPixmap()
-{
-    ImagesetEntry* imagesetEntry = static_cast<ImagesetEntry*>(parentItem());
-
-    if (!imagesetEntry || imagesetEntry->pixmap().isNull())
-        return QPixmap();
-
-    return imagesetEntry->pixmap().copy(
-                static_cast<int>(pos().x()),
-                static_cast<int>(pos().y()),
-                static_cast<int>(rect().width()),
-                static_cast<int>(rect().height()));
-}
-
 // Synchronises the selection in the dock widget's list. This makes sure that when you select
 // this item the list sets the selection to this item as well.
 void ImageEntry::updateListItemSelection()
 {
-    if (!listItem) return;
-
-    auto dockWidget = listItem->data(Qt::UserRole + 1).value<ImagesetEditorDockWidget*>();
-
-    // The dock widget itself is performing a selection, we shall not interfere
-    if (dockWidget->isSelectionUnderway()) return;
-
-    dockWidget->setSelectionSynchronizationUnderway(true);
-    listItem->setSelected(isSelected() || isAnyHandleSelected() || offset->isSelected());
-    dockWidget->setSelectionSynchronizationUnderway(false);
+    auto dockWidget = getDockWidget();
+    if (dockWidget) dockWidget->setImageEntrySelected(this, isSelected() || isAnyHandleSelected() || offset->isSelected());
 }
@@ -6,7 +6,7 @@
 // Represents the image of the imageset, can be drag moved, selected, resized, ...
 
 class QDomElement;
-class QListWidgetItem;
+class ImagesetEditorDockWidget;
 class ImageLabel;
 class ImageOffsetMark;
 
@@ -27,11 +27,10 @@ public:
 
     void updateDockWidget();
     void updateListItem();
-    void setListItem(QListWidgetItem* newItem) { listItem = newItem; }
-    QListWidgetItem* getListItem() const { return listItem; }
     ImageOffsetMark* getOffsetMark() const { return offset; }
     void showLabel(bool show);
 
+    QRect getImageRect() const;
     QString name() const;
     void setName(const QString& newName);
     int offsetX() const;
@@ -57,12 +56,11 @@ protected:
     virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
     virtual QVariant itemChange(GraphicsItemChange change, const QVariant& value) override;
 
-    QPixmap getPixmap();
     void updateListItemSelection();
+    ImagesetEditorDockWidget* getDockWidget() const;
 
     ImageLabel* label = nullptr;
     ImageOffsetMark* offset = nullptr;
-    QListWidgetItem* listItem = nullptr; // This allows fast updates of the list item without looking it up
 
     QString autoScaled = "";
     int nativeHorzRes = 0;
@@ -75,6 +73,6 @@ protected:
     bool resized = false;
 };
 
-Q_DECLARE_METATYPE(ImageEntry*); // For storing in list items of the ImagesetEditorDockWidget
+Q_DECLARE_METATYPE(ImageEntry*); // For the UserRole of the ImageEntryListModel
 
 #endif // IMAGEENTRY_H
@@ -0,0 +1,491 @@
+#include "src/ui/imageset/ImageEntryListModel.h"
+#include "src/ui/imageset/ImagesetEntry.h"
+#include "src/ui/imageset/ImageEntry.h"
+#include "src/ui/imageset/ImageThumbnailCache.h"
+#include "src/ui/imageset/ImageIssueListModel.h"
+#include "qregularexpression.h"
+#include "qtimer.h"
+#include <algorithm>
+
+// Packs up to 3 UTF-16 characters with their count into one number, much cheaper than substrings
+static quint64 getNGramKey(const QChar* chars, int count)
+{
+    quint64 key = static_cast<quint64>(count);
+    for (int i = 0; i < count; ++i)
+        key = (key << 16) | chars[i].unicode();
+    return key;
+}
+
+// Parses 'width>N', 'width>=N', 'width<N' and 'width<=N' like words
+static bool parseLimit(const QString& word, const QString& propertyName, int& minValue, int& maxValue)
+{
+    if (!word.startsWith(propertyName) || word.size() <= propertyName.size()) return false;
+
+    const QChar op = word[propertyName.size()];
+    if (op != '>' && op != '<') return false;
+
+    int valueStart = propertyName.size() + 1;
+    const bool inclusive = (valueStart < word.size() && word[valueStart] == '=');
+    if (inclusive) ++valueStart;
+
+    bool ok = false;
+    const int value = word.mid(valueStart).toInt(&ok);
+    if (!ok) return false;
+
+    if (op == '>')
+        minValue = inclusive ? value : value + 1;
+    else
+        maxValue = inclusive ? value : value - 1;
+
+    return true;
+}
+
+ImageEntryListModel::Filter ImageEntryListModel::Filter::parse(const QString& text)
+{
+    Filter filter;
+    QStringList nameWords;
+
+    for (const QString& word : text.split(' '))
+    {
+        if (word.isEmpty()) continue;
+
+        const QString lowerWord = word.toLower();
+        if (lowerWord == "is:overlapping")
+            filter.overlappingOnly = true;
+        else if (lowerWord == "is:unused")
+            filter.unusedOnly = true;
+        else if (!parseLimit(lowerWord, "width", filter.minWidth, filter.maxWidth) &&
+                 !parseLimit(lowerWord, "height", filter.minHeight, filter.maxHeight))
+            nameWords.push_back(word);
+    }
+
+    filter.name = nameWords.join(' ');
+    return filter;
+}
+
+ImageEntryListModel::ImageEntryListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    _filterTimer = new QTimer(this);
+    _filterTimer->setSingleShot(true);
+    _filterTimer->setInterval(FilterDelayMs);
+    connect(_filterTimer, &QTimer::timeout, this, &ImageEntryListModel::applyFilter);
+}
+
+void ImageEntryListModel::setImagesetEntry(ImagesetEntry* imagesetEntry)
+{
+    disconnect(_thumbnailsConnection);
+
+    _imagesetEntry = imagesetEntry;
+    _thumbnailWaiters.clear();
+
+    if (_imagesetEntry)
+        _thumbnailsConnection = connect(&_imagesetEntry->getThumbnailCache(), &ImageThumbnailCache::thumbnailsReady, this, &ImageEntryListModel::onThumbnailsReady);
+
+    _items.clear();
+    _removedItemCount = 0;
+    if (_imagesetEntry)
+    {
+        _items.reserve(_imagesetEntry->getImageEntries().size());
+        for (ImageEntry* entry : _imagesetEntry->getImageEntries())
+        {
+            const QString name = entry->name();
+            _items.push_back({ entry, name, name.toLower(), entry->getImageRect() });
+        }
+    }
+
+    sortItems();
+    invalidateNameIndex();
+
+    // Another imageset, nothing to keep
+    beginResetModel();
+    collectRows();
+    endResetModel();
+}
+
+void ImageEntryListModel::setIssueModel(ImageIssueListModel* issueModel)
+{
+    if (_issueModel)
+        disconnect(_issueModel, &ImageIssueListModel::issuesChanged, this, &ImageEntryListModel::onIssuesChanged);
+
+    _issueModel = issueModel;
+
+    if (_issueModel)
+        connect(_issueModel, &ImageIssueListModel::issuesChanged, this, &ImageEntryListModel::onIssuesChanged);
+}
+
+void ImageEntryListModel::removeImageEntry(ImageEntry* entry)
+{
+    auto it = _itemIndices.find(entry);
+    if (it == _itemIndices.end()) return;
+
+    // The item is only marked as removed, so that indices of other items and the name index stay valid
+    _items[it->second].entry = nullptr;
+    _itemIndices.erase(it);
+    if (++_removedItemCount > _items.size() / 2)
+    {
+        updateItemIndices();
+        invalidateNameIndex();
+    }
+
+    auto rowIt = _rowIndices.find(entry);
+    if (rowIt == _rowIndices.end()) return;
+
+    const int row = rowIt->second;
+    beginRemoveRows(QModelIndex(), row, row);
+    _rows.erase(_rows.begin() + row);
+    _rowIndices.erase(rowIt);
+    for (int i = row; i < static_cast<int>(_rows.size()); ++i)
+        _rowIndices[_rows[static_cast<size_t>(i)]] = i;
+    endRemoveRows();
+}
+
+void ImageEntryListModel::removeImageEntries(const std::unordered_set<ImageEntry*>& entries)
+{
+    if (entries.empty()) return;
+
+    for (ImageEntry* entry : entries)
+    {
+        auto it = _itemIndices.find(entry);
+        if (it == _itemIndices.end()) continue;
+        _items[it->second].entry = nullptr;
+        ++_removedItemCount;
+    }
+
+    updateItemIndices();
+    invalidateNameIndex();
+
+    applyFilter();
+}
+
+// Called when the image is changed, only the row of the image is updated unless it must move or be filtered out
+void ImageEntryListModel::updateImageEntry(ImageEntry* entry)
+{
+    auto it = _itemIndices.find(entry);
+    if (it == _itemIndices.end()) return;
+
+    Item& item = _items[it->second];
+
+    const QString name = entry->name();
+    if (name != item.name)
+    {
+        item.name = name;
+        item.key = name.toLower();
+        sortItems();
+        invalidateNameIndex();
+        scheduleFilter();
+        return;
+    }
+
+    const QRect rect = entry->getImageRect();
+    if (rect != item.rect)
+    {
+        item.rect = rect;
+        if (_filter.dependsOnGeometry())
+        {
+            scheduleFilter();
+            return;
+        }
+    }
+
+    auto rowIt = _rowIndices.find(entry);
+    if (rowIt != _rowIndices.end())
+    {
+        const QModelIndex idx = index(rowIt->second);
+        emit dataChanged(idx, idx);
+    }
+}
+
+void ImageEntryListModel::setFilter(const Filter& filter)
+{
+    _filter = filter;
+    _filterTimer->start();
+}
+
+void ImageEntryListModel::setUsedImageNames(std::unordered_set<QString>&& names)
+{
+    _usedNames = std::move(names);
+    _usedNamesKnown = true;
+    if (_filter.unusedOnly) applyFilter();
+}
+
+ImageEntry* ImageEntryListModel::getImageEntry(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() >= static_cast<int>(_rows.size())) return nullptr;
+    return _rows[static_cast<size_t>(index.row())];
+}
+
+QModelIndex ImageEntryListModel::getIndex(ImageEntry* entry) const
+{
+    auto it = _rowIndices.find(entry);
+    return (it == _rowIndices.end()) ? QModelIndex() : index(it->second);
+}
+
+int ImageEntryListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(_rows.size());
+}
+
+QVariant ImageEntryListModel::data(const QModelIndex& index, int role) const
+{
+    ImageEntry* entry = getImageEntry(index);
+    if (!entry) return QVariant();
+
+    const Item& item = _items[_itemIndices.at(entry)];
+
+    switch (role)
+    {
+        case Qt::DisplayRole:
+        case Qt::EditRole:
+            return item.name;
+        case Qt::DecorationRole:
+        {
+            // Thumbnails are requested only for rows being shown, they come later through onThumbnailsReady()
+            if (!_imagesetEntry || !_imagesetEntry->hasImage()) return QVariant();
+            const QPixmap thumbnail = _imagesetEntry->getThumbnailCache().getThumbnail(item.rect);
+            if (!thumbnail.isNull()) return thumbnail;
+
+            auto& waiters = _thumbnailWaiters[item.rect];
+            if (std::find(waiters.begin(), waiters.end(), entry) == waiters.end())
+                waiters.push_back(entry);
+            return QVariant();
+        }
+        case Qt::ToolTipRole:
+            return QString("%1\nPosition: %2, %3\nSize: %4 x %5").arg(item.name)
+                    .arg(item.rect.x()).arg(item.rect.y()).arg(item.rect.width()).arg(item.rect.height());
+        case Qt::UserRole:
+            return QVariant::fromValue(entry);
+        default:
+            return QVariant();
+    }
+}
+
+// Renaming is done by the undo command, so the model only reports the request
+bool ImageEntryListModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+    ImageEntry* entry = getImageEntry(index);
+    if (!entry || role != Qt::EditRole) return false;
+
+    const QString newName = value.toString();
+    if (newName.isEmpty() || newName == _items[_itemIndices.at(entry)].name) return false;
+
+    emit renameRequested(entry, newName);
+    return true;
+}
+
+Qt::ItemFlags ImageEntryListModel::flags(const QModelIndex& index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    return Qt::ItemIsSelectable | Qt::ItemIsEditable | Qt::ItemIsEnabled;
+}
+
+void ImageEntryListModel::sortItems()
+{
+    std::sort(_items.begin(), _items.end(), [](const Item& a, const Item& b)
+    {
+        return (a.key == b.key) ? (a.name < b.name) : (a.key < b.key);
+    });
+
+    updateItemIndices();
+}
+
+// Drops items marked as removed and maps images to positions of their items
+void ImageEntryListModel::updateItemIndices()
+{
+    if (_removedItemCount)
+    {
+        _items.erase(std::remove_if(_items.begin(), _items.end(), [](const Item& item) { return !item.entry; }), _items.end());
+        _removedItemCount = 0;
+    }
+
+    _itemIndices.clear();
+    for (size_t i = 0; i < _items.size(); ++i)
+        _itemIndices.emplace(_items[i].entry, i);
+}
+
+void ImageEntryListModel::invalidateNameIndex()
+{
+    _nameIndex.clear();
+    _nameIndexValid = false;
+}
+
+// The index is built lazily on the first substring search after the list of names changes
+void ImageEntryListModel::ensureNameIndex()
+{
+    if (_nameIndexValid) return;
+
+    _nameIndex.clear();
+    for (size_t i = 0; i < _items.size(); ++i)
+    {
+        const QString& key = _items[i].key;
+        const quint32 itemIndex = static_cast<quint32>(i);
+        for (int pos = 0; pos < key.size(); ++pos)
+        {
+            for (int len = 1; len <= 3 && pos + len <= key.size(); ++len)
+            {
+                // Items are visited in order, so lists stay sorted and duplicates are adjacent
+                auto& itemIndices = _nameIndex[getNGramKey(key.constData() + pos, len)];
+                if (itemIndices.empty() || itemIndices.back() != itemIndex)
+                    itemIndices.push_back(itemIndex);
+            }
+        }
+    }
+
+    _nameIndexValid = true;
+}
+
+// Collects sorted indices of items matching the name filter
+void ImageEntryListModel::collectNameMatches(std::vector<size_t>& outItems)
+{
+    const QString query = _filter.name.toLower();
+
+    if (query.isEmpty() || query == "^")
+    {
+        outItems.reserve(_items.size());
+        for (size_t i = 0; i < _items.size(); ++i)
+            outItems.push_back(i);
+        return;
+    }
+
+    // Wildcards can't use the index, fall back to checking all names
+    if (query.contains('*') || query.contains('?'))
+    {
+        const QRegularExpression regex(QRegularExpression::wildcardToRegularExpression("*" + query + "*"));
+        for (size_t i = 0; i < _items.size(); ++i)
+            if (regex.match(_items[i].key).hasMatch())
+                outItems.push_back(i);
+        return;
+    }
+
+    // Prefix matches are a contiguous range of sorted keys
+    if (query.startsWith('^'))
+    {
+        const QString prefix = query.mid(1);
+        auto it = std::lower_bound(_items.begin(), _items.end(), prefix, [](const Item& item, const QString& value)
+        {
+            return item.key < value;
+        });
+        for (; it != _items.end() && it->key.startsWith(prefix); ++it)
+            outItems.push_back(static_cast<size_t>(it - _items.begin()));
+        return;
+    }
+
+    ensureNameIndex();
+
+    // Short queries are indexed as is
+    if (query.size() <= 3)
+    {
+        auto it = _nameIndex.find(getNGramKey(query.constData(), query.size()));
+        if (it != _nameIndex.end())
+            outItems.assign(it->second.begin(), it->second.end());
+        return;
+    }
+
+    // Longer ones are checked only against names containing their rarest trigram
+    const std::vector<quint32>* candidates = nullptr;
+    for (int pos = 0; pos + 3 <= query.size(); ++pos)
+    {
+        auto it = _nameIndex.find(getNGramKey(query.constData() + pos, 3));
+        if (it == _nameIndex.end()) return;
+        if (!candidates || it->second.size() < candidates->size())
+            candidates = &it->second;
+    }
+
+    for (quint32 i : *candidates)
+        if (_items[i].key.contains(query))
+            outItems.push_back(i);
+}
+
+bool ImageEntryListModel::passesNonNameFilters(const Item& item) const
+{
+    const QRect& rect = item.rect;
+    if (_filter.minWidth >= 0 && rect.width() < _filter.minWidth) return false;
+    if (_filter.maxWidth >= 0 && rect.width() > _filter.maxWidth) return false;
+    if (_filter.minHeight >= 0 && rect.height() < _filter.minHeight) return false;
+    if (_filter.maxHeight >= 0 && rect.height() > _filter.maxHeight) return false;
+    if (_filter.overlappingOnly && (!_issueModel || !_issueModel->isOverlapping(item.entry))) return false;
+
+    // Until the project is scanned, nothing is considered unused
+    if (_filter.unusedOnly && (!_usedNamesKnown || _usedNames.find(item.name) != _usedNames.end())) return false;
+
+    return true;
+}
+
+void ImageEntryListModel::collectRows()
+{
+    std::vector<size_t> matches;
+    collectNameMatches(matches);
+
+    _rows.clear();
+    _rowIndices.clear();
+    for (size_t i : matches)
+    {
+        const Item& item = _items[i];
+        if (!item.entry || !passesNonNameFilters(item)) continue;
+
+        _rowIndices.emplace(item.entry, static_cast<int>(_rows.size()));
+        _rows.push_back(item.entry);
+    }
+}
+
+// Filtering is a layout change rather than a reset, so that views keep the selection and the scroll position
+void ImageEntryListModel::applyFilter()
+{
+    _filterScheduled = false;
+    _filterTimer->stop();
+
+    emit layoutAboutToBeChanged();
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+    std::vector<ImageEntry*> oldEntries;
+    oldEntries.reserve(static_cast<size_t>(oldIndexes.size()));
+    for (const QModelIndex& oldIndex : oldIndexes)
+        oldEntries.push_back(getImageEntry(oldIndex));
+
+    collectRows();
+
+    if (!oldIndexes.empty())
+    {
+        QModelIndexList newIndexes;
+        for (ImageEntry* entry : oldEntries)
+            newIndexes.push_back(getIndex(entry));
+        changePersistentIndexList(oldIndexes, newIndexes);
+    }
+
+    emit layoutChanged();
+}
+
+// Several changes in a row (e.g. moving multiple images) cause only one filtering
+void ImageEntryListModel::scheduleFilter()
+{
+    if (_filterScheduled) return;
+    _filterScheduled = true;
+    QTimer::singleShot(0, this, &ImageEntryListModel::applyFilter);
+}
+
+void ImageEntryListModel::onIssuesChanged()
+{
+    if (_filter.overlappingOnly) scheduleFilter();
+}
+
+void ImageEntryListModel::onThumbnailsReady(const QVector<QRect>& rects)
+{
+    for (const QRect& rect : rects)
+    {
+        auto it = _thumbnailWaiters.find(rect);
+        if (it == _thumbnailWaiters.end()) continue;
+
+        // Images might have been moved or filtered out while waiting
+        for (ImageEntry* entry : it->second)
+        {
+            auto itemIt = _itemIndices.find(entry);
+            auto rowIt = _rowIndices.find(entry);
+            if (itemIt == _itemIndices.end() || rowIt == _rowIndices.end() || _items[itemIt->second].rect != rect) continue;
+
+            const QModelIndex idx = index(rowIt->second);
+            emit dataChanged(idx, idx, { Qt::DecorationRole });
+        }
+
+        _thumbnailWaiters.erase(it);
+    }
+}
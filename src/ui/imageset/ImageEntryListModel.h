@@ -0,0 +1,119 @@
+#ifndef IMAGEENTRYLISTMODEL_H
+#define IMAGEENTRYLISTMODEL_H
+
+#include "qabstractitemmodel.h"
+#include "qrect.h"
+#include "qvector.h"
+#include "src/QtStdHash.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// List of images of the imageset for the ImagesetEditorDockWidget. Images are kept sorted by name
+// with an n-gram index over lowercase names, so that name filtering touches only matching images
+// and stays responsive on imagesets with 100k images. Filtering by size, overlapping and usage in
+// the project is also supported. The model shows filtered images only. Overlaps are taken from the
+// issue list model, which keeps them up to date incrementally.
+
+class ImagesetEntry;
+class ImageEntry;
+class ImageIssueListModel;
+class QTimer;
+
+class ImageEntryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+
+    // Parsed from the filter box text. Plain words filter names by substring, '^' at the beginning
+    // means prefix, '*' and '?' are wildcards. Special words: 'width>N', 'width<N', 'height>N',
+    // 'height<N', 'is:overlapping', 'is:unused'.
+    struct Filter
+    {
+        QString name;
+        int minWidth = -1;
+        int maxWidth = -1;
+        int minHeight = -1;
+        int maxHeight = -1;
+        bool overlappingOnly = false;
+        bool unusedOnly = false;
+
+        static Filter parse(const QString& text);
+        bool dependsOnGeometry() const { return minWidth >= 0 || maxWidth >= 0 || minHeight >= 0 || maxHeight >= 0 || overlappingOnly; }
+    };
+
+    ImageEntryListModel(QObject* parent = nullptr);
+
+    void setImagesetEntry(ImagesetEntry* imagesetEntry);
+    void setIssueModel(ImageIssueListModel* issueModel);
+    void removeImageEntry(ImageEntry* entry);
+    void removeImageEntries(const std::unordered_set<ImageEntry*>& entries);
+    void updateImageEntry(ImageEntry* entry);
+
+    void setFilter(const Filter& filter);
+    const Filter& getFilter() const { return _filter; }
+    void setUsedImageNames(std::unordered_set<QString>&& names);
+    bool hasUsedImageNames() const { return _usedNamesKnown; }
+
+    ImageEntry* getImageEntry(const QModelIndex& index) const;
+    QModelIndex getIndex(ImageEntry* entry) const;
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    virtual bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+signals:
+
+    void renameRequested(ImageEntry* entry, const QString& newName);
+
+protected:
+
+    struct Item
+    {
+        ImageEntry* entry;
+        QString name;
+        QString key; // Lowercase name
+        QRect rect;
+    };
+
+    static constexpr int FilterDelayMs = 150;
+
+    void sortItems();
+    void updateItemIndices();
+    void invalidateNameIndex();
+    void ensureNameIndex();
+    void collectNameMatches(std::vector<size_t>& outItems);
+    bool passesNonNameFilters(const Item& item) const;
+    void collectRows();
+    void applyFilter();
+    void scheduleFilter();
+    void onIssuesChanged();
+    void onThumbnailsReady(const QVector<QRect>& rects);
+
+    ImagesetEntry* _imagesetEntry = nullptr;
+    ImageIssueListModel* _issueModel = nullptr;
+
+    std::vector<Item> _items; // Sorted by key, removed items have no entry until compacted
+    std::unordered_map<ImageEntry*, size_t> _itemIndices;
+    size_t _removedItemCount = 0;
+
+    std::unordered_map<quint64, std::vector<quint32>> _nameIndex; // 1, 2 and 3 character n-grams to sorted item indices
+    bool _nameIndexValid = false;
+
+    std::unordered_set<QString> _usedNames;
+    bool _usedNamesKnown = false;
+
+    Filter _filter;
+    std::vector<ImageEntry*> _rows;
+    std::unordered_map<ImageEntry*, int> _rowIndices;
+    bool _filterScheduled = false;
+    QTimer* _filterTimer = nullptr; // Typing in the filter box is debounced
+
+    // Shown images waiting for their thumbnails, so that ready thumbnails don't require scanning all images
+    mutable std::unordered_map<QRect, std::vector<ImageEntry*>> _thumbnailWaiters;
+    QMetaObject::Connection _thumbnailsConnection;
+};
+
+#endif // IMAGEENTRYLISTMODEL_H
@@ -0,0 +1,376 @@
+#include "src/ui/imageset/ImageIssueListModel.h"
+#include "src/ui/imageset/ImagesetEntry.h"
+#include "src/ui/imageset/ImageEntry.h"
+#include "qtimer.h"
+#include <algorithm>
+#include <functional>
+
+static quint64 getCellKey(int x, int y)
+{
+    return (static_cast<quint64>(static_cast<quint32>(x)) << 32) | static_cast<quint32>(y);
+}
+
+// Grid cells covered by the rect, floor division keeps negative coordinates in their own cells
+static QRect getCellRange(const QRect& rect, int cellSize)
+{
+    auto toCell = [cellSize](int value) { return (value >= 0) ? (value / cellSize) : ((value + 1) / cellSize - 1); };
+    return QRect(QPoint(toCell(rect.left()), toCell(rect.top())), QPoint(toCell(rect.right()), toCell(rect.bottom())));
+}
+
+ImageIssueListModel::ImageIssueListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+}
+
+void ImageIssueListModel::setImagesetEntry(ImagesetEntry* imagesetEntry)
+{
+    _imagesetEntry = imagesetEntry;
+    _dirty.clear();
+    _namesChanged = false;
+
+    analyzeAll();
+    rebuildRows();
+}
+
+void ImageIssueListModel::removeImageEntries(const std::unordered_set<ImageEntry*>& entries)
+{
+    if (entries.empty()) return;
+
+    for (ImageEntry* entry : entries)
+    {
+        removeOverlaps(entry);
+        auto it = _rects.find(entry);
+        if (it != _rects.end())
+        {
+            removeFromGrid(entry, it->second);
+            _rects.erase(it);
+        }
+        _outOfBounds.erase(entry);
+        _dirty.erase(entry);
+    }
+
+    // Rows must not reference deleted images, so this is not postponed. Remaining rows are
+    // already sorted, just drop the ones of removed images.
+    beginResetModel();
+    _rows.erase(std::remove_if(_rows.begin(), _rows.end(), [&entries](const Issue& issue)
+    {
+        return entries.find(issue.first) != entries.end() || (issue.second && entries.find(issue.second) != entries.end());
+    }), _rows.end());
+    endResetModel();
+
+    emit issuesChanged();
+}
+
+// Changes are collected and analysed together, many images are often changed at once
+void ImageIssueListModel::updateImageEntry(ImageEntry* entry)
+{
+    if (!_imagesetEntry) return;
+
+    auto it = _rects.find(entry);
+    if (it != _rects.end() && it->second == entry->getImageRect() && _bounds == getImageBounds())
+    {
+        // The image might have been renamed, texts of its issues must be updated
+        if (_overlaps.find(entry) == _overlaps.end() && _outOfBounds.find(entry) == _outOfBounds.end()) return;
+        _namesChanged = true;
+    }
+    else
+    {
+        _dirty.insert(entry);
+    }
+
+    scheduleUpdates();
+}
+
+const ImageIssueListModel::Issue* ImageIssueListModel::getIssue(const QModelIndex& index) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= static_cast<int>(_rows.size())) return nullptr;
+    return &_rows[static_cast<size_t>(index.row())];
+}
+
+int ImageIssueListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(_rows.size());
+}
+
+QVariant ImageIssueListModel::data(const QModelIndex& index, int role) const
+{
+    const Issue* issue = getIssue(index);
+    if (!issue) return QVariant();
+
+    switch (role)
+    {
+        case Qt::DisplayRole:
+            return issue->text;
+        case Qt::ToolTipRole:
+        {
+            auto rectToString = [](const QRect& rect)
+            {
+                return QString("%1, %2, %3 x %4").arg(rect.x()).arg(rect.y()).arg(rect.width()).arg(rect.height());
+            };
+
+            QString toolTip = rectToString(issue->first->getImageRect());
+            if (issue->second)
+                toolTip += "\n" + rectToString(issue->second->getImageRect());
+            else
+                toolTip += "\nImage bounds: " + rectToString(_bounds);
+            return toolTip;
+        }
+        default:
+            return QVariant();
+    }
+}
+
+QRect ImageIssueListModel::getImageBounds() const
+{
+    return (_imagesetEntry && _imagesetEntry->hasImage()) ? QRect(QPoint(0, 0), _imagesetEntry->getImage().size()) : QRect();
+}
+
+void ImageIssueListModel::addOverlap(ImageEntry* a, ImageEntry* b)
+{
+    _overlaps[a].insert(b);
+    _overlaps[b].insert(a);
+    ++_overlapCount;
+}
+
+void ImageIssueListModel::removeOverlaps(ImageEntry* entry)
+{
+    auto it = _overlaps.find(entry);
+    if (it == _overlaps.end()) return;
+
+    for (ImageEntry* other : it->second)
+    {
+        auto otherIt = _overlaps.find(other);
+        otherIt->second.erase(entry);
+        if (otherIt->second.empty()) _overlaps.erase(otherIt);
+        --_overlapCount;
+    }
+
+    _overlaps.erase(it);
+}
+
+bool ImageIssueListModel::isInGrid(const QRect& rect) const
+{
+    const QRect cells = getCellRange(rect, GridCellSize);
+    return static_cast<qint64>(cells.width()) * cells.height() <= MaxGridCellsPerImage;
+}
+
+void ImageIssueListModel::addToGrid(ImageEntry* entry, const QRect& rect)
+{
+    if (rect.isEmpty()) return;
+
+    if (!isInGrid(rect))
+    {
+        _largeImages.insert(entry);
+        return;
+    }
+
+    const QRect cells = getCellRange(rect, GridCellSize);
+    for (int y = cells.top(); y <= cells.bottom(); ++y)
+        for (int x = cells.left(); x <= cells.right(); ++x)
+            _grid[getCellKey(x, y)].push_back(entry);
+}
+
+void ImageIssueListModel::removeFromGrid(ImageEntry* entry, const QRect& rect)
+{
+    if (rect.isEmpty()) return;
+
+    if (!isInGrid(rect))
+    {
+        _largeImages.erase(entry);
+        return;
+    }
+
+    const QRect cells = getCellRange(rect, GridCellSize);
+    for (int y = cells.top(); y <= cells.bottom(); ++y)
+    {
+        for (int x = cells.left(); x <= cells.right(); ++x)
+        {
+            auto it = _grid.find(getCellKey(x, y));
+            if (it == _grid.end()) continue;
+
+            auto& cellEntries = it->second;
+            auto entryIt = std::find(cellEntries.begin(), cellEntries.end(), entry);
+            if (entryIt != cellEntries.end())
+            {
+                *entryIt = cellEntries.back();
+                cellEntries.pop_back();
+            }
+            if (cellEntries.empty()) _grid.erase(it);
+        }
+    }
+}
+
+void ImageIssueListModel::analyzeAll()
+{
+    _rects.clear();
+    _overlaps.clear();
+    _outOfBounds.clear();
+    _grid.clear();
+    _largeImages.clear();
+    _overlapCount = 0;
+    _bounds = getImageBounds();
+
+    if (!_imagesetEntry) return;
+
+    std::vector<std::pair<QRect, ImageEntry*>> sorted;
+    sorted.reserve(_imagesetEntry->getImageEntries().size());
+    for (ImageEntry* entry : _imagesetEntry->getImageEntries())
+    {
+        const QRect rect = entry->getImageRect();
+        _rects.emplace(entry, rect);
+        addToGrid(entry, rect);
+        sorted.emplace_back(rect, entry);
+        if (isOutOfBounds(rect)) _outOfBounds.insert(entry);
+    }
+
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<QRect, ImageEntry*>& a, const std::pair<QRect, ImageEntry*>& b)
+    {
+        return a.first.left() < b.first.left();
+    });
+
+    // Sweep along X, only images starting before the end of the current one can overlap it
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+        const QRect& rect = sorted[i].first;
+        for (size_t j = i + 1; j < sorted.size() && sorted[j].first.left() <= rect.right(); ++j)
+            if (rect.intersects(sorted[j].first))
+                addOverlap(sorted[i].second, sorted[j].second);
+    }
+}
+
+// Checks one changed image against images sharing grid cells with it and against large images.
+// Other changed images are analysed after it, so they will fix their pairs with this image if it
+// was checked against their outdated rects.
+void ImageIssueListModel::analyzeImage(ImageEntry* entry)
+{
+    removeOverlaps(entry);
+
+    const QRect rect = entry->getImageRect();
+    auto it = _rects.find(entry);
+    if (it != _rects.end())
+    {
+        removeFromGrid(entry, it->second);
+        it->second = rect;
+    }
+    else
+    {
+        _rects.emplace(entry, rect);
+    }
+
+    if (isOutOfBounds(rect))
+        _outOfBounds.insert(entry);
+    else
+        _outOfBounds.erase(entry);
+
+    // A large image has no cells of its own, everything must be checked
+    if (!isInGrid(rect))
+    {
+        for (const auto& pair : _rects)
+            if (pair.first != entry && rect.intersects(pair.second))
+                addOverlap(entry, pair.first);
+        addToGrid(entry, rect);
+        return;
+    }
+
+    // The same neighbour may share several cells with the image
+    std::unordered_set<ImageEntry*> candidates(_largeImages.begin(), _largeImages.end());
+    const QRect cells = getCellRange(rect, GridCellSize);
+    for (int y = cells.top(); y <= cells.bottom(); ++y)
+    {
+        for (int x = cells.left(); x <= cells.right(); ++x)
+        {
+            auto cellIt = _grid.find(getCellKey(x, y));
+            if (cellIt != _grid.end())
+                candidates.insert(cellIt->second.begin(), cellIt->second.end());
+        }
+    }
+
+    for (ImageEntry* other : candidates)
+        if (other != entry && rect.intersects(_rects.at(other)))
+            addOverlap(entry, other);
+
+    addToGrid(entry, rect);
+}
+
+void ImageIssueListModel::applyUpdates()
+{
+    _updatesScheduled = false;
+
+    if (!_imagesetEntry || (_dirty.empty() && !_namesChanged)) return;
+
+    // The sweep is cheaper than checking many images one by one
+    if (_dirty.size() > MaxIncrementalUpdates)
+    {
+        analyzeAll();
+    }
+    else
+    {
+        const QRect bounds = getImageBounds();
+        if (_bounds != bounds)
+        {
+            _bounds = bounds;
+            _outOfBounds.clear();
+            for (const auto& pair : _rects)
+                if (isOutOfBounds(pair.second))
+                    _outOfBounds.insert(pair.first);
+        }
+
+        for (ImageEntry* entry : _dirty)
+            analyzeImage(entry);
+    }
+
+    _dirty.clear();
+    _namesChanged = false;
+    rebuildRows();
+}
+
+void ImageIssueListModel::scheduleUpdates()
+{
+    if (_updatesScheduled) return;
+    _updatesScheduled = true;
+    QTimer::singleShot(0, this, &ImageIssueListModel::applyUpdates);
+}
+
+void ImageIssueListModel::rebuildRows()
+{
+    beginResetModel();
+
+    _rows.clear();
+
+    // Names are taken from image labels, don't ask twice
+    std::unordered_map<ImageEntry*, QString> names;
+    auto getName = [&names](ImageEntry* entry) -> const QString&
+    {
+        auto it = names.find(entry);
+        if (it == names.end()) it = names.emplace(entry, entry->name()).first;
+        return it->second;
+    };
+
+    for (ImageEntry* entry : _outOfBounds)
+        _rows.push_back({ entry, nullptr, QString("'%1' is out of the image bounds").arg(getName(entry)) });
+
+    for (const auto& pair : _overlaps)
+    {
+        for (ImageEntry* other : pair.second)
+        {
+            // Each pair is stored in both directions
+            if (!std::less<ImageEntry*>()(pair.first, other)) continue;
+
+            ImageEntry* first = pair.first;
+            ImageEntry* second = other;
+            if (getName(second) < getName(first)) std::swap(first, second);
+
+            _rows.push_back({ first, second, QString("'%1' overlaps '%2'").arg(getName(first), getName(second)) });
+        }
+    }
+
+    std::sort(_rows.begin(), _rows.end(), [](const Issue& a, const Issue& b)
+    {
+        if (!a.second != !b.second) return !a.second;
+        return a.text < b.text;
+    });
+
+    endResetModel();
+
+    emit issuesChanged();
+}
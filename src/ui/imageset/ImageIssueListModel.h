@@ -0,0 +1,86 @@
+#ifndef IMAGEISSUELISTMODEL_H
+#define IMAGEISSUELISTMODEL_H
+
+#include "qabstractitemmodel.h"
+#include "qrect.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Lists all pairs of overlapping images and all images out of the imageset image bounds.
+// The whole imageset is analysed with a sweep along X, after that only changed images
+// are checked against their neighbours found through a uniform grid, so that moving images
+// around stays interactive on huge imagesets.
+
+class ImagesetEntry;
+class ImageEntry;
+
+class ImageIssueListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+
+    struct Issue
+    {
+        ImageEntry* first;
+        ImageEntry* second; // nullptr for out of bounds issues
+        QString text;
+    };
+
+    ImageIssueListModel(QObject* parent = nullptr);
+
+    void setImagesetEntry(ImagesetEntry* imagesetEntry);
+    void removeImageEntries(const std::unordered_set<ImageEntry*>& entries);
+    void updateImageEntry(ImageEntry* entry);
+
+    const Issue* getIssue(const QModelIndex& index) const;
+    bool isOverlapping(ImageEntry* entry) const { return _overlaps.find(entry) != _overlaps.end(); }
+    size_t getOverlapCount() const { return _overlapCount; }
+    size_t getOutOfBoundsCount() const { return _outOfBounds.size(); }
+
+    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+signals:
+
+    void issuesChanged();
+
+protected:
+
+    static constexpr size_t MaxIncrementalUpdates = 64;
+    static constexpr int GridCellSize = 128;
+    static constexpr int MaxGridCellsPerImage = 64; // Larger images are checked against all others
+
+    void analyzeAll();
+    void analyzeImage(ImageEntry* entry);
+    void addOverlap(ImageEntry* a, ImageEntry* b);
+    void removeOverlaps(ImageEntry* entry);
+    void addToGrid(ImageEntry* entry, const QRect& rect);
+    void removeFromGrid(ImageEntry* entry, const QRect& rect);
+    bool isInGrid(const QRect& rect) const;
+    QRect getImageBounds() const;
+    bool isOutOfBounds(const QRect& rect) const { return !_bounds.isNull() && !_bounds.contains(rect); }
+    void applyUpdates();
+    void scheduleUpdates();
+    void rebuildRows();
+
+    ImagesetEntry* _imagesetEntry = nullptr;
+    QRect _bounds;
+
+    std::unordered_map<ImageEntry*, QRect> _rects;
+    std::unordered_map<ImageEntry*, std::unordered_set<ImageEntry*>> _overlaps; // Both directions are stored
+    std::unordered_set<ImageEntry*> _outOfBounds;
+    size_t _overlapCount = 0;
+
+    std::unordered_map<quint64, std::vector<ImageEntry*>> _grid; // Cell to images intersecting it
+    std::unordered_set<ImageEntry*> _largeImages; // Too large for the grid
+
+    std::unordered_set<ImageEntry*> _dirty;
+    bool _namesChanged = false;
+    bool _updatesScheduled = false;
+
+    std::vector<Issue> _rows;
+};
+
+#endif // IMAGEISSUELISTMODEL_H
@@ -0,0 +1,200 @@
+#include "src/ui/imageset/ImageThumbnailCache.h"
+#include "src/util/Utils.h"
+#include "qpainter.h"
+#include "qtimer.h"
+#include "qfuturewatcher.h"
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <cstring>
+#include <algorithm>
+
+static constexpr int BatchSize = 128;
+static constexpr size_t MaxThumbnails = 100000;
+
+// Images must have the same format, otherwise they are considered completely different
+ImageChanges ImageChanges::compare(const QImage& oldImage, const QImage& newImage)
+{
+    ImageChanges changes;
+    changes.size = newImage.size();
+
+    if (oldImage.size() != newImage.size() || oldImage.format() != newImage.format() || newImage.depth() < 8)
+    {
+        changes.all = true;
+        changes.any = true;
+        return changes;
+    }
+
+    const int width = newImage.width();
+    const int height = newImage.height();
+    const int bytesPerPixel = newImage.depth() / 8;
+    changes.blocksPerRow = (width + BlockSize - 1) / BlockSize;
+    changes.blocks.assign(static_cast<size_t>(changes.blocksPerRow * ((height + BlockSize - 1) / BlockSize)), false);
+
+    for (int y = 0; y < height; ++y)
+    {
+        const uchar* oldLine = oldImage.constScanLine(y);
+        const uchar* newLine = newImage.constScanLine(y);
+
+        // Most lines are usually untouched
+        if (!std::memcmp(oldLine, newLine, static_cast<size_t>(width * bytesPerPixel))) continue;
+
+        const size_t rowStart = static_cast<size_t>((y / BlockSize) * changes.blocksPerRow);
+        for (int blockX = 0; blockX < changes.blocksPerRow; ++blockX)
+        {
+            auto&& block = changes.blocks[rowStart + static_cast<size_t>(blockX)];
+            if (block) continue;
+
+            const int offset = blockX * BlockSize * bytesPerPixel;
+            const int length = std::min(BlockSize, width - blockX * BlockSize) * bytesPerPixel;
+            if (std::memcmp(oldLine + offset, newLine + offset, static_cast<size_t>(length)))
+            {
+                block = true;
+                changes.any = true;
+            }
+        }
+    }
+
+    return changes;
+}
+
+bool ImageChanges::intersects(const QRect& rect) const
+{
+    if (all) return true;
+    if (!any) return false;
+
+    const QRect clipped = rect.intersected(QRect(QPoint(0, 0), size));
+    if (clipped.isEmpty()) return false;
+
+    for (int blockY = clipped.top() / BlockSize; blockY <= clipped.bottom() / BlockSize; ++blockY)
+        for (int blockX = clipped.left() / BlockSize; blockX <= clipped.right() / BlockSize; ++blockX)
+            if (blocks[static_cast<size_t>(blockY * blocksPerRow + blockX)])
+                return true;
+
+    return false;
+}
+
+ImageThumbnailCache::ImageThumbnailCache(QObject* parent)
+    : QObject(parent)
+{
+    // Checkerboard brush is QPixmap based and can't be used in worker threads, prepare the background here
+    _background = QImage(ThumbnailSize, ThumbnailSize, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&_background);
+    painter.setBrush(Utils::getCheckerboardBrush());
+    painter.drawRect(0, 0, ThumbnailSize, ThumbnailSize);
+    painter.end();
+}
+
+// Only thumbnails of changed regions are dropped, pending requests are restarted by the next getThumbnail()
+void ImageThumbnailCache::updateSourceImage(const QImage& image, const ImageChanges& changes)
+{
+    ++_generation;
+    _sourceImage = image;
+    _pending.clear();
+    _requests.clear();
+
+    if (changes.all)
+    {
+        _thumbnails.clear();
+        return;
+    }
+
+    for (auto it = _thumbnails.begin(); it != _thumbnails.end(); )
+    {
+        if (changes.intersects(it->first))
+            it = _thumbnails.erase(it);
+        else
+            ++it;
+    }
+}
+
+// All thumbnails become outdated when the source changes
+void ImageThumbnailCache::setSourceImage(const QImage& image)
+{
+    ++_generation;
+    _sourceImage = image;
+    _thumbnails.clear();
+    _pending.clear();
+    _requests.clear();
+}
+
+// Returns a cached thumbnail or a null pixmap, in the latter case the thumbnail is generated in background
+QPixmap ImageThumbnailCache::getThumbnail(const QRect& rect)
+{
+    if (_sourceImage.isNull() || rect.isEmpty()) return QPixmap();
+
+    auto it = _thumbnails.find(rect);
+    if (it != _thumbnails.end()) return it->second;
+
+    if (_pending.insert(rect).second)
+    {
+        // Requests are collected until the control returns to the event loop and then sent in batches
+        _requests.push_back(rect);
+        if (_requests.size() == 1)
+            QTimer::singleShot(0, this, &ImageThumbnailCache::flushRequests);
+    }
+
+    return QPixmap();
+}
+
+void ImageThumbnailCache::flushRequests()
+{
+    if (_requests.empty()) return;
+
+    const QImage source = _sourceImage;
+    const QImage background = _background;
+    const int generation = _generation;
+
+    for (int i = 0; i < _requests.size(); i += BatchSize)
+    {
+        const QVector<QRect> batch = _requests.mid(i, BatchSize);
+
+        auto watcher = new QFutureWatcher<std::vector<Result>>(this);
+        connect(watcher, &QFutureWatcher<std::vector<Result>>::finished, this, [this, watcher, generation]()
+        {
+            onBatchFinished(generation, watcher->result());
+            watcher->deleteLater();
+        });
+
+        watcher->setFuture(QtConcurrent::run([source, background, batch]()
+        {
+            std::vector<Result> results;
+            results.reserve(static_cast<size_t>(batch.size()));
+            for (const QRect& rect : batch)
+            {
+                QImage thumbnail = background.copy();
+
+                const QRect srcRect = rect.intersected(source.rect());
+                if (!srcRect.isEmpty())
+                {
+                    const QImage scaled = source.copy(srcRect).scaled(ThumbnailSize, ThumbnailSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                    QPainter painter(&thumbnail);
+                    painter.drawImage((ThumbnailSize - scaled.width()) / 2, (ThumbnailSize - scaled.height()) / 2, scaled);
+                }
+
+                results.push_back({ rect, std::move(thumbnail) });
+            }
+            return results;
+        }));
+    }
+
+    _requests.clear();
+}
+
+void ImageThumbnailCache::onBatchFinished(int generation, const std::vector<Result>& results)
+{
+    if (generation != _generation) return;
+
+    // Thumbnails of old geometry are not tracked, just start over when there are too many of them
+    if (_thumbnails.size() + results.size() > MaxThumbnails)
+        _thumbnails.clear();
+
+    QVector<QRect> rects;
+    rects.reserve(static_cast<int>(results.size()));
+    for (const auto& result : results)
+    {
+        _pending.erase(result.rect);
+        _thumbnails[result.rect] = QPixmap::fromImage(result.thumbnail);
+        rects.push_back(result.rect);
+    }
+
+    emit thumbnailsReady(rects);
+}
@@ -0,0 +1,71 @@
+#ifndef IMAGETHUMBNAILCACHE_H
+#define IMAGETHUMBNAILCACHE_H
+
+#include "qobject.h"
+#include "qimage.h"
+#include "qpixmap.h"
+#include "qvector.h"
+#include "src/QtStdHash.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Generates preview thumbnails of image rectangles of the atlas on a worker pool and caches them
+// by geometry, so that only images with changed rectangles or source texture are regenerated.
+// A missing thumbnail is requested with getThumbnail(), thumbnailsReady() notifies when it's ready.
+
+// Marks square blocks of an image which differ from its previous version. Computed when the image
+// is reloaded, so that thumbnails of unchanged regions can be kept.
+struct ImageChanges
+{
+    static constexpr int BlockSize = 64;
+
+    static ImageChanges compare(const QImage& oldImage, const QImage& newImage);
+
+    bool intersects(const QRect& rect) const;
+
+    QSize size;
+    int blocksPerRow = 0;
+    std::vector<bool> blocks; // Row by row
+    bool all = false;
+    bool any = false;
+};
+
+class ImageThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    static constexpr int ThumbnailSize = 24;
+
+    ImageThumbnailCache(QObject* parent = nullptr);
+
+    void setSourceImage(const QImage& image);
+    void updateSourceImage(const QImage& image, const ImageChanges& changes);
+    QPixmap getThumbnail(const QRect& rect);
+
+signals:
+
+    void thumbnailsReady(const QVector<QRect>& rects);
+
+protected:
+
+    struct Result
+    {
+        QRect rect;
+        QImage thumbnail;
+    };
+
+    void flushRequests();
+    void onBatchFinished(int generation, const std::vector<Result>& results);
+
+    QImage _sourceImage;
+    QImage _background;
+    std::unordered_map<QRect, QPixmap> _thumbnails;
+    std::unordered_set<QRect> _pending;
+    QVector<QRect> _requests;
+    int _generation = 0; // Results generated from an outdated source are dropped
+};
+
+#endif // IMAGETHUMBNAILCACHE_H
@@ -0,0 +1,72 @@
+#include "src/ui/imageset/ImageUsageCounter.h"
+#include "src/cegui/CEGUIManager.h"
+#include "src/cegui/ProjectSymbolIndex.h"
+#include <cmath>
+
+ImageUsageCounter::ImageUsageCounter(QObject* parent)
+    : QObject(parent)
+{
+}
+
+// The index is recreated when a project is loaded, subscribe to the current one
+void ImageUsageCounter::update(const QString& imagesetName)
+{
+    _imagesetName = imagesetName;
+
+    ProjectSymbolIndex* index = CEGUIManager::Instance().getSymbolIndex();
+    if (_index != index)
+    {
+        if (_index) disconnect(_index, nullptr, this, nullptr);
+        _index = index;
+        if (_index) connect(_index, &ProjectSymbolIndex::indexChanged, this, &ImageUsageCounter::updateCounts);
+    }
+
+    updateCounts();
+}
+
+void ImageUsageCounter::updateCounts()
+{
+    // The index is being built, it will notify when ready
+    if (!_index || !_index->isReady()) return;
+
+    _counts.clear();
+    _maxCount = 0;
+
+    // Images are sorted by full name, images of one imageset are a contiguous range
+    const QString prefix = _imagesetName + '/';
+    const auto& images = _index->getAllSymbols(ProjectSymbolIndex::SymbolType::Image);
+    for (auto it = images.lower_bound(prefix); it != images.end() && it->first.startsWith(prefix); ++it)
+    {
+        const int count = static_cast<int>(it->second.usages.size());
+        if (!count) continue;
+
+        _counts.emplace(it->first.mid(prefix.size()), count);
+        _maxCount = std::max(_maxCount, count);
+    }
+
+    _ready = true;
+    emit countsChanged();
+}
+
+int ImageUsageCounter::getCount(const QString& imageName) const
+{
+    auto it = _counts.find(imageName);
+    return (it == _counts.end()) ? 0 : it->second;
+}
+
+std::unordered_set<QString> ImageUsageCounter::getUsedImageNames() const
+{
+    std::unordered_set<QString> names;
+    for (const auto& pair : _counts)
+        names.insert(pair.first);
+    return names;
+}
+
+// From cold blue for unused images to hot red for the most used ones. The scale is logarithmic,
+// otherwise a couple of images used everywhere make all others look unused.
+QColor ImageUsageCounter::getHeatColor(const QString& imageName) const
+{
+    const int count = getCount(imageName);
+    const qreal heat = (_maxCount > 0) ? std::log1p(count) / std::log1p(_maxCount) : 0.0;
+    return QColor::fromHsvF((1.0 - heat) * 240.0 / 360.0, 1.0, 1.0, 0.45);
+}
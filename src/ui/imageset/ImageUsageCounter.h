@@ -0,0 +1,48 @@
+#ifndef IMAGEUSAGECOUNTER_H
+#define IMAGEUSAGECOUNTER_H
+
+#include "qobject.h"
+#include "qpointer.h"
+#include "qcolor.h"
+#include "src/QtStdHash.h"
+#include <unordered_map>
+#include <unordered_set>
+
+// Counts references to images of an imageset ('Imageset/Image') across all project resources.
+// Usages are taken from the project symbol index, so the heatmap and the 'is:unused' filter agree
+// with Find Usages and the project analysis. Counts are updated whenever the index changes.
+
+class ProjectSymbolIndex;
+
+class ImageUsageCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    ImageUsageCounter(QObject* parent = nullptr);
+
+    void update(const QString& imagesetName);
+
+    bool isReady() const { return _ready; }
+    int getCount(const QString& imageName) const;
+    int getMaxCount() const { return _maxCount; }
+    std::unordered_set<QString> getUsedImageNames() const;
+    QColor getHeatColor(const QString& imageName) const;
+
+signals:
+
+    void countsChanged();
+
+protected:
+
+    void updateCounts();
+
+    QPointer<ProjectSymbolIndex> _index;
+    QString _imagesetName;
+    std::unordered_map<QString, int> _counts;
+    int _maxCount = 0;
+    bool _ready = false;
+};
+
+#endif // IMAGEUSAGECOUNTER_H
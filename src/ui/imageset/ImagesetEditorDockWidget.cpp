@@ -1,6 +1,10 @@
 #include "src/ui/imageset/ImagesetEditorDockWidget.h"
 #include "src/ui/imageset/ImagesetEntry.h"
 #include "src/ui/imageset/ImageEntry.h"
+#include "src/ui/imageset/ImageEntryListModel.h"
+#include "src/ui/imageset/ImageIssueListModel.h"
+#include "src/ui/imageset/ImagesetIssuesDockWidget.h"
+#include "src/ui/imageset/ImageUsageCounter.h"
 #include "src/cegui/CEGUIManager.h"
 #include "src/cegui/CEGUIProject.h"
 #include "src/editors/imageset/ImagesetVisualMode.h"
@@ -75,6 +79,21 @@ ImagesetEditorDockWidget::ImagesetEditorDockWidget(ImagesetVisualMode& visualMod
 
     ui->list->setItemDelegate(new ImageEntryItemDelegate());
 
+    _model = new ImageEntryListModel(this);
+    _model->setIssueModel(_visualMode.getIssuesDockWidget()->getModel());
+    ui->list->setModel(_model);
+    connect(ui->list->selectionModel(), &QItemSelectionModel::selectionChanged, this, &ImagesetEditorDockWidget::onListSelectionChanged);
+    connect(_model, &QAbstractItemModel::modelReset, this, &ImagesetEditorDockWidget::onListModelReset);
+    connect(_model, &QAbstractItemModel::layoutChanged, this, &ImagesetEditorDockWidget::onListModelReset);
+    connect(_model, &ImageEntryListModel::renameRequested, this, &ImagesetEditorDockWidget::onRenameRequested);
+
+    // The counter is shared with the usage heatmap, which may trigger the scan too
+    connect(_visualMode.getImageUsageCounter(), &ImageUsageCounter::countsChanged, this, [this]()
+    {
+        if (_usedImageNamesRequested)
+            _model->setUsedImageNames(_visualMode.getImageUsageCounter()->getUsedImageNames());
+    });
+
     setActiveImageEntry(nullptr);
 }
 
@@ -83,6 +102,19 @@ ImagesetEditorDockWidget::~ImagesetEditorDockWidget()
     delete ui;
 }
 
+void ImagesetEditorDockWidget::setImagesetEntry(ImagesetEntry* entry)
+{
+    imagesetEntry = entry;
+    _usedImageNamesRequested = false;
+
+    // Don't keep pointers to images of the previous imageset
+    if (!imagesetEntry)
+    {
+        _model->setImagesetEntry(nullptr);
+        _visualMode.getIssuesDockWidget()->getModel()->setImagesetEntry(nullptr);
+    }
+}
+
 // Active image entry is the image entry that is selected when there are no
 // other image entries selected. It's properties show in the property box.
 // NB: Imageset editing doesn't allow multi selection property editing because IMO it doesn't make much sense.
@@ -133,32 +165,38 @@ void ImagesetEditorDockWidget::refreshImagesetInfo()
 // Note: User potentially loses selection when this is called!
 void ImagesetEditorDockWidget::refresh()
 {
-    ui->list->clear();
-
     setActiveImageEntry(nullptr);
 
     assert(imagesetEntry);
 
     refreshImagesetInfo();
 
-    for (ImageEntry* imageEntry : imagesetEntry->getImageEntries())
-    {
-        auto item = new QListWidgetItem();
-        item->setData(Qt::UserRole + 1, QVariant::fromValue(this));
-        item->setData(Qt::UserRole + 2, QVariant::fromValue(imageEntry));
-        item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEditable | Qt::ItemIsEnabled);
-        imageEntry->setListItem(item);
-        imageEntry->updateListItem(); // Nothing is selected (list was cleared) so we don't need to call the whole updateDockWidget here
-        ui->list->addItem(item);
-    }
+    // The current filter is kept by the model
+    _model->setImagesetEntry(imagesetEntry);
 
-    // Explicitly call the filtering again to make sure it's in sync
-    on_filterBox_textChanged(ui->filterBox->text());
+    _visualMode.getIssuesDockWidget()->getModel()->setImagesetEntry(imagesetEntry);
 }
 
 void ImagesetEditorDockWidget::scrollToEntry(ImageEntry* entry)
 {
-    if (entry) ui->list->scrollToItem(entry->getListItem());
+    if (!entry) return;
+
+    const QModelIndex index = _model->getIndex(entry);
+    if (index.isValid()) ui->list->scrollTo(index);
+}
+
+// Synchronises the selection in the list with the selection of the image in the visual editing pane
+void ImagesetEditorDockWidget::setImageEntrySelected(ImageEntry* entry, bool selected)
+{
+    // We are performing a selection, we shall not interfere
+    if (selectionUnderway) return;
+
+    const QModelIndex index = _model->getIndex(entry);
+    if (!index.isValid()) return;
+
+    selectionSynchronizationUnderway = true;
+    ui->list->selectionModel()->select(index, selected ? QItemSelectionModel::Select : QItemSelectionModel::Deselect);
+    selectionSynchronizationUnderway = false;
 }
 
 // Focuses into image list filter. This potentially allows the user to just press a shortcut to find images,
@@ -251,25 +289,14 @@ void ImagesetEditorDockWidget::on_autoScaledPerImage_currentIndexChanged(int ind
 
 void ImagesetEditorDockWidget::on_filterBox_textChanged(const QString& arg1)
 {
-    // We append star at the beginning and at the end by default (makes property filtering much more practical)
-    const QString pattern = QRegularExpression::wildcardToRegularExpression("*" + arg1 + "*");
-    QRegularExpression regex(pattern, QRegularExpression::CaseInsensitiveOption);
-
-    for (int i = 0; i < ui->list->count(); ++i)
-    {
-        auto listItem = ui->list->item(i);
-        auto matchResult = regex.match(listItem->text());
-        listItem->setHidden(!matchResult.hasMatch());
-    }
+    const auto filter = ImageEntryListModel::Filter::parse(arg1);
+    if (filter.unusedOnly) requestUsedImageNames();
+    _model->setFilter(filter);
 }
 
-void ImagesetEditorDockWidget::on_list_itemChanged(QListWidgetItem* item)
+void ImagesetEditorDockWidget::onRenameRequested(ImageEntry* entry, const QString& newName)
 {
-    auto entry = item->data(Qt::UserRole + 2).value<ImageEntry*>();
-    if (!entry) return;
-
     auto oldName = entry->name();
-    auto newName = item->text();
 
     // Most likely caused by RenameCommand doing it's work or is bogus anyways
     if (oldName == newName) return;
@@ -277,10 +304,10 @@ void ImagesetEditorDockWidget::on_list_itemChanged(QListWidgetItem* item)
     _visualMode.getEditor().getUndoStack()->push(new ImageRenameCommand(_visualMode, oldName, newName));
 }
 
-void ImagesetEditorDockWidget::on_list_itemSelectionChanged()
+void ImagesetEditorDockWidget::onListSelectionChanged()
 {
-    auto imageEntryNames = ui->list->selectedItems();
-    setActiveImageEntry(imageEntryNames.empty() ? nullptr : imageEntryNames[0]->data(Qt::UserRole + 2).value<ImageEntry*>());
+    const auto selectedIndexes = ui->list->selectionModel()->selectedIndexes();
+    setActiveImageEntry(selectedIndexes.empty() ? nullptr : _model->getImageEntry(selectedIndexes[0]));
 
     // We are getting synchronised with the visual editing pane, do not interfere
     if (selectionSynchronizationUnderway) return;
@@ -289,20 +316,35 @@ void ImagesetEditorDockWidget::on_list_itemSelectionChanged()
 
     _visualMode.scene()->clearSelection();
 
-    auto imageEntryItems = ui->list->selectedItems();
-    for (auto&& imageEntryItem : imageEntryItems)
-    {
-        auto imageEntry = imageEntryItem->data(Qt::UserRole + 2).value<ImageEntry*>();
-        imageEntry->setSelected(true);
-    }
+    for (const auto& index : selectedIndexes)
+        if (auto imageEntry = _model->getImageEntry(index))
+            imageEntry->setSelected(true);
 
-    if (imageEntryItems.size() == 1)
+    if (selectedIndexes.size() == 1)
+        if (auto imageEntry = _model->getImageEntry(selectedIndexes[0]))
+            _visualMode.centerOn(imageEntry);
+
+    selectionUnderway = false;
+}
+
+// Filtering may show images selected while hidden, restore the selection from the visual editing pane
+void ImagesetEditorDockWidget::onListModelReset()
+{
+    QItemSelection selection;
+    for (QGraphicsItem* item : _visualMode.scene()->selectedItems())
     {
-        auto imageEntry = imageEntryItems[0]->data(Qt::UserRole + 2).value<ImageEntry*>();
-        _visualMode.centerOn(imageEntry);
+        // Resizing handles and offset marks are children of the image
+        ImageEntry* imageEntry = dynamic_cast<ImageEntry*>(item);
+        if (!imageEntry && item->parentItem()) imageEntry = dynamic_cast<ImageEntry*>(item->parentItem());
+        if (!imageEntry) continue;
+
+        const QModelIndex index = _model->getIndex(imageEntry);
+        if (index.isValid()) selection.select(index, index);
     }
 
-    selectionUnderway = false;
+    selectionSynchronizationUnderway = true;
+    ui->list->selectionModel()->select(selection, QItemSelectionModel::ClearAndSelect);
+    selectionSynchronizationUnderway = false;
 }
 
 void ImagesetEditorDockWidget::on_positionX_textChanged(const QString& arg1)
@@ -367,6 +409,16 @@ void ImagesetEditorDockWidget::onStringPropertyChanged(const QString& name, cons
                                                                               name, oldValue, newValue));
 }
 
+// Collects names of images of this imageset referenced from project files for the 'is:unused' filter.
+// References are CEGUI 0.8 style 'Imageset/Image' strings found by the project symbol index.
+void ImagesetEditorDockWidget::requestUsedImageNames()
+{
+    if (_usedImageNamesRequested || !imagesetEntry) return;
+
+    _usedImageNamesRequested = true;
+    _visualMode.getImageUsageCounter()->update(imagesetEntry->name());
+}
+
 void ImagesetEditorDockWidget::keyReleaseEvent(QKeyEvent* event)
 {
     // If we are editing, we should discard key events
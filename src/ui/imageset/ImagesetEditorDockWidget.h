@@ -8,7 +8,7 @@
 class ImagesetEntry;
 class ImageEntry;
 class ImagesetVisualMode;
-class QListWidgetItem;
+class ImageEntryListModel;
 
 namespace Ui {
 class ImagesetEditorDockWidget;
@@ -23,13 +23,15 @@ public:
     explicit ImagesetEditorDockWidget(ImagesetVisualMode& visualMode, QWidget *parent = nullptr);
     ~ImagesetEditorDockWidget() override;
 
-    void setImagesetEntry(ImagesetEntry* entry) { imagesetEntry = entry; }
+    void setImagesetEntry(ImagesetEntry* entry);
     void setActiveImageEntry(ImageEntry* entry);
     ImageEntry* getActiveImageEntry() const { return activeImageEntry; }
     void refreshActiveImageEntry();
     void refreshImagesetInfo();
     void refresh();
     void scrollToEntry(ImageEntry* entry);
+    void setImageEntrySelected(ImageEntry* entry, bool selected);
+    ImageEntryListModel* getImageListModel() const { return _model; }
 
     bool isSelectionUnderway() const { return selectionUnderway; }
     void setSelectionSynchronizationUnderway(bool on) { selectionSynchronizationUnderway = on; }
@@ -53,9 +55,9 @@ private slots:
 
     void on_filterBox_textChanged(const QString &arg1);
 
-    void on_list_itemChanged(QListWidgetItem *item);
-
-    void on_list_itemSelectionChanged();
+    void onListSelectionChanged();
+    void onListModelReset();
+    void onRenameRequested(ImageEntry* entry, const QString& newName);
 
     void on_positionX_textChanged(const QString &arg1);
 
@@ -75,6 +77,7 @@ private:
 
     void onIntPropertyChanged(const QString& name, const QString& valueString);
     void onStringPropertyChanged(const QString& name, const QString& newValue);
+    void requestUsedImageNames();
 
     virtual void keyReleaseEvent(QKeyEvent* event) override;
 
@@ -82,9 +85,11 @@ private:
     ImagesetVisualMode& _visualMode;
     ImagesetEntry* imagesetEntry = nullptr;
     ImageEntry* activeImageEntry = nullptr;
+    ImageEntryListModel* _model = nullptr;
 
     bool selectionUnderway = false;
     bool selectionSynchronizationUnderway = false;
+    bool _usedImageNamesRequested = false;
 };
 
 #endif // IMAGESETEDITORDOCKWIDGET_H
@@ -1,33 +1,108 @@
 #include "src/ui/imageset/ImagesetEntry.h"
 #include "src/ui/imageset/ImageEntry.h"
+#include "src/ui/imageset/ImageThumbnailCache.h"
+#include "src/ui/imageset/ImageEntryListModel.h"
+#include "src/ui/imageset/ImagesetEditorDockWidget.h"
+#include "src/ui/imageset/ImageIssueListModel.h"
+#include "src/ui/imageset/ImagesetIssuesDockWidget.h"
 #include "src/editors/imageset/ImagesetVisualMode.h"
 #include "src/util/Utils.h"
+#include "src/util/FileWatcher.h"
+#include "src/QtStdHash.h"
 #include "src/Application.h"
-#include "qfilesystemwatcher.h"
+#include <unordered_set>
 #include "qmessagebox.h"
 #include "qcursor.h"
 #include "qfileinfo.h"
 #include "qdir.h"
 #include "qdom.h"
 #include "qpen.h"
+#include "qpainter.h"
+#include "qstyleoption.h"
+#include "qfuturewatcher.h"
+#include <QtConcurrent/qtconcurrentrun.h>
 
 ImagesetEntry::ImagesetEntry(ImagesetVisualMode& visualMode)
     : QObject(&visualMode)
-    , QGraphicsPixmapItem() // Top-level item
+    , QGraphicsItem() // Top-level item
     , _visualMode(visualMode)
 {
-    setShapeMode(BoundingRectShape);
+    // Need exposedRect to draw only visible tiles
+    setFlag(ItemUsesExtendedStyleOption, true);
     setCursor(Qt::ArrowCursor);
 
     transparencyBackground = new QGraphicsRectItem(this);
     transparencyBackground->setFlags(ItemStacksBehindParent);
     transparencyBackground->setBrush(Utils::getCheckerboardBrush());
     transparencyBackground->setPen(QPen(QColor(Qt::transparent)));
+
+    _thumbnails = new ImageThumbnailCache(this);
+
+    connect(qobject_cast<Application*>(qApp)->getFileWatcher(), &FileWatcher::fileChanged,
+            this, &ImagesetEntry::onImageChangedByExternalProgram);
 }
 
 ImagesetEntry::~ImagesetEntry()
 {
-    delete imageMonitor;
+    if (!_imageAbsPath.isEmpty())
+        qobject_cast<Application*>(qApp)->getFileWatcher()->unwatchFile(_imageAbsPath);
+}
+
+QRectF ImagesetEntry::boundingRect() const
+{
+    // An invalid QSize is (-1, -1), the rect must stay empty without an image
+    return _image.isNull() ? QRectF() : QRectF(QPointF(0.0, 0.0), QSizeF(_image.size()));
+}
+
+// The grid is drawn only when cells are big enough to not hide the image itself
+static constexpr qreal PixelGridMinScale = 8.0;
+
+void ImagesetEntry::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* /*widget*/)
+{
+    const qreal levelOfDetail = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    _image.draw(*painter, option->exposedRect, levelOfDetail);
+
+    if (_showPixelGrid && levelOfDetail >= PixelGridMinScale)
+        drawPixelGrid(*painter, option->exposedRect);
+}
+
+void ImagesetEntry::drawPixelGrid(QPainter& painter, const QRectF& exposedRect) const
+{
+    const QRect texels = exposedRect.toAlignedRect().intersected(QRect(QPoint(0, 0), _image.size()));
+    if (texels.isEmpty()) return;
+
+    QVector<QLineF> lines;
+    lines.reserve(texels.width() + texels.height() + 2);
+    for (int x = texels.left(); x <= texels.left() + texels.width(); ++x)
+        lines.push_back(QLineF(x, texels.top(), x, texels.top() + texels.height()));
+    for (int y = texels.top(); y <= texels.top() + texels.height(); ++y)
+        lines.push_back(QLineF(texels.left(), y, texels.left() + texels.width(), y));
+
+    // Cosmetic pen is one screen pixel wide at any zoom
+    QPen pen(QColor(128, 128, 128, 96));
+    pen.setCosmetic(true);
+    pen.setWidth(0);
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.setPen(pen);
+    painter.drawLines(lines);
+    painter.restore();
+}
+
+void ImagesetEntry::setShowPixelGrid(bool value)
+{
+    if (_showPixelGrid == value) return;
+    _showPixelGrid = value;
+    update();
+}
+
+void ImagesetEntry::setShowUsageHeatmap(bool value)
+{
+    if (_showUsageHeatmap == value) return;
+    _showUsageHeatmap = value;
+    for (ImageEntry* imageEntry : imageEntries)
+        imageEntry->update();
 }
 
 void ImagesetEntry::loadFromElement(const QDomElement& xml)
@@ -107,18 +182,96 @@ void ImagesetEntry::removeImageEntry(const QString& name)
 
     imageEntries.erase(it);
 
+    if (auto dockWidget = _visualMode.getDockWidget())
+        dockWidget->getImageListModel()->removeImageEntry(image);
+    if (auto issuesDockWidget = _visualMode.getIssuesDockWidget())
+        issuesDockWidget->getModel()->removeImageEntries({ image });
+
     image->setParentItem(nullptr);
     _visualMode.scene()->removeItem(image);
 
     delete image;
 }
 
-// Monitor the image with a QFilesystemWatcher, ask user to reload if changes to the file were made
-void ImagesetEntry::onImageChangedByExternalProgram()
+// Much faster than removing images one by one when there are many of them
+void ImagesetEntry::removeImageEntries(const std::vector<QString>& names)
+{
+    const std::unordered_set<QString> nameSet(names.begin(), names.end());
+
+    auto it = std::stable_partition(imageEntries.begin(), imageEntries.end(), [&nameSet](ImageEntry* ent)
+    {
+        return nameSet.find(ent->name()) == nameSet.end();
+    });
+
+    if (it == imageEntries.end()) return;
+
+    const std::unordered_set<ImageEntry*> removedEntries(it, imageEntries.end());
+    if (auto dockWidget = _visualMode.getDockWidget())
+        dockWidget->getImageListModel()->removeImageEntries(removedEntries);
+    if (auto issuesDockWidget = _visualMode.getIssuesDockWidget())
+        issuesDockWidget->getModel()->removeImageEntries(removedEntries);
+
+    for (auto removedIt = it; removedIt != imageEntries.end(); ++removedIt)
+    {
+        ImageEntry* image = (*removedIt);
+        image->setParentItem(nullptr);
+        _visualMode.scene()->removeItem(image);
+        delete image;
+    }
+
+    imageEntries.erase(it, imageEntries.end());
+}
+
+// The image is watched by the application file watcher, ask user to reload if changes to the file were made.
+// Notifications are debounced, the image is decoded in background and the user is asked only when it succeeds.
+void ImagesetEntry::onImageChangedByExternalProgram(const QString& filePath, bool external)
+{
+    if (external && !_imageAbsPath.isEmpty() && filePath == _imageAbsPath)
+        reloadImageInBackground();
+}
+
+void ImagesetEntry::reloadImageInBackground()
+{
+    if (_imageAbsPath.isEmpty()) return;
+
+    const QString path = _imageAbsPath;
+    const QImage oldImage = getImage();
+    const int generation = ++_reloadGeneration;
+
+    auto watcher = new QFutureWatcher<ReloadedImage>(this);
+    connect(watcher, &QFutureWatcher<ReloadedImage>::finished, this, [this, watcher, generation]()
+    {
+        onImageReloaded(generation, watcher->result());
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run([path, oldImage]()
+    {
+        ReloadedImage reloaded;
+
+        // The file may be still being written, then decoding fails and we wait for the next notification
+        QImage image(path);
+        if (image.isNull()) return reloaded;
+
+        reloaded.image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        reloaded.changes = ImageChanges::compare(oldImage, reloaded.image);
+        return reloaded;
+    }));
+}
+
+void ImagesetEntry::onImageReloaded(int generation, ReloadedImage&& reloaded)
 {
-    //???really here? or maybe somewhere in MainWindow?
-    //can subscribe on global file watcher, MainWindow will process dialog,
-    //and if user chooses to reload file, signal will be emitted or method will be called.
+    if (generation != _reloadGeneration || reloaded.image.isNull()) return;
+
+    // The file was rewritten with the same contents, nothing to ask about
+    if (!reloaded.changes.any)
+    {
+        _pendingReload = ReloadedImage();
+        return;
+    }
+
+    // Newer image replaces the one waiting for user's answer
+    _pendingReload = std::move(reloaded);
 
     if (displayingReloadAlert) return;
 
@@ -132,9 +285,22 @@ void ImagesetEntry::onImageChangedByExternalProgram()
                                      QMessageBox::No | QMessageBox::Yes,
                                      QMessageBox::No); // defaulting to No is safer IMO
 
-    if (ret == QMessageBox::Yes) loadImage(_imageAbsPath);
-
     displayingReloadAlert = false;
+
+    // The image might have been replaced while the question was displayed
+    ReloadedImage pending = std::move(_pendingReload);
+    _pendingReload = ReloadedImage();
+    if (ret != QMessageBox::Yes || pending.image.isNull()) return;
+
+    prepareGeometryChange();
+    _image.setImage(pending.image);
+    update();
+
+    transparencyBackground->setRect(boundingRect());
+
+    _thumbnails->updateSourceImage(getImage(), pending.changes);
+
+    constrainImageEntries();
 }
 
 // Replaces the underlying image (if any is loaded) to the image on given relative path
@@ -142,20 +308,38 @@ void ImagesetEntry::onImageChangedByExternalProgram()
 // (which is usually your project's imageset resource group path)
 void ImagesetEntry::loadImage(const QString& absPath)
 {
-    // If imageMonitor is null, then no images are being watched or the
-    // editor is first being opened up
-    // Otherwise, the image is being changed or switched, and the monitor
-    // should update itself accordingly
-    if (imageMonitor && !_imageAbsPath.isEmpty())
-        imageMonitor->removePath(_imageAbsPath);
+    // The image is being changed or switched, the watcher should update itself accordingly
+    auto fileWatcher = qobject_cast<Application*>(qApp)->getFileWatcher();
+    if (!_imageAbsPath.isEmpty())
+        fileWatcher->unwatchFile(_imageAbsPath);
+
+    // Drop background reloads of the previous image
+    _pendingReload = ReloadedImage();
+    ++_reloadGeneration;
 
-    _imageAbsPath = absPath;
+    _imageAbsPath = QDir::cleanPath(absPath);
+
+    prepareGeometryChange();
+    if (_imageAbsPath.isEmpty())
+        _image.clear();
+    else
+        _image.load(absPath);
+    update();
 
-    setPixmap(_imageAbsPath.isEmpty() ? QPixmap() : QPixmap(absPath));
     transparencyBackground->setRect(boundingRect());
 
-    // Go over all image entries and set their position to force them to be constrained
-    // to the new pixmap's dimensions
+    _thumbnails->setSourceImage(getImage());
+
+    constrainImageEntries();
+
+    if (!_imageAbsPath.isEmpty())
+        fileWatcher->watchFile(_imageAbsPath);
+}
+
+// Go over all image entries and set their position to force them to be constrained
+// to the new pixmap's dimensions
+void ImagesetEntry::constrainImageEntries()
+{
     for (auto& imageEntry : imageEntries)
     {
         imageEntry->setPos(imageEntry->pos());
@@ -163,12 +347,4 @@ void ImagesetEntry::loadImage(const QString& absPath)
     }
 
     _visualMode.refreshSceneRect();
-
-    if (!imageMonitor)
-    {
-        imageMonitor = new QFileSystemWatcher();
-        connect(imageMonitor, &QFileSystemWatcher::fileChanged, this, &ImagesetEntry::onImageChangedByExternalProgram);
-    }
-    if (!_imageAbsPath.isEmpty())
-        imageMonitor->addPath(absPath);
 }
@@ -2,17 +2,19 @@
 #define IMAGESETENTRY_H
 
 #include "qgraphicsitem.h"
+#include "src/util/TiledImage.h"
+#include "src/ui/imageset/ImageThumbnailCache.h"
 
 // This is the whole imageset containing all the images (ImageEntries).
 // The main reason for this is not to have multiple imagesets editing at once but rather
 // to have the transparency background working properly.
+// The underlying image is drawn from a tile pyramid, so huge atlases are cheap to pan and zoom.
 
 class QDomElement;
 class ImageEntry;
-class QFileSystemWatcher;
 class ImagesetVisualMode;
 
-class ImagesetEntry : public QObject, public QGraphicsPixmapItem
+class ImagesetEntry : public QObject, public QGraphicsItem
 {
     Q_OBJECT
 
@@ -21,6 +23,9 @@ public:
     ImagesetEntry(ImagesetVisualMode& visualMode);
     ~ImagesetEntry() override;
 
+    virtual QRectF boundingRect() const override;
+    virtual void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
+
     void loadFromElement(const QDomElement& xml);
     void saveToElement(QDomElement& xml);
     void loadImage(const QString& absPath);
@@ -36,34 +41,58 @@ public:
     ImageEntry* createImageEntry();
     ImageEntry* getImageEntry(const QString& name) const;
     void removeImageEntry(const QString& name);
+    void removeImageEntries(const std::vector<QString>& names);
     const std::vector<ImageEntry*>& getImageEntries() const { return imageEntries; }
 
     bool showOffsets() const { return _showOffsets; }
     void setShowOffsets(bool value) { _showOffsets = value; }
+    bool showPixelGrid() const { return _showPixelGrid; }
+    void setShowPixelGrid(bool value);
+    bool showUsageHeatmap() const { return _showUsageHeatmap; }
+    void setShowUsageHeatmap(bool value);
 
     const QString& getImageFile() const { return _imageAbsPath; }
+    bool hasImage() const { return !_image.isNull(); }
+    const QImage& getImage() const { return _image.getImage(); }
+    ImageThumbnailCache& getThumbnailCache() const { return *_thumbnails; }
+    ImagesetVisualMode& getVisualMode() const { return _visualMode; }
 
 protected slots:
 
-    void onImageChangedByExternalProgram();
+    void onImageChangedByExternalProgram(const QString& filePath, bool external);
+    void reloadImageInBackground();
 
 protected:
 
+    struct ReloadedImage
+    {
+        QImage image;
+        ImageChanges changes;
+    };
+
+    void onImageReloaded(int generation, ReloadedImage&& reloaded);
+    void constrainImageEntries();
+    void drawPixelGrid(QPainter& painter, const QRectF& exposedRect) const;
+
     ImagesetVisualMode& _visualMode;
 
     QString _name = "Unknown";
     QString _imageAbsPath;
+    TiledImage _image;
+    ImageThumbnailCache* _thumbnails = nullptr;
     QString autoScaled = "false";
     int nativeHorzRes = 800;
     int nativeVertRes = 600;
     bool _showOffsets = false;
+    bool _showPixelGrid = false;
+    bool _showUsageHeatmap = false;
 
     std::vector<ImageEntry*> imageEntries;
 
     QGraphicsRectItem* transparencyBackground = nullptr;
 
-    //???here or in MainWindow?
-    QFileSystemWatcher* imageMonitor = nullptr;
+    ReloadedImage _pendingReload;
+    int _reloadGeneration = 0; // Reloads started before the image was replaced are dropped
     bool displayingReloadAlert = false;
 };
 
@@ -0,0 +1,62 @@
+#include "src/ui/imageset/ImagesetIssuesDockWidget.h"
+#include "src/ui/imageset/ImageIssueListModel.h"
+#include "src/ui/imageset/ImageEntry.h"
+#include "src/editors/imageset/ImagesetVisualMode.h"
+#include "qlistview.h"
+#include "qlabel.h"
+#include "qboxlayout.h"
+
+ImagesetIssuesDockWidget::ImagesetIssuesDockWidget(ImagesetVisualMode& visualMode, QWidget* parent)
+    : QDockWidget(parent)
+    , _visualMode(visualMode)
+{
+    setObjectName("Imageset Issues dock widget");
+    setWindowTitle("Imageset Issues");
+
+    _model = new ImageIssueListModel(this);
+
+    _summary = new QLabel();
+
+    _view = new QListView();
+    _view->setModel(_model);
+    _view->setUniformItemSizes(true);
+    _view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    auto contentsWidget = new QWidget();
+    auto contentsLayout = new QVBoxLayout(contentsWidget);
+    auto margins = contentsLayout->contentsMargins();
+    margins.setTop(0);
+    contentsLayout->setContentsMargins(margins);
+    contentsLayout->addWidget(_summary);
+    contentsLayout->addWidget(_view);
+
+    setWidget(contentsWidget);
+
+    connect(_view, &QListView::activated, this, &ImagesetIssuesDockWidget::onIssueActivated);
+    connect(_view, &QListView::clicked, this, &ImagesetIssuesDockWidget::onIssueActivated);
+    connect(_model, &ImageIssueListModel::issuesChanged, this, &ImagesetIssuesDockWidget::onIssuesChanged);
+
+    onIssuesChanged();
+}
+
+// Selects images of the issue and shows them in the visual editing pane
+void ImagesetIssuesDockWidget::onIssueActivated(const QModelIndex& index)
+{
+    const auto issue = _model->getIssue(index);
+    if (!issue) return;
+
+    _visualMode.scene()->clearSelection();
+    issue->first->setSelected(true);
+    if (issue->second) issue->second->setSelected(true);
+    _visualMode.centerOn(issue->first);
+}
+
+void ImagesetIssuesDockWidget::onIssuesChanged()
+{
+    const size_t overlapCount = _model->getOverlapCount();
+    const size_t outOfBoundsCount = _model->getOutOfBoundsCount();
+    if (!overlapCount && !outOfBoundsCount)
+        _summary->setText("No issues found");
+    else
+        _summary->setText(QString("%1 overlapping pairs, %2 images out of bounds").arg(overlapCount).arg(outOfBoundsCount));
+}
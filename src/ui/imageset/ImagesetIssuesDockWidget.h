@@ -0,0 +1,36 @@
+#ifndef IMAGESETISSUESDOCKWIDGET_H
+#define IMAGESETISSUESDOCKWIDGET_H
+
+#include <QDockWidget>
+
+// Lists overlapping images and images out of the image bounds, activating an issue selects its images
+
+class ImagesetVisualMode;
+class ImageIssueListModel;
+class QListView;
+class QLabel;
+
+class ImagesetIssuesDockWidget : public QDockWidget
+{
+    Q_OBJECT
+
+public:
+
+    explicit ImagesetIssuesDockWidget(ImagesetVisualMode& visualMode, QWidget* parent = nullptr);
+
+    ImageIssueListModel* getModel() const { return _model; }
+
+protected slots:
+
+    void onIssueActivated(const QModelIndex& index);
+    void onIssuesChanged();
+
+protected:
+
+    ImagesetVisualMode& _visualMode;
+    ImageIssueListModel* _model = nullptr;
+    QListView* _view = nullptr;
+    QLabel* _summary = nullptr;
+};
+
+#endif // IMAGESETISSUESDOCKWIDGET_H
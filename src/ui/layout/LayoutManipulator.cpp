@@ -178,6 +178,28 @@ void LayoutManipulator::notifyMoveFinished(QPointF newPos)
 
 void LayoutManipulator::updateFromWidget(bool callUpdate, bool updateAncestorLCs)
 {
+    // During bulk edits layout containers are laid out once at the end, see LayoutScene::deferLayoutContainerUpdates()
+    auto layoutScene = _visualMode.getScene();
+    if (layoutScene && layoutScene->isDeferringLayoutContainerUpdates())
+    {
+        LayoutManipulator* topmostLC = isLayoutContainer() ? this : nullptr;
+        if (updateAncestorLCs)
+        {
+            auto item = dynamic_cast<LayoutManipulator*>(parentItem());
+            while (item && item->isLayoutContainer())
+            {
+                topmostLC = item;
+                item = dynamic_cast<LayoutManipulator*>(item->parentItem());
+            }
+        }
+
+        if (topmostLC)
+        {
+            layoutScene->addDeferredLayoutContainerUpdate(topmostLC);
+            return;
+        }
+    }
+
     // We are updating the position and size from widget, we don't want any snapping
     _ignoreSnapGrid = true;
     CEGUIManipulator::updateFromWidget(callUpdate, updateAncestorLCs);
@@ -708,9 +708,31 @@ void LayoutScene::selectParent()
     }
 }
 
+// Bulk edits (paste, duplicate, undo of delete etc) may insert many children into layout containers.
+// Instead of relayouting an LC and walking its manipulator subtree after each insertion we collect
+// topmost LCs while deferring and lay out each of them exactly once when the outermost deferral ends.
+void LayoutScene::deferLayoutContainerUpdates(bool defer)
+{
+    if (defer)
+    {
+        ++_lcUpdateDeferCounter;
+        return;
+    }
+
+    assert(_lcUpdateDeferCounter > 0);
+    if (_lcUpdateDeferCounter <= 0 || --_lcUpdateDeferCounter > 0) return;
+
+    std::set<LayoutManipulator*> lcs;
+    std::swap(lcs, _deferredLCUpdates);
+    LayoutManipulator::removeNestedManipulators(lcs);
+    for (LayoutManipulator* lc : lcs)
+        lc->updateFromWidget(true, true);
+}
+
 void LayoutScene::onManipulatorRemoved(LayoutManipulator* manipulator)
 {
     if (_anchorTarget == manipulator) _anchorTarget = nullptr;
+    _deferredLCUpdates.erase(manipulator);
 }
 
 void LayoutScene::onManipulatorUpdatedFromWidget(LayoutManipulator* manipulator)
@@ -45,6 +45,10 @@ public:
     void alignSelectionVertically(CEGUI::VerticalAlignment alignment);
     void moveSelectedWidgetsInParentWidgetLists(int delta);
 
+    void deferLayoutContainerUpdates(bool defer);
+    bool isDeferringLayoutContainerUpdates() const { return _lcUpdateDeferCounter > 0; }
+    void addDeferredLayoutContainerUpdate(LayoutManipulator* manipulator) { _deferredLCUpdates.insert(manipulator); }
+
     void onManipulatorRemoved(LayoutManipulator* manipulator);
     void onManipulatorUpdatedFromWidget(LayoutManipulator* manipulator);
     void onManipulatorDragEnter(LayoutManipulator* manipulator);
@@ -131,6 +135,9 @@ protected:
     NumericValueItem* _anchorTextX = nullptr;
     NumericValueItem* _anchorTextY = nullptr;
 
+    std::set<LayoutManipulator*> _deferredLCUpdates;
+    int _lcUpdateDeferCounter = 0;
+
     bool _ignoreSelectionChanges = false;
     bool _batchSelection = false;
 };
@@ -0,0 +1,222 @@
+#include "src/util/FileWatcher.h"
+#include "qfilesystemwatcher.h"
+#include "qcryptographichash.h"
+#include "qfileinfo.h"
+#include "qfile.h"
+#include "qdir.h"
+#include "qtimer.h"
+#include "qfuturewatcher.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+
+// Editors save through a temporary file and a rename, and external tools often write in several steps
+static constexpr int DebounceDelayMs = 200;
+
+FileWatcher::FileWatcher(QObject* parent)
+    : QObject(parent)
+{
+    _debounceTimer = new QTimer(this);
+    _debounceTimer->setSingleShot(true);
+    _debounceTimer->setInterval(DebounceDelayMs);
+    connect(_debounceTimer, &QTimer::timeout, this, &FileWatcher::processPendingChanges);
+
+    _watcher = new QFileSystemWatcher(this);
+    connect(_watcher, &QFileSystemWatcher::fileChanged, this, &FileWatcher::onRawFileChanged);
+    connect(_watcher, &QFileSystemWatcher::directoryChanged, this, &FileWatcher::onRawDirectoryChanged);
+}
+
+// Files that don't exist yet are not watched by the system, watch them again after creating
+void FileWatcher::watchFiles(const QStringList& filePaths)
+{
+    QStringList pathsToAdd;
+    QVector<HashJob> jobs;
+    for (const QString& filePath : filePaths)
+    {
+        const QString path = QDir::cleanPath(filePath);
+        if (path.isEmpty()) continue;
+
+        WatchedFile& file = _files[path];
+        if (++file.refCount > 1) continue;
+
+        pathsToAdd.push_back(path);
+        jobs.push_back({ path, file.revision, false });
+    }
+
+    if (pathsToAdd.empty()) return;
+
+    _watcher->addPaths(pathsToAdd); // Fails silently for missing files
+    startHashing(jobs);
+}
+
+void FileWatcher::unwatchFiles(const QStringList& filePaths)
+{
+    QStringList pathsToRemove;
+    for (const QString& filePath : filePaths)
+    {
+        const QString path = QDir::cleanPath(filePath);
+        auto it = _files.find(path);
+        if (it == _files.end() || --it->second.refCount > 0) continue;
+
+        _files.erase(it);
+        _pendingFiles.remove(path);
+        pathsToRemove.push_back(path);
+    }
+
+    if (!pathsToRemove.empty()) _watcher->removePaths(pathsToRemove);
+}
+
+void FileWatcher::watchDirectory(const QString& dirPath)
+{
+    const QString path = QDir::cleanPath(dirPath);
+    if (path.isEmpty()) return;
+
+    if (++_directories[path] == 1)
+        _watcher->addPath(path);
+}
+
+void FileWatcher::unwatchDirectory(const QString& dirPath)
+{
+    const QString path = QDir::cleanPath(dirPath);
+    auto it = _directories.find(path);
+    if (it == _directories.end() || --it->second > 0) return;
+
+    _directories.erase(it);
+    _pendingDirectories.remove(path);
+    _watcher->removePath(path);
+}
+
+// Must be called before writing a watched file, the notification of this write will then be not external
+void FileWatcher::setExpectedContents(const QString& filePath, const QByteArray& contents)
+{
+    auto it = _files.find(QDir::cleanPath(filePath));
+    if (it == _files.end()) return;
+
+    it->second.expectedHash = QCryptographicHash::hash(contents, QCryptographicHash::Md5);
+    ++it->second.revision;
+}
+
+bool FileWatcher::isWatchingFile(const QString& filePath) const
+{
+    return _files.find(QDir::cleanPath(filePath)) != _files.end();
+}
+
+// Runs in a worker thread
+FileWatcher::HashResult FileWatcher::hashFile(const HashJob& job)
+{
+    HashResult result;
+    result.job = job;
+
+    // Taken before reading, a write during hashing will be noticed next time
+    const QFileInfo info(job.filePath);
+    result.modified = info.lastModified();
+    result.size = info.size();
+
+    QFile file(job.filePath);
+    if (!file.open(QIODevice::ReadOnly)) return result;
+
+    QCryptographicHash hash(QCryptographicHash::Md5);
+    if (!hash.addData(&file)) return result;
+
+    result.hash = hash.result();
+    result.exists = true;
+    return result;
+}
+
+void FileWatcher::onRawFileChanged(const QString& filePath)
+{
+    _pendingFiles.insert(filePath);
+    _debounceTimer->start();
+}
+
+void FileWatcher::onRawDirectoryChanged(const QString& dirPath)
+{
+    _pendingDirectories.insert(dirPath);
+    _debounceTimer->start();
+}
+
+void FileWatcher::processPendingChanges()
+{
+    const QSet<QString> dirs = std::move(_pendingDirectories);
+    const QSet<QString> files = std::move(_pendingFiles);
+    _pendingDirectories.clear();
+    _pendingFiles.clear();
+
+    // QSet::fromList is deprecated since Qt 5.14
+    QSet<QString> systemWatchedFiles;
+    for (const QString& path : _watcher->files())
+        systemWatchedFiles.insert(path);
+
+    QVector<HashJob> jobs;
+    for (const QString& path : files)
+    {
+        auto it = _files.find(path);
+        if (it == _files.end()) continue;
+
+        // Replacing the file instead of rewriting it makes the watcher drop the path
+        const QFileInfo info(path);
+        if (!systemWatchedFiles.contains(path) && info.exists())
+            _watcher->addPath(path);
+
+        // Attribute changes are reported too, contents can't differ if neither time nor size did
+        const WatchedFile& file = it->second;
+        if (info.exists() && !file.hash.isEmpty() && info.lastModified() == file.modified && info.size() == file.size)
+            continue;
+
+        jobs.push_back({ path, it->second.revision, true });
+    }
+
+    if (!jobs.empty()) startHashing(jobs);
+
+    for (const QString& path : dirs)
+        if (_directories.find(path) != _directories.end())
+            emit directoryChanged(path);
+}
+
+void FileWatcher::startHashing(const QVector<HashJob>& jobs)
+{
+    auto watcher = new QFutureWatcher<HashResult>(this);
+    connect(watcher, &QFutureWatcher<HashResult>::finished, this, [this, watcher]()
+    {
+        onHashed(watcher->future().results().toVector());
+        watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::mapped(jobs, hashFile));
+}
+
+void FileWatcher::onHashed(const QVector<HashResult>& results)
+{
+    for (const HashResult& result : results)
+    {
+        auto it = _files.find(result.job.filePath);
+        if (it == _files.end() || it->second.revision != result.job.revision) continue;
+
+        WatchedFile& file = it->second;
+        if (!result.job.notify)
+        {
+            // A change notification may have been processed already, it knows better
+            if (file.hash.isEmpty())
+            {
+                file.hash = result.hash;
+                file.modified = result.modified;
+                file.size = result.size;
+            }
+        }
+        else if (!result.exists)
+        {
+            file.hash.clear();
+            file.size = -1;
+            emit fileRemoved(result.job.filePath);
+        }
+        else
+        {
+            file.modified = result.modified;
+            file.size = result.size;
+            if (file.hash == result.hash) continue;
+
+            const bool external = (file.expectedHash != result.hash);
+            file.hash = result.hash;
+            file.expectedHash.clear();
+            emit fileChanged(result.job.filePath, external);
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include "qobject.h"
+#include "qset.h"
+#include "qstringlist.h"
+#include "qdatetime.h"
+#include "src/QtStdHash.h"
+#include <unordered_map>
+
+// The single file system watcher of the application. Editors, imagesets and the project index subscribe
+// to paths they are interested in, watching is reference counted. Raw notifications are debounced, so that
+// a burst of writes produces one notification per file. Contents are hashed in background only when the
+// modification time or size changed, and compared with the last known hash, so writes that don't change
+// anything are not reported. Our own saves announced with setExpectedContents are reported as not external,
+// so that the saving editor can ignore them while others, like the project index, still learn about them.
+
+class QFileSystemWatcher;
+class QTimer;
+
+class FileWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+
+    explicit FileWatcher(QObject* parent = nullptr);
+
+    void watchFile(const QString& filePath) { watchFiles({ filePath }); }
+    void unwatchFile(const QString& filePath) { unwatchFiles({ filePath }); }
+    void watchFiles(const QStringList& filePaths);
+    void unwatchFiles(const QStringList& filePaths);
+    void watchDirectory(const QString& dirPath);
+    void unwatchDirectory(const QString& dirPath);
+    void setExpectedContents(const QString& filePath, const QByteArray& contents);
+
+    bool isWatchingFile(const QString& filePath) const;
+
+signals:
+
+    void fileChanged(const QString& filePath, bool external);
+    void fileRemoved(const QString& filePath);
+    void directoryChanged(const QString& dirPath);
+
+protected:
+
+    struct WatchedFile
+    {
+        QByteArray hash;   // Empty when unknown or the file doesn't exist
+        QByteArray expectedHash; // Contents of our own pending save
+        QDateTime modified;
+        qint64 size = -1;
+        int refCount = 0;
+        int revision = 0;  // Hashing results started before setExpectedContents are dropped
+    };
+
+    struct HashJob
+    {
+        QString filePath;
+        int revision;
+        bool notify;       // False for the initial hash of a newly watched file
+    };
+
+    struct HashResult
+    {
+        HashJob job;
+        QByteArray hash;
+        QDateTime modified;
+        qint64 size = -1;
+        bool exists = false;
+    };
+
+    static HashResult hashFile(const HashJob& job);
+
+    void onRawFileChanged(const QString& filePath);
+    void onRawDirectoryChanged(const QString& dirPath);
+    void processPendingChanges();
+    void startHashing(const QVector<HashJob>& jobs);
+    void onHashed(const QVector<HashResult>& results);
+
+    QFileSystemWatcher* _watcher = nullptr;
+    QTimer* _debounceTimer = nullptr;
+
+    std::unordered_map<QString, WatchedFile> _files;
+    std::unordered_map<QString, int> _directories; // Reference counts
+    QSet<QString> _pendingFiles;
+    QSet<QString> _pendingDirectories;
+};
+
+#endif // FILEWATCHER_H
@@ -0,0 +1,59 @@
+#include "src/util/FileWriter.h"
+#include "src/QtStdHash.h"
+#include "qsavefile.h"
+#include "qfileinfo.h"
+#include "qdir.h"
+#include "qthread.h"
+#include "qthreadpool.h"
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <unordered_map>
+
+static QThreadPool& getWritePool()
+{
+    static QThreadPool pool;
+    static const bool initialized = [](QThreadPool& p)
+    {
+        p.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), FileWriter::MaxThreadCount));
+        return true;
+    }(pool);
+    Q_UNUSED(initialized);
+    return pool;
+}
+
+// Must be called from the main thread
+QFuture<bool> FileWriter::write(const QString& filePath, const QByteArray& data)
+{
+    static std::unordered_map<QString, QFuture<bool>> lastWrites;
+
+    // Only files being written are remembered
+    for (auto it = lastWrites.begin(); it != lastWrites.end(); )
+        it = it->second.isFinished() ? lastWrites.erase(it) : std::next(it);
+
+    const QString path = QDir::cleanPath(QFileInfo(filePath).absoluteFilePath());
+    auto prevIt = lastWrites.find(path);
+    QFuture<bool> prevWrite = (prevIt != lastWrites.end()) ? prevIt->second : QFuture<bool>();
+
+    QFuture<bool> future = QtConcurrent::run(&getWritePool(), [path, data, prevWrite]() mutable
+    {
+        // Waiting for a write not started yet runs it in this thread, so waiters can't exhaust the pool
+        prevWrite.waitForFinished();
+        return writeFile(path, data);
+    });
+
+    lastWrites[path] = future;
+    return future;
+}
+
+// Runs in a worker thread
+bool FileWriter::writeFile(const QString& filePath, const QByteArray& data)
+{
+    // QSaveFile writes to a temporary file, flushes it to disk and replaces the target only on success
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    if (file.write(data) != data.size())
+    {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
@@ -0,0 +1,26 @@
+#ifndef FILEWRITER_H
+#define FILEWRITER_H
+
+#include "qstring.h"
+#include "qbytearray.h"
+#include "qfuture.h"
+
+// Writes files on background threads. Different files are written in parallel by a small pool,
+// writes of the same file are done in the order they were requested, so that an older snapshot
+// never overwrites a newer one. The existing file is replaced only when new contents are completely
+// written, so a crash or an error in the middle of writing never corrupts it.
+
+class FileWriter
+{
+public:
+
+    static constexpr int MaxThreadCount = 4; // Writing is mostly waiting for the disk, more would thrash it
+
+    static QFuture<bool> write(const QString& filePath, const QByteArray& data);
+
+protected:
+
+    static bool writeFile(const QString& filePath, const QByteArray& data);
+};
+
+#endif // FILEWRITER_H
@@ -0,0 +1,193 @@
+#include "src/util/ImageDiff.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qdir.h"
+#include "qdiriterator.h"
+#include "qtextstream.h"
+#include <QtConcurrent/qtconcurrentmap.h>
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+struct CompareJob
+{
+    QString fileName;
+    QString actualPath;
+    QString goldenPath;
+    QString diffPath;
+    int tolerance;
+};
+
+}
+
+// Runs in a worker thread
+static ImageDiff::Result compareFiles(const CompareJob& job)
+{
+    ImageDiff::Result result;
+    result.fileName = job.fileName;
+
+    if (!QFileInfo::exists(job.goldenPath))
+    {
+        result.status = ImageDiff::Status::NoGolden;
+        return result;
+    }
+
+    const QImage actual(job.actualPath);
+    const QImage golden(job.goldenPath);
+    if (actual.isNull() || golden.isNull())
+    {
+        result.error = QString("Can't load '%1'").arg(actual.isNull() ? job.actualPath : job.goldenPath);
+        return result;
+    }
+
+    result.totalPixels = static_cast<qint64>(actual.width()) * actual.height();
+
+    if (actual.size() != golden.size())
+    {
+        result.status = ImageDiff::Status::SizeChanged;
+        result.changedPixels = result.totalPixels;
+        return result;
+    }
+
+    QImage diffImage;
+    result.changedPixels = ImageDiff::countChangedPixels(actual, golden, job.tolerance, &result.maxDifference, &diffImage);
+    if (!result.changedPixels)
+    {
+        result.status = ImageDiff::Status::Same;
+        return result;
+    }
+
+    result.status = ImageDiff::Status::Changed;
+
+    QDir().mkpath(QFileInfo(job.diffPath).path());
+    if (diffImage.save(job.diffPath, "PNG"))
+        result.diffFilePath = job.diffPath;
+    else
+        result.error = QString("Failed to save '%1'").arg(job.diffPath);
+
+    return result;
+}
+
+QString ImageDiff::getStatusName(Status status)
+{
+    switch (status)
+    {
+        case Status::Same: return "Same";
+        case Status::Changed: return "Changed";
+        case Status::SizeChanged: return "Size changed";
+        case Status::NoGolden: return "No golden image";
+        case Status::NotRendered: return "Not rendered";
+        case Status::NoRender: return "No rendered image";
+        default: return "Error";
+    }
+}
+
+// Images must be of the same size
+qint64 ImageDiff::countChangedPixels(const QImage& actual, const QImage& golden, int tolerance, int* maxDifference, QImage* diffImage)
+{
+    const QImage a = actual.convertToFormat(QImage::Format_ARGB32);
+    const QImage b = golden.convertToFormat(QImage::Format_ARGB32);
+    const int width = a.width();
+    const int height = a.height();
+    const int rowBytes = width * 4;
+    const uchar threshold = static_cast<uchar>(qBound(0, tolerance, 255));
+
+    if (diffImage) *diffImage = QImage(a.size(), QImage::Format_ARGB32);
+
+    std::vector<uchar> rowDiff(static_cast<size_t>(rowBytes));
+    qint64 changed = 0;
+    uchar maxDiff = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        const uchar* rowA = a.constScanLine(y);
+        const uchar* rowB = b.constScanLine(y);
+        uchar* diff = rowDiff.data();
+
+        // Branchless absolute differences of all channels, vectorized by the compiler
+        for (int i = 0; i < rowBytes; ++i)
+        {
+            const uchar hi = std::max(rowA[i], rowB[i]);
+            const uchar lo = std::min(rowA[i], rowB[i]);
+            diff[i] = static_cast<uchar>(hi - lo);
+        }
+
+        uchar rowMax = 0;
+        int rowChanged = 0;
+        for (int i = 0; i < rowBytes; i += 4)
+        {
+            const uchar pixelMax = std::max(std::max(diff[i], diff[i + 1]), std::max(diff[i + 2], diff[i + 3]));
+            rowMax = std::max(rowMax, pixelMax);
+            rowChanged += (pixelMax > threshold);
+        }
+
+        changed += rowChanged;
+        maxDiff = std::max(maxDiff, rowMax);
+
+        if (diffImage)
+        {
+            // Changed pixels are red, the rest is the faded golden image
+            QRgb* out = reinterpret_cast<QRgb*>(diffImage->scanLine(y));
+            const QRgb* pixels = reinterpret_cast<const QRgb*>(rowB);
+            for (int x = 0; x < width; ++x)
+            {
+                const uchar* d = diff + x * 4;
+                const bool isChanged = std::max(std::max(d[0], d[1]), std::max(d[2], d[3])) > threshold;
+                const int grey = 192 + qGray(pixels[x]) / 4;
+                out[x] = isChanged ? qRgb(255, 0, 0) : qRgb(grey, grey, grey);
+            }
+        }
+    }
+
+    if (maxDifference) *maxDifference = maxDiff;
+    return changed;
+}
+
+std::vector<ImageDiff::Result> ImageDiff::compareDirectories(const QString& actualDir, const QString& goldenDir, const QStringList& fileNames,
+                                                             const QString& diffDir, int tolerance)
+{
+    QVector<CompareJob> jobs;
+    for (const QString& fileName : fileNames)
+    {
+        jobs.push_back({ fileName, QDir(actualDir).filePath(fileName), QDir(goldenDir).filePath(fileName),
+                         QDir(diffDir).filePath(fileName), tolerance });
+    }
+
+    const auto results = QtConcurrent::blockingMapped<QVector<Result>>(jobs, compareFiles);
+    return std::vector<Result>(results.begin(), results.end());
+}
+
+QStringList ImageDiff::findImages(const QString& dir)
+{
+    QStringList fileNames;
+    const QDir baseDir(dir);
+    QDirIterator it(dir, { "*.png" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        fileNames.push_back(baseDir.relativeFilePath(it.next()));
+    return fileNames;
+}
+
+bool ImageDiff::writeReport(const QString& filePath, const std::vector<Result>& results)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) return false;
+
+    auto quote = [](QString value)
+    {
+        return '"' + value.replace('"', "\"\"") + '"';
+    };
+
+    QTextStream stream(&file);
+    stream.setCodec("UTF-8");
+    stream << "Image,Status,Changed pixels,Total pixels,Max difference,Diff image,Error\n";
+    for (const Result& result : results)
+    {
+        stream << quote(result.fileName) << ',' << quote(getStatusName(result.status)) << ','
+               << result.changedPixels << ',' << result.totalPixels << ',' << result.maxDifference << ','
+               << quote(result.diffFilePath) << ',' << quote(result.error) << '\n';
+    }
+
+    stream.flush();
+    return stream.status() == QTextStream::Ok;
+}
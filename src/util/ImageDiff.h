@@ -0,0 +1,50 @@
+#ifndef IMAGEDIFF_H
+#define IMAGEDIFF_H
+
+#include "qimage.h"
+#include "qstringlist.h"
+#include "qvector.h"
+#include <vector>
+
+// Compares rendered images with stored golden images. A pixel is changed when any of its channels
+// differs by more than the tolerance. Rows are compared with plain byte loops the compiler vectorizes.
+// A diff image shows changed pixels in red over the faded golden image.
+
+class ImageDiff
+{
+public:
+
+    enum class Status
+    {
+        Same,
+        Changed,
+        SizeChanged,
+        NoGolden,
+        NotRendered, // The layout failed to render
+        NoRender,    // The golden image has no rendered counterpart
+        Error
+    };
+
+    struct Result
+    {
+        Status status = Status::Error;
+        QString fileName;      // Relative to the compared directories
+        QString diffFilePath;  // Empty if no diff image was saved
+        qint64 changedPixels = 0;
+        qint64 totalPixels = 0;
+        int maxDifference = 0; // Largest channel difference
+        QString error;
+    };
+
+    static QString getStatusName(Status status);
+
+    static qint64 countChangedPixels(const QImage& actual, const QImage& golden, int tolerance, int* maxDifference = nullptr, QImage* diffImage = nullptr);
+
+    // Compares files with the same relative names in parallel, diff images of changed ones are saved to diffDir
+    static std::vector<Result> compareDirectories(const QString& actualDir, const QString& goldenDir, const QStringList& fileNames,
+                                                  const QString& diffDir, int tolerance);
+    static QStringList findImages(const QString& dir); // Relative names of all PNG files in the directory tree
+    static bool writeReport(const QString& filePath, const std::vector<Result>& results);
+};
+
+#endif // IMAGEDIFF_H
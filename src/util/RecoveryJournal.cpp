@@ -0,0 +1,272 @@
+#include "src/util/RecoveryJournal.h"
+#include <qstandardpaths.h>
+#include <qcryptographichash.h>
+#include <qlockfile.h>
+#include <qsavefile.h>
+#include <qdatastream.h>
+#include <qfileinfo.h>
+#include <qdir.h>
+#include <qthreadpool.h>
+#include <quuid.h>
+#include <QtConcurrent/qtconcurrentrun.h>
+#include <atomic>
+
+static const quint32 JournalMagic = 0xCEED0A11;
+static const quint16 JournalVersion = 1;
+static const QString JournalExtension = ".journal";
+
+enum class JournalRecord : quint8
+{
+    Command = 1,
+    Snapshot = 2
+};
+
+// Shared with writing tasks, accessed only from the writer thread
+struct RecoveryJournalFile
+{
+    QString path;
+    QByteArray header;
+    QFile file;
+    std::atomic<int> snapshotSize { 0 }; // Uncompressed, read by the editor to space snapshots
+};
+
+// One thread for all journals keeps writes ordered and doesn't compete with the editor for cores
+static QThreadPool& getWriterPool()
+{
+    static QThreadPool pool;
+    static const bool initialized = [](QThreadPool& p) { p.setMaxThreadCount(1); return true; }(pool);
+    Q_UNUSED(initialized);
+    return pool;
+}
+
+static QString getJournalPathFor(const QString& filePath)
+{
+    const auto hash = QCryptographicHash::hash(QDir::cleanPath(filePath).toUtf8(), QCryptographicHash::Md5).toHex();
+    return QDir(RecoveryJournal::getJournalDirectory()).filePath(QString::fromLatin1(hash) + JournalExtension);
+}
+
+QString RecoveryJournal::getJournalDirectory()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("recovery");
+}
+
+// Journals not locked by any running CEED instance are left after a crash. They are moved aside under
+// unique names, so that editors opened before the user decides on recovery start their own journals
+// instead of overwriting these. Journals kept for later are found by the next call the same way.
+// Must be called before any editor is opened.
+QStringList RecoveryJournal::takeOrphanedJournals()
+{
+    QStringList result;
+
+    const QDir dir(getJournalDirectory());
+    for (const QFileInfo& info : dir.entryInfoList({ "*" + JournalExtension }, QDir::Files))
+    {
+        const QString lockPath = info.absoluteFilePath() + ".lock";
+        QLockFile lock(lockPath);
+        if (!lock.tryLock(0)) continue;
+
+        const QString takenPath = dir.filePath(QUuid::createUuid().toString(QUuid::StringFormat::WithoutBraces) + JournalExtension);
+        const bool taken = QFile::rename(info.absoluteFilePath(), takenPath);
+        lock.unlock();
+        QFile::remove(lockPath);
+
+        if (taken) result.push_back(takenPath);
+    }
+
+    return result;
+}
+
+// Reads as much as possible, a tail truncated by the crash is ignored
+bool RecoveryJournal::read(const QString& journalPath, Contents& outContents)
+{
+    QFile file(journalPath);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream stream(&file);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    stream >> magic >> version;
+    if (magic != JournalMagic || version != JournalVersion) return false;
+
+    stream >> outContents.filePath >> outContents.baseModified;
+    if (stream.status() != QDataStream::Ok) return false;
+
+    bool hasSnapshot = false;
+    while (!stream.atEnd())
+    {
+        quint8 type = 0;
+        qint32 index = 0;
+        stream >> type >> index;
+
+        if (type == static_cast<quint8>(JournalRecord::Command))
+        {
+            QString text;
+            stream >> text;
+            if (stream.status() != QDataStream::Ok) break;
+            outContents.lostChanges.push_back(text);
+        }
+        else if (type == static_cast<quint8>(JournalRecord::Snapshot))
+        {
+            QByteArray compressed;
+            stream >> compressed;
+            if (stream.status() != QDataStream::Ok) break;
+            outContents.data = qUncompress(compressed);
+            outContents.lostChanges.clear();
+            hasSnapshot = true;
+        }
+        else break;
+    }
+
+    return hasSnapshot && !outContents.filePath.isEmpty();
+}
+
+void RecoveryJournal::remove(const QString& journalPath)
+{
+    QFile::remove(journalPath);
+    QFile::remove(journalPath + ".lock");
+}
+
+RecoveryJournal::RecoveryJournal(const QString& filePath)
+{
+    reset(filePath);
+}
+
+RecoveryJournal::~RecoveryJournal()
+{
+    release();
+}
+
+void RecoveryJournal::acquire()
+{
+    _journalPath = getJournalPathFor(_filePath);
+    QDir().mkpath(getJournalDirectory());
+
+    // Another instance editing the same file owns the journal, writing or removing it would destroy
+    // that instance's recovery data. This editor is left without journaling then.
+    _lock.reset(new QLockFile(_journalPath + ".lock"));
+    if (!_lock->tryLock(0))
+    {
+        _lock.reset();
+        return;
+    }
+
+    _file = std::make_shared<RecoveryJournalFile>();
+    _file->path = _journalPath;
+    _started = false;
+}
+
+// Closing normally, nothing to recover
+void RecoveryJournal::release()
+{
+    if (!_file) return;
+
+    auto file = std::move(_file);
+    _lastWrite = QtConcurrent::run(&getWriterPool(), [file]()
+    {
+        file->file.close();
+        QFile::remove(file->path);
+    });
+    _lastWrite.waitForFinished();
+
+    _lock.reset();
+}
+
+// Called when the file is saved or renamed, starts from scratch
+void RecoveryJournal::reset(const QString& filePath)
+{
+    release();
+    _filePath = filePath;
+    acquire();
+}
+
+void RecoveryJournal::waitForWrites()
+{
+    _lastWrite.waitForFinished();
+}
+
+// The journal file is created lazily on the first change, unmodified files leave no journals
+void RecoveryJournal::startWriting()
+{
+    if (_started) return;
+    _started = true;
+
+    QByteArray header;
+    {
+        QDataStream stream(&header, QIODevice::WriteOnly);
+        stream << JournalMagic << JournalVersion << _filePath << QFileInfo(_filePath).lastModified();
+    }
+
+    auto file = _file;
+    _lastWrite = QtConcurrent::run(&getWriterPool(), [file, header]()
+    {
+        file->header = header;
+        file->file.setFileName(file->path);
+        if (file->file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            file->file.write(header);
+            file->file.flush();
+        }
+    });
+}
+
+void RecoveryJournal::recordCommand(int index, const QString& text)
+{
+    if (!_file) return;
+
+    startWriting();
+
+    QByteArray record;
+    {
+        QDataStream stream(&record, QIODevice::WriteOnly);
+        stream << static_cast<quint8>(JournalRecord::Command) << static_cast<qint32>(index) << text;
+    }
+
+    auto file = _file;
+    _lastWrite = QtConcurrent::run(&getWriterPool(), [file, record]()
+    {
+        if (!file->file.isOpen()) return;
+        file->file.write(record);
+        file->file.flush();
+    });
+}
+
+// Snapshot replaces the whole journal atomically, so a crash during compaction keeps the previous one.
+// The serializer works on a copy of the editor state and is called in the writer thread.
+void RecoveryJournal::recordSnapshot(int index, std::function<QByteArray()>&& serializer)
+{
+    if (!_file) return;
+
+    startWriting();
+
+    auto file = _file;
+    _lastWrite = QtConcurrent::run(&getWriterPool(), [file, index, serializer]()
+    {
+        const QByteArray rawData = serializer();
+        if (rawData.isEmpty()) return;
+        file->snapshotSize = rawData.size();
+
+        QByteArray record;
+        {
+            QDataStream stream(&record, QIODevice::WriteOnly);
+            stream << static_cast<quint8>(JournalRecord::Snapshot) << static_cast<qint32>(index) << qCompress(rawData);
+        }
+
+        file->file.close();
+
+        QSaveFile compacted(file->path);
+        if (compacted.open(QIODevice::WriteOnly))
+        {
+            compacted.write(file->header);
+            compacted.write(record);
+            compacted.commit();
+        }
+
+        file->file.open(QIODevice::WriteOnly | QIODevice::Append);
+    });
+}
+
+int RecoveryJournal::getLastSnapshotSize() const
+{
+    return _file ? _file->snapshotSize.load() : 0;
+}
@@ -0,0 +1,64 @@
+#ifndef RECOVERYJOURNAL_H
+#define RECOVERYJOURNAL_H
+
+#include "qstring.h"
+#include "qstringlist.h"
+#include "qdatetime.h"
+#include "qfuture.h"
+#include <memory>
+#include <functional>
+
+// Append-only crash recovery journal of an open file. The document is periodically snapshotted, only
+// snapshots can be restored. Undo stack changes are recorded by their names only, to tell the user what
+// was made after the last snapshot and is lost. Snapshot compacts the journal, dropping older records.
+// All disk work including snapshot serialization and compression happens on a background thread, so
+// the editor pays only for taking a copy of its state. The journal is removed when the editor saves or
+// closes normally, so a journal found at startup means that CEED crashed and the file may have unsaved changes.
+
+class QLockFile;
+struct RecoveryJournalFile;
+
+class RecoveryJournal
+{
+public:
+
+    struct Contents
+    {
+        QString filePath;
+        QDateTime baseModified; // Modification time of the saved file the journal is based on
+        QByteArray data;        // Last document snapshot
+        QStringList lostChanges; // Changes made after the last snapshot, can't be restored
+    };
+
+    static QString getJournalDirectory();
+    static QStringList takeOrphanedJournals();
+    static bool read(const QString& journalPath, Contents& outContents);
+    static void remove(const QString& journalPath);
+
+    RecoveryJournal(const QString& filePath);
+    ~RecoveryJournal();
+
+    void recordCommand(int index, const QString& text);
+    void recordSnapshot(int index, std::function<QByteArray()>&& serializer);
+    int getLastSnapshotSize() const;
+    void reset(const QString& filePath);
+    void waitForWrites();
+
+    const QString& getFilePath() const { return _filePath; }
+    bool isActive() const { return _file != nullptr; } // False if the journal is locked by another instance
+
+protected:
+
+    void acquire();
+    void release();
+    void startWriting();
+
+    QString _filePath;
+    QString _journalPath;
+    std::shared_ptr<RecoveryJournalFile> _file;
+    std::unique_ptr<QLockFile> _lock;
+    QFuture<void> _lastWrite;
+    bool _started = false;
+};
+
+#endif // RECOVERYJOURNAL_H
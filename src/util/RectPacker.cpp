@@ -0,0 +1,205 @@
+#include "src/util/RectPacker.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <limits>
+#include <unordered_set>
+
+namespace
+{
+
+// Horizontal segment of the top edge of packed rects
+struct SkylineSegment
+{
+    int x;
+    int y;
+    int width;
+};
+
+// Returns the lowest Y the rect can be placed at starting from the segment, or -1 if it doesn't fit
+// or can't be placed lower than 'maxY'
+static int findFit(const std::vector<SkylineSegment>& skyline, size_t segment, int width, int binWidth, int maxY)
+{
+    if (skyline[segment].x + width > binWidth) return -1;
+
+    int y = 0;
+    int widthLeft = width;
+    for (size_t i = segment; widthLeft > 0; ++i)
+    {
+        y = std::max(y, skyline[i].y);
+        if (y >= maxY) return -1;
+        widthLeft -= skyline[i].width;
+    }
+    return y;
+}
+
+static void addRect(std::vector<SkylineSegment>& skyline, size_t segment, int y, QSize size)
+{
+    const SkylineSegment newSegment{ skyline[segment].x, y + size.height(), size.width() };
+    skyline.insert(skyline.begin() + static_cast<std::ptrdiff_t>(segment), newSegment);
+
+    // Cut segments hidden under the new one
+    const int right = newSegment.x + newSegment.width;
+    size_t i = segment + 1;
+    while (i < skyline.size() && skyline[i].x < right)
+    {
+        const int shrink = right - skyline[i].x;
+        skyline[i].x += shrink;
+        skyline[i].width -= shrink;
+        if (skyline[i].width > 0) break;
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+
+    // Merge neighbours of the same height, only the new segment may have them
+    if (segment + 1 < skyline.size() && skyline[segment].y == skyline[segment + 1].y)
+    {
+        skyline[segment].width += skyline[segment + 1].width;
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(segment) + 1);
+    }
+    if (segment > 0 && skyline[segment - 1].y == skyline[segment].y)
+    {
+        skyline[segment - 1].width += skyline[segment].width;
+        skyline.erase(skyline.begin() + static_cast<std::ptrdiff_t>(segment));
+    }
+}
+
+static int nextPowerOfTwo(int value)
+{
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+// From the tallest to the lowest
+static std::vector<size_t> getPackingOrder(const std::vector<QSize>& sizes)
+{
+    std::vector<size_t> order(sizes.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&sizes](size_t a, size_t b)
+    {
+        return sizes[a].height() > sizes[b].height() ||
+                (sizes[a].height() == sizes[b].height() && sizes[a].width() > sizes[b].width());
+    });
+    return order;
+}
+
+// Gives up as soon as the used height exceeds 'maxHeight', such a width can't beat the best one found
+static int packInOrder(const std::vector<QSize>& sizes, const std::vector<size_t>& order, int binWidth, int maxHeight,
+                       std::vector<QPoint>& outPositions)
+{
+    outPositions.assign(sizes.size(), QPoint());
+
+    std::vector<SkylineSegment> skyline{ { 0, 0, binWidth } };
+    int usedHeight = 0;
+    for (size_t index : order)
+    {
+        const QSize& size = sizes[index];
+
+        int bestTop = -1;
+        int bestY = 0;
+        size_t bestSegment = 0;
+        for (size_t i = 0; i < skyline.size(); ++i)
+        {
+            // Only positions lower than the best one so far are interesting
+            const int maxY = (bestTop < 0) ? std::numeric_limits<int>::max() : bestY;
+            const int y = findFit(skyline, i, size.width(), binWidth, maxY);
+            if (y < 0) continue;
+
+            bestTop = y + size.height();
+            bestY = y;
+            bestSegment = i;
+        }
+
+        if (bestTop < 0 || bestTop > maxHeight) return -1;
+
+        outPositions[index] = QPoint(skyline[bestSegment].x, bestY);
+        addRect(skyline, bestSegment, bestY, size);
+        usedHeight = std::max(usedHeight, bestTop);
+    }
+
+    return usedHeight;
+}
+
+}
+
+int RectPacker::pack(const std::vector<QSize>& sizes, int binWidth, std::vector<QPoint>& outPositions)
+{
+    return packInOrder(sizes, getPackingOrder(sizes), binWidth, std::numeric_limits<int>::max(), outPositions);
+}
+
+QSize RectPacker::findAtlasSize(const std::vector<QSize>& sizes, int spacing, bool powerOfTwo, std::vector<QPoint>& outPositions)
+{
+    outPositions.clear();
+    if (sizes.empty()) return QSize();
+
+    // Spacing is added to the right and bottom of each rect, the atlas itself has no spacing at its edges
+    std::vector<QSize> paddedSizes;
+    paddedSizes.reserve(sizes.size());
+    int maxWidth = 0;
+    qint64 area = 0;
+    for (const QSize& size : sizes)
+    {
+        paddedSizes.push_back(size + QSize(spacing, spacing));
+        maxWidth = std::max(maxWidth, size.width());
+        area += static_cast<qint64>(size.width() + spacing) * (size.height() + spacing);
+    }
+
+    const int squareSide = std::max(maxWidth, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area)))));
+
+    // The order doesn't depend on the width
+    const std::vector<size_t> order = getPackingOrder(paddedSizes);
+
+    QSize bestSize;
+    int bestWidth = 0;
+    std::vector<QPoint> positions;
+    std::unordered_set<int> triedWidths;
+    auto tryWidth = [&](int width)
+    {
+        if (width < maxWidth || !triedWidths.insert(width).second) return;
+
+        const qint64 bestArea = static_cast<qint64>(bestSize.width()) * bestSize.height();
+        const qint64 maxHeight = bestSize.isEmpty() ? std::numeric_limits<int>::max() : (bestArea / width + spacing);
+        const int usedHeight = packInOrder(paddedSizes, order, width + spacing,
+                                           static_cast<int>(std::min<qint64>(maxHeight, std::numeric_limits<int>::max())), positions);
+        if (usedHeight < 0) return;
+
+        QSize size(width, std::max(1, usedHeight - spacing));
+        if (powerOfTwo) size.setHeight(nextPowerOfTwo(size.height()));
+
+        const qint64 sizeArea = static_cast<qint64>(size.width()) * size.height();
+        if (bestSize.isEmpty() || sizeArea < bestArea ||
+                (sizeArea == bestArea && std::max(size.width(), size.height()) < std::max(bestSize.width(), bestSize.height())))
+        {
+            bestSize = size;
+            bestWidth = width;
+            outPositions = positions;
+        }
+    };
+
+    if (powerOfTwo)
+    {
+        for (int width = nextPowerOfTwo(maxWidth); width <= 2 * nextPowerOfTwo(squareSide); width <<= 1)
+            tryWidth(width);
+    }
+    else
+    {
+        // A few widths around the side of a square of the same area, then a finer search around the best of them
+        constexpr int coarseSamples = 8;
+        constexpr int refineDivisor = 128;
+        const int minWidth = std::max(maxWidth, squareSide / 2);
+        const int maxSampledWidth = std::max(minWidth, squareSide * 2);
+        const int range = maxSampledWidth - minWidth;
+        for (int i = 0; i <= coarseSamples; ++i)
+            tryWidth(minWidth + range * i / coarseSamples);
+
+        const int minStep = std::max(1, range / refineDivisor);
+        for (int step = range / (2 * coarseSamples); bestWidth && step >= minStep; step /= 2)
+        {
+            const int center = bestWidth;
+            tryWidth(std::max(minWidth, center - step));
+            tryWidth(std::min(maxSampledWidth, center + step));
+        }
+    }
+
+    return bestSize;
+}
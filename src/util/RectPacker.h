@@ -0,0 +1,22 @@
+#ifndef RECTPACKER_H
+#define RECTPACKER_H
+
+#include "qrect.h"
+#include <vector>
+
+// Packs rectangles into an atlas with the skyline bottom-left heuristic. Rects are placed from the
+// tallest to the lowest, each one at the position where its top edge is the lowest.
+
+class RectPacker
+{
+public:
+
+    // Returns the height used or -1 if some rect doesn't fit into the width
+    static int pack(const std::vector<QSize>& sizes, int binWidth, std::vector<QPoint>& outPositions);
+
+    // Tries different atlas widths and returns the size of the smallest area, with 'spacing' pixels
+    // between rects. A null size is returned if there is nothing to pack.
+    static QSize findAtlasSize(const std::vector<QSize>& sizes, int spacing, bool powerOfTwo, std::vector<QPoint>& outPositions);
+};
+
+#endif // RECTPACKER_H
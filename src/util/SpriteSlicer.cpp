@@ -0,0 +1,236 @@
+#include "src/util/SpriteSlicer.h"
+#include "qimage.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+// Horizontal span of opaque pixels in one row
+struct Run
+{
+    int y;
+    int x0;
+    int x1; // Inclusive
+};
+
+struct Box
+{
+    int x0;
+    int y0;
+    int x1; // Inclusive
+    int y1; // Inclusive
+
+    void unite(const Box& other)
+    {
+        x0 = std::min(x0, other.x0);
+        y0 = std::min(y0, other.y0);
+        x1 = std::max(x1, other.x1);
+        y1 = std::max(y1, other.y1);
+    }
+};
+
+class DisjointSet
+{
+public:
+
+    DisjointSet(size_t size) : _parents(size)
+    {
+        for (size_t i = 0; i < size; ++i)
+            _parents[i] = i;
+    }
+
+    size_t find(size_t i)
+    {
+        while (_parents[i] != i)
+        {
+            _parents[i] = _parents[_parents[i]];
+            i = _parents[i];
+        }
+        return i;
+    }
+
+    void unite(size_t a, size_t b)
+    {
+        a = find(a);
+        b = find(b);
+        if (a < b) _parents[b] = a;
+        else if (b < a) _parents[a] = b;
+    }
+
+private:
+
+    std::vector<size_t> _parents;
+};
+
+// Bit tricks for testing 8 alpha bytes at once, n must be in [0; 128]
+constexpr quint64 onesInBytes = ~0ULL / 255;
+
+static inline bool hasByteLessThan(quint64 x, quint64 n)
+{
+    return ((x - onesInBytes * n) & ~x & (onesInBytes * 128)) != 0;
+}
+
+// n must be in [0; 127]
+static inline bool hasByteGreaterThan(quint64 x, quint64 n)
+{
+    return (((x + onesInBytes * (127 - n)) | x) & (onesInBytes * 128)) != 0;
+}
+
+static inline quint64 loadWord(const uchar* data)
+{
+    quint64 word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// Appends runs of pixels with alpha above the threshold, transparent and opaque areas are skipped a word at a time
+static void collectRuns(const uchar* line, int width, int y, int threshold, std::vector<Run>& outRuns)
+{
+    const bool useWords = (threshold < 128);
+
+    int x = 0;
+    while (x < width)
+    {
+        if (useWords)
+            while (x + 8 <= width && !hasByteGreaterThan(loadWord(line + x), static_cast<quint64>(threshold)))
+                x += 8;
+        while (x < width && line[x] <= threshold) ++x;
+
+        if (x >= width) break;
+
+        const int start = x;
+
+        if (useWords)
+            while (x + 8 <= width && !hasByteLessThan(loadWord(line + x), static_cast<quint64>(threshold + 1)))
+                x += 8;
+        while (x < width && line[x] > threshold) ++x;
+
+        outRuns.push_back({ y, start, x - 1 });
+    }
+}
+
+// Merged boxes grow and may reach others, so merging is repeated until nothing changes
+static void mergeBoxes(std::vector<Box>& boxes, int distance)
+{
+    while (boxes.size() > 1)
+    {
+        std::sort(boxes.begin(), boxes.end(), [](const Box& a, const Box& b) { return a.x0 < b.x0; });
+
+        // Sweep along X, only boxes starting before the end of the current one can reach it
+        DisjointSet set(boxes.size());
+        bool merged = false;
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            const Box& box = boxes[i];
+            for (size_t j = i + 1; j < boxes.size() && boxes[j].x0 <= box.x1 + distance; ++j)
+            {
+                if (boxes[j].y0 <= box.y1 + distance && box.y0 <= boxes[j].y1 + distance)
+                {
+                    set.unite(i, j);
+                    merged = true;
+                }
+            }
+        }
+
+        if (!merged) break;
+
+        std::vector<Box> result;
+        std::vector<size_t> resultIndices(boxes.size(), boxes.size());
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            const size_t root = set.find(i);
+            if (resultIndices[root] == boxes.size())
+            {
+                resultIndices[root] = result.size();
+                result.push_back(boxes[i]);
+            }
+            else
+            {
+                result[resultIndices[root]].unite(boxes[i]);
+            }
+        }
+
+        boxes = std::move(result);
+    }
+}
+
+}
+
+std::vector<QRect> SpriteSlicer::findSprites(const QImage& image, const Params& params)
+{
+    if (image.isNull() || !image.hasAlphaChannel()) return {};
+
+    const QImage alpha = image.convertToFormat(QImage::Format_Alpha8);
+    const int width = alpha.width();
+    const int height = alpha.height();
+    const int threshold = std::max(0, std::min(params.alphaThreshold, 254));
+
+    // Label runs row by row, a run is connected to runs of the previous row it touches (diagonally too)
+    std::vector<Run> runs;
+    std::vector<size_t> rowStarts(static_cast<size_t>(height) + 1, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        rowStarts[static_cast<size_t>(y)] = runs.size();
+        collectRuns(alpha.constScanLine(y), width, y, threshold, runs);
+    }
+    rowStarts[static_cast<size_t>(height)] = runs.size();
+
+    DisjointSet set(runs.size());
+    for (int y = 1; y < height; ++y)
+    {
+        const size_t prevEnd = rowStarts[static_cast<size_t>(y)];
+        const size_t curEnd = rowStarts[static_cast<size_t>(y) + 1];
+        size_t prev = rowStarts[static_cast<size_t>(y) - 1];
+        for (size_t cur = prevEnd; cur < curEnd; ++cur)
+        {
+            const Run& run = runs[cur];
+            while (prev < prevEnd && runs[prev].x1 < run.x0 - 1) ++prev;
+            for (size_t i = prev; i < prevEnd && runs[i].x0 <= run.x1 + 1; ++i)
+                set.unite(cur, i);
+        }
+    }
+
+    std::vector<Box> boxes;
+    std::vector<size_t> boxIndices(runs.size(), runs.size());
+    for (size_t i = 0; i < runs.size(); ++i)
+    {
+        const Run& run = runs[i];
+        const Box runBox{ run.x0, run.y, run.x1, run.y };
+        const size_t root = set.find(i);
+        if (boxIndices[root] == runs.size())
+        {
+            boxIndices[root] = boxes.size();
+            boxes.push_back(runBox);
+        }
+        else
+        {
+            boxes[boxIndices[root]].unite(runBox);
+        }
+    }
+
+    // Components with overlapping bounds are always merged, they can't be separate images anyway
+    mergeBoxes(boxes, std::max(0, params.mergeDistance));
+
+    std::vector<QRect> result;
+    result.reserve(boxes.size());
+    const QRect imageRect(0, 0, width, height);
+    for (const Box& box : boxes)
+    {
+        const int boxWidth = box.x1 - box.x0 + 1;
+        const int boxHeight = box.y1 - box.y0 + 1;
+        if (boxWidth < params.minSize && boxHeight < params.minSize) continue;
+
+        const int padding = std::max(0, params.padding);
+        result.push_back(QRect(QPoint(box.x0, box.y0), QPoint(box.x1, box.y1))
+                         .adjusted(-padding, -padding, padding, padding)
+                         .intersected(imageRect));
+    }
+
+    std::sort(result.begin(), result.end(), [](const QRect& a, const QRect& b)
+    {
+        return a.top() < b.top() || (a.top() == b.top() && a.left() < b.left());
+    });
+
+    return result;
+}
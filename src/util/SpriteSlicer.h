@@ -0,0 +1,28 @@
+#ifndef SPRITESLICER_H
+#define SPRITESLICER_H
+
+#include "qrect.h"
+#include <vector>
+
+// Finds separate sprites on an atlas by its alpha channel. Opaque pixels are grouped into
+// 8-connected components, which are then merged by distance, filtered by size and padded.
+
+class QImage;
+
+class SpriteSlicer
+{
+public:
+
+    struct Params
+    {
+        int alphaThreshold = 0;  // Pixels with alpha above this are a part of some sprite
+        int padding = 0;         // Added around each sprite, clipped by the atlas bounds
+        int minSize = 2;         // Sprites smaller than this in both dimensions are dropped as noise
+        int mergeDistance = 0;   // Sprites separated by less than this number of pixels are merged into one
+    };
+
+    // Returns rects in a reading order, top to bottom, left to right
+    static std::vector<QRect> findSprites(const QImage& image, const Params& params);
+};
+
+#endif // SPRITESLICER_H
@@ -0,0 +1,147 @@
+#include "src/util/TiledImage.h"
+#include "qpainter.h"
+#include <cmath>
+
+TiledImage::TiledImage(size_t cacheBudget)
+    : _cacheBudget(cacheBudget)
+{
+}
+
+bool TiledImage::load(const QString& filePath)
+{
+    setImage(QImage(filePath));
+    return !isNull();
+}
+
+void TiledImage::setImage(QImage image)
+{
+    clear();
+
+    if (image.isNull()) return;
+
+    // The fastest format for both scaling and drawing
+    if (image.format() != QImage::Format_ARGB32_Premultiplied)
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    // The last level fits into one tile
+    int w = image.width();
+    int h = image.height();
+    _levelCount = 1;
+    while (w > TileSize || h > TileSize)
+    {
+        w = std::max(1, (w + 1) / 2);
+        h = std::max(1, (h + 1) / 2);
+        ++_levelCount;
+    }
+
+    _levels.resize(static_cast<size_t>(_levelCount));
+    _levels[0] = std::move(image);
+}
+
+void TiledImage::clear()
+{
+    _levels.clear();
+    _levelCount = 0;
+    _tiles.clear();
+    _tileIndex.clear();
+    _cacheSize = 0;
+}
+
+const QImage& TiledImage::getImage() const
+{
+    static const QImage empty;
+    return _levels.empty() ? empty : _levels[0];
+}
+
+// Selects the smallest level that still has enough detail for drawing at the given scale
+int TiledImage::selectLevel(qreal levelOfDetail) const
+{
+    if (levelOfDetail >= 1.0 || _levelCount <= 1) return 0;
+
+    const int level = static_cast<int>(std::floor(std::log2(1.0 / levelOfDetail)));
+    return std::min(std::max(level, 0), _levelCount - 1);
+}
+
+const QImage& TiledImage::getLevel(int level)
+{
+    QImage& levelImage = _levels[static_cast<size_t>(level)];
+    if (levelImage.isNull())
+    {
+        const QImage& prevLevel = getLevel(level - 1);
+        levelImage = prevLevel.scaled(std::max(1, (prevLevel.width() + 1) / 2), std::max(1, (prevLevel.height() + 1) / 2),
+                                      Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    return levelImage;
+}
+
+QPixmap TiledImage::getTile(int level, int x, int y)
+{
+    const quint64 key = (static_cast<quint64>(level) << 48) | (static_cast<quint64>(y) << 24) | static_cast<quint64>(x);
+
+    auto it = _tileIndex.find(key);
+    if (it != _tileIndex.end())
+    {
+        _tiles.splice(_tiles.begin(), _tiles, it->second);
+        return it->second->second;
+    }
+
+    const QImage& levelImage = getLevel(level);
+    const QRect tileRect = QRect(x * TileSize, y * TileSize, TileSize, TileSize).intersected(levelImage.rect());
+    QPixmap tile = QPixmap::fromImage(levelImage.copy(tileRect));
+
+    _tiles.emplace_front(key, tile);
+    _tileIndex.emplace(key, _tiles.begin());
+    _cacheSize += static_cast<size_t>(tileRect.width() * tileRect.height() * 4);
+
+    // Evict least recently used tiles, but never the one just created
+    while (_cacheSize > _cacheBudget && _tiles.size() > 1)
+    {
+        const QPixmap& evicted = _tiles.back().second;
+        _cacheSize -= static_cast<size_t>(evicted.width() * evicted.height() * 4);
+        _tileIndex.erase(_tiles.back().first);
+        _tiles.pop_back();
+    }
+
+    return tile;
+}
+
+// Draws the part of the image visible in exposedRect (in image pixels) with tiles of the appropriate level.
+// levelOfDetail is a scale of the image on the screen, see QStyleOptionGraphicsItem::levelOfDetailFromTransform.
+void TiledImage::draw(QPainter& painter, const QRectF& exposedRect, qreal levelOfDetail)
+{
+    if (isNull()) return;
+
+    const int level = selectLevel(levelOfDetail);
+    const QImage& levelImage = getLevel(level);
+
+    const qreal scaleX = static_cast<qreal>(_levels[0].width()) / levelImage.width();
+    const qreal scaleY = static_cast<qreal>(_levels[0].height()) / levelImage.height();
+
+    // Only whole texels touched by the exposed rect are drawn, at high zoom it is a tiny part of a tile
+    const QRect visibleTexels = QRectF(exposedRect.left() / scaleX, exposedRect.top() / scaleY,
+                                       exposedRect.width() / scaleX, exposedRect.height() / scaleY).toAlignedRect().intersected(levelImage.rect());
+    if (visibleTexels.isEmpty()) return;
+
+    painter.save();
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, levelOfDetail < MagnifiedMinScale);
+
+    const int x0 = visibleTexels.left() / TileSize;
+    const int y0 = visibleTexels.top() / TileSize;
+    const int x1 = visibleTexels.right() / TileSize;
+    const int y1 = visibleTexels.bottom() / TileSize;
+
+    for (int y = y0; y <= y1; ++y)
+    {
+        for (int x = x0; x <= x1; ++x)
+        {
+            const QPixmap tile = getTile(level, x, y);
+            const QRect tileRect(x * TileSize, y * TileSize, tile.width(), tile.height());
+            const QRect part = tileRect.intersected(visibleTexels);
+            const QRectF target(part.x() * scaleX, part.y() * scaleY, part.width() * scaleX, part.height() * scaleY);
+            painter.drawPixmap(target, tile, QRectF(part.translated(-tileRect.topLeft())));
+        }
+    }
+
+    painter.restore();
+}
@@ -0,0 +1,55 @@
+#ifndef TILEDIMAGE_H
+#define TILEDIMAGE_H
+
+#include "qimage.h"
+#include "qpixmap.h"
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+// Level-of-detail tile pyramid for drawing huge images (e.g. 8192x8192 imageset atlases).
+// Each mip level is half the size of the previous one and is built on demand. Tiles are cut from
+// levels lazily and kept in a LRU cache of a limited size, so that drawing cost depends only on
+// the visible area and the zoom level, not on the size of the whole image.
+// When magnified, texels are sampled with the nearest neighbour filter, so that pixel boundaries stay exact.
+
+class QPainter;
+
+class TiledImage
+{
+public:
+
+    static constexpr int TileSize = 256;
+    static constexpr qreal MagnifiedMinScale = 2.0;
+
+    TiledImage(size_t cacheBudget = 64 * 1024 * 1024);
+
+    bool load(const QString& filePath);
+    void setImage(QImage image);
+    void clear();
+
+    bool isNull() const { return _levels.empty(); }
+    QSize size() const { return _levels.empty() ? QSize() : _levels[0].size(); }
+    const QImage& getImage() const;
+    int getLevelCount() const { return _levelCount; }
+    int selectLevel(qreal levelOfDetail) const;
+
+    void draw(QPainter& painter, const QRectF& exposedRect, qreal levelOfDetail);
+
+protected:
+
+    typedef std::pair<quint64, QPixmap> CachedTile;
+
+    const QImage& getLevel(int level);
+    QPixmap getTile(int level, int x, int y);
+
+    std::vector<QImage> _levels; // 0 is the source image, levels not used yet are null
+    int _levelCount = 0;
+
+    std::list<CachedTile> _tiles; // Most recently used first
+    std::unordered_map<quint64, std::list<CachedTile>::iterator> _tileIndex;
+    size_t _cacheBudget = 0;
+    size_t _cacheSize = 0;
+};
+
+#endif // TILEDIMAGE_H
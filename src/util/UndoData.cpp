@@ -0,0 +1,216 @@
+#include "src/util/UndoData.h"
+#include <qtemporaryfile.h>
+#include <qdir.h>
+#include <zlib.h>
+#include <vector>
+
+struct UndoDataEntry
+{
+    UndoDataStore* store = nullptr;
+    QByteArray bytes;           // Resident data, compressed if 'compressed' is set
+    qint64 fileOffset = -1;     // Position in the spill file, -1 when resident
+    int storedSize = 0;         // Size of the data as stored (compressed or not)
+    int rawSize = 0;
+    bool compressed = false;
+    std::list<UndoDataEntry*>::iterator it;
+
+    ~UndoDataEntry() { if (store) store->removeEntry(*this); }
+};
+
+static bool compressData(const QByteArray& src, QByteArray& dst)
+{
+    uLongf dstSize = compressBound(static_cast<uLong>(src.size()));
+    dst.resize(static_cast<int>(dstSize));
+    if (compress2(reinterpret_cast<Bytef*>(dst.data()), &dstSize,
+                  reinterpret_cast<const Bytef*>(src.constData()), static_cast<uLong>(src.size()), Z_BEST_SPEED) != Z_OK)
+        return false;
+
+    dst.resize(static_cast<int>(dstSize));
+    return true;
+}
+
+static bool decompressData(const QByteArray& src, int rawSize, QByteArray& dst)
+{
+    uLongf dstSize = static_cast<uLongf>(rawSize);
+    dst.resize(rawSize);
+    return uncompress(reinterpret_cast<Bytef*>(dst.data()), &dstSize,
+                      reinterpret_cast<const Bytef*>(src.constData()), static_cast<uLong>(src.size())) == Z_OK &&
+            dstSize == static_cast<uLongf>(rawSize);
+}
+
+UndoData::UndoData(UndoDataStore* store, QByteArray&& data)
+    : _entry(std::make_shared<UndoDataEntry>())
+{
+    _entry->rawSize = data.size();
+
+    QByteArray compressed;
+    if (data.size() >= UndoDataStore::CompressionThreshold && compressData(data, compressed) && compressed.size() < data.size())
+    {
+        _entry->bytes = std::move(compressed);
+        _entry->compressed = true;
+    }
+    else
+    {
+        _entry->bytes = std::move(data);
+    }
+
+    _entry->storedSize = _entry->bytes.size();
+
+    if (store) store->addEntry(*_entry);
+}
+
+QByteArray UndoData::get() const
+{
+    if (!_entry) return QByteArray();
+
+    QByteArray stored;
+    if (_entry->fileOffset < 0)
+        stored = _entry->bytes;
+    else if (_entry->store)
+        stored = _entry->store->loadEntry(*_entry);
+    else
+        return QByteArray();
+
+    if (!_entry->compressed) return stored;
+
+    QByteArray data;
+    if (!decompressData(stored, _entry->rawSize, data))
+    {
+        assert(false && "UndoData::get() > corrupted data");
+        return QByteArray();
+    }
+
+    return data;
+}
+
+size_t UndoData::getMemoryFootprint() const
+{
+    return _entry ? static_cast<size_t>(_entry->bytes.size()) : 0;
+}
+
+//---------------------------------------------------------------------
+
+UndoDataStore::UndoDataStore(size_t memoryBudget)
+    : _memoryBudget(memoryBudget)
+{
+}
+
+// Normally undo commands are destroyed before the store, but don't let their data dangle anyway
+UndoDataStore::~UndoDataStore()
+{
+    for (UndoDataEntry* entry : _resident)
+        entry->store = nullptr;
+    for (UndoDataEntry* entry : _spilled)
+        entry->store = nullptr;
+}
+
+void UndoDataStore::setMemoryBudget(size_t memoryBudget)
+{
+    _memoryBudget = memoryBudget;
+    enforceBudget();
+}
+
+void UndoDataStore::addEntry(UndoDataEntry& entry)
+{
+    entry.store = this;
+    entry.it = _resident.insert(_resident.end(), &entry);
+    _residentBytes += static_cast<size_t>(entry.storedSize);
+    enforceBudget();
+}
+
+void UndoDataStore::removeEntry(UndoDataEntry& entry)
+{
+    if (entry.fileOffset < 0)
+    {
+        _resident.erase(entry.it);
+        _residentBytes -= static_cast<size_t>(entry.storedSize);
+        return;
+    }
+
+    _spilled.erase(entry.it);
+    _spilledBytes -= static_cast<size_t>(entry.storedSize);
+
+    if (!_spillFile) return;
+
+    // Rewrite live data when the dead space outweighs it, so that repeated compaction stays cheap
+    const qint64 deadBytes = _spillFile->size() - static_cast<qint64>(_spilledBytes);
+    if (_spilled.empty())
+        _spillFile->resize(0);
+    else if (deadBytes >= CompactionThreshold && deadBytes > static_cast<qint64>(_spilledBytes))
+        compactSpillFile();
+}
+
+// Moves the entry data to the disk. Data is kept in memory if writing fails, so nothing is lost.
+bool UndoDataStore::spillEntry(UndoDataEntry& entry)
+{
+    if (!_spillFile)
+    {
+        _spillFile.reset(new QTemporaryFile(QDir::tempPath() + "/ceed_undo_XXXXXX.tmp"));
+        if (!_spillFile->open())
+        {
+            _spillFile.reset();
+            return false;
+        }
+    }
+
+    const qint64 offset = _spillFile->size();
+    if (!_spillFile->seek(offset) || _spillFile->write(entry.bytes) != entry.storedSize)
+    {
+        // Drop a partially written tail
+        _spillFile->resize(offset);
+        return false;
+    }
+
+    _spilled.splice(_spilled.end(), _resident, entry.it);
+    _residentBytes -= static_cast<size_t>(entry.storedSize);
+    _spilledBytes += static_cast<size_t>(entry.storedSize);
+
+    entry.fileOffset = offset;
+    entry.bytes = QByteArray();
+
+    return true;
+}
+
+// Copies live data to a new spill file. The old file stays in use if anything fails.
+bool UndoDataStore::compactSpillFile()
+{
+    std::unique_ptr<QTemporaryFile> newFile(new QTemporaryFile(QDir::tempPath() + "/ceed_undo_XXXXXX.tmp"));
+    if (!newFile->open()) return false;
+
+    std::vector<qint64> offsets;
+    offsets.reserve(_spilled.size());
+    for (const UndoDataEntry* entry : _spilled)
+    {
+        if (!_spillFile->seek(entry->fileOffset)) return false;
+
+        const QByteArray bytes = _spillFile->read(entry->storedSize);
+        offsets.push_back(newFile->pos());
+        if (bytes.size() != entry->storedSize || newFile->write(bytes) != entry->storedSize) return false;
+    }
+
+    auto offsetIt = offsets.cbegin();
+    for (UndoDataEntry* entry : _spilled)
+        entry->fileOffset = *offsetIt++;
+
+    _spillFile = std::move(newFile);
+    return true;
+}
+
+QByteArray UndoDataStore::loadEntry(const UndoDataEntry& entry)
+{
+    if (!_spillFile || !_spillFile->seek(entry.fileOffset))
+    {
+        assert(false && "UndoDataStore::loadEntry() > spill file is not accessible");
+        return QByteArray();
+    }
+
+    return _spillFile->read(entry.storedSize);
+}
+
+void UndoDataStore::enforceBudget()
+{
+    // The newest entry always stays in memory, it is the most likely to be used soon
+    while (_residentBytes > _memoryBudget && _resident.size() > 1)
+        if (!spillEntry(*_resident.front()))
+            break;
+}
@@ -0,0 +1,79 @@
+#ifndef UNDODATA_H
+#define UNDODATA_H
+
+#include "qbytearray.h"
+#include <memory>
+#include <list>
+
+// Memory-bounded storage for big pieces of data held by undo commands (serialized widget hierarchies etc).
+// Data is compressed when it is big enough to benefit from it. When the total resident size exceeds
+// the budget, the oldest data is spilled to a temporary file. Spilled data is still readable, so
+// undo of old commands keeps working, it just costs a disk read. When commands are dropped from
+// the history, the spill file is truncated or compacted.
+
+class QTemporaryFile;
+class UndoDataStore;
+struct UndoDataEntry;
+
+// Implemented by undo commands to report the memory they occupy
+class IUndoMemoryFootprint
+{
+public:
+
+    virtual ~IUndoMemoryFootprint() = default;
+    virtual size_t getMemoryFootprint() const = 0;
+};
+
+// A handle to the data registered in the store. Store is optional, without it data is only compressed.
+class UndoData
+{
+public:
+
+    UndoData() = default;
+    UndoData(UndoDataStore* store, QByteArray&& data);
+
+    QByteArray get() const;
+    bool isEmpty() const { return !_entry; }
+    size_t getMemoryFootprint() const;
+
+protected:
+
+    std::shared_ptr<UndoDataEntry> _entry;
+};
+
+class UndoDataStore
+{
+public:
+
+    static constexpr int CompressionThreshold = 4096;
+    static constexpr qint64 CompactionThreshold = 1024 * 1024; // Dead space in the spill file worth rewriting it
+
+    UndoDataStore(size_t memoryBudget);
+    ~UndoDataStore();
+
+    void setMemoryBudget(size_t memoryBudget);
+    size_t getMemoryBudget() const { return _memoryBudget; }
+    size_t getMemoryFootprint() const { return _residentBytes; }
+    size_t getSpilledSize() const { return _spilledBytes; }
+
+protected:
+
+    friend class UndoData;
+    friend struct UndoDataEntry;
+
+    void addEntry(UndoDataEntry& entry);
+    void removeEntry(UndoDataEntry& entry);
+    bool spillEntry(UndoDataEntry& entry);
+    bool compactSpillFile();
+    QByteArray loadEntry(const UndoDataEntry& entry);
+    void enforceBudget();
+
+    std::list<UndoDataEntry*> _resident; // Oldest first
+    std::list<UndoDataEntry*> _spilled;
+    std::unique_ptr<QTemporaryFile> _spillFile;
+    size_t _memoryBudget = 0;
+    size_t _residentBytes = 0;
+    size_t _spilledBytes = 0;
+};
+
+#endif // UNDODATA_H